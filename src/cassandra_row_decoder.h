@@ -0,0 +1,133 @@
+/**
+ * @file cassandra_row_decoder.h
+ * @brief Definition of the typed Cassandra column decoders
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CASSANDRA_ROW_DECODER_H
+#define CASSANDRA_ROW_DECODER_H
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+namespace meteodata {
+
+/**
+ * @brief Decoders from Cassandra values to C++ values, selected at compile
+ * time by the type of the destination
+ *
+ * Strings are decoded as string views into the Cassandra result, they are
+ * only valid as long as the row they come from.
+ */
+namespace cassandra_row {
+
+inline void decode(const CassValue* raw, CassUuid& value)
+{
+	cass_value_get_uuid(raw, &value);
+}
+
+inline void decode(const CassValue* raw, bool& value)
+{
+	cass_bool_t b;
+	cass_value_get_bool(raw, &b);
+	value = b == cass_true;
+}
+
+inline void decode(const CassValue* raw, int& value)
+{
+	cass_value_get_int32(raw, &value);
+}
+
+inline void decode(const CassValue* raw, float& value)
+{
+	cass_value_get_float(raw, &value);
+}
+
+inline void decode(const CassValue* raw, std::string_view& value)
+{
+	const char* str;
+	std::size_t size;
+	cass_value_get_string(raw, &str, &size);
+	value = std::string_view{str, size};
+}
+
+/**
+ * @brief Decode a Cassandra timestamp (a number of milliseconds since the
+ * epoch)
+ */
+inline void decode(const CassValue* raw, date::sys_seconds& value)
+{
+	cass_int64_t millis;
+	cass_value_get_int64(raw, &millis);
+	value = date::floor<std::chrono::seconds>(date::sys_time<std::chrono::milliseconds>{std::chrono::milliseconds{millis}});
+}
+
+/**
+ * @brief Decode a Cassandra date (a number of days centered on 2^31)
+ */
+inline void decode(const CassValue* raw, date::sys_days& value)
+{
+	cass_uint32_t cassDate;
+	cass_value_get_uint32(raw, &cassDate);
+	value = date::floor<date::days>(std::chrono::system_clock::from_time_t(time_t(cass_date_time_to_epoch(cassDate, 0))));
+}
+
+/**
+ * @brief Decode a nullable value, the first element of \a value is false if,
+ * and only if, the Cassandra value is null
+ */
+template<typename T>
+inline void decode(const CassValue* raw, std::pair<bool, T>& value)
+{
+	value.first = !cass_value_is_null(raw);
+	if (value.first)
+		decode(raw, value.second);
+}
+
+template<typename Tuple, std::size_t... I>
+inline void decodeRow(const CassRow* row, Tuple& values, std::index_sequence<I...>)
+{
+	(decode(cass_row_get_column(row, I), std::get<I>(values)), ...);
+}
+
+/**
+ * @brief Decode the first columns of a Cassandra row into a tuple of nullable
+ * values, column i going to the i-th element of \a values
+ *
+ * @param[in] row A Cassandra row, resulting from a SELECT query
+ * @param[out] values The decoded values
+ */
+template<typename... Columns>
+inline void decodeRow(const CassRow* row, std::tuple<std::pair<bool, Columns>...>& values)
+{
+	decodeRow(row, values, std::index_sequence_for<Columns...>{});
+}
+
+}
+
+}
+
+#endif
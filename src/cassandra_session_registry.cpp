@@ -0,0 +1,94 @@
+/**
+ * @file cassandra_session_registry.cpp
+ * @brief Implementation of the CassandraSessionRegistry class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <exception>
+#include <stdexcept>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <cassandra.h>
+
+#include "cassandra_session_registry.h"
+
+namespace meteodata {
+
+CassandraSessionRegistry& CassandraSessionRegistry::instance()
+{
+	static CassandraSessionRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<CassandraSessionRegistry::Session> CassandraSessionRegistry::get(const std::string& address, const std::string& user, const std::string& password,
+	const ConnectionOptions& options)
+{
+	CassandraSessionRegistry& registry = instance();
+	// The lock is held while connecting so that concurrent callers wait
+	// for the same session instead of opening their own
+	std::lock_guard locked{registry._mutex};
+
+	std::weak_ptr<Session>& entry = registry._sessions[{
+		address, user, password,
+		options.ioThreads, options.coreConnectionsPerHost,
+		options.tokenAwareRouting, options.latencyAwareRouting,
+		options.requestTimeout, options.connectTimeout,
+		options.speculativeExecutionDelay, options.maxSpeculativeExecutions
+	}];
+	std::shared_ptr<Session> session = entry.lock();
+	if (session)
+		return session;
+
+	session = std::make_shared<Session>();
+	cass_cluster_set_contact_points(session->cluster.get(), address.c_str());
+	if (!user.empty() && !password.empty())
+		cass_cluster_set_credentials_n(session->cluster.get(), user.c_str(), user.length(), password.c_str(), password.length());
+	cass_cluster_set_prepare_on_all_hosts(session->cluster.get(), cass_true);
+	if (options.ioThreads > 0)
+		cass_cluster_set_num_threads_io(session->cluster.get(), options.ioThreads);
+	if (options.coreConnectionsPerHost > 0)
+		cass_cluster_set_core_connections_per_host(session->cluster.get(), options.coreConnectionsPerHost);
+	cass_cluster_set_token_aware_routing(session->cluster.get(), options.tokenAwareRouting ? cass_true : cass_false);
+	cass_cluster_set_latency_aware_routing(session->cluster.get(), options.latencyAwareRouting ? cass_true : cass_false);
+	if (options.requestTimeout.count() > 0)
+		cass_cluster_set_request_timeout(session->cluster.get(), options.requestTimeout.count());
+	if (options.connectTimeout.count() > 0)
+		cass_cluster_set_connect_timeout(session->cluster.get(), options.connectTimeout.count());
+	// Only the statements marked as idempotent are executed
+	// speculatively
+	if (options.maxSpeculativeExecutions > 0)
+		cass_cluster_set_constant_speculative_execution_policy(session->cluster.get(),
+			options.speculativeExecutionDelay.count(), options.maxSpeculativeExecutions);
+	CassFuture* futureConn = cass_session_connect(session->session.get(), session->cluster.get());
+	CassError rc = cass_future_error_code(futureConn);
+	cass_future_free(futureConn);
+	if (rc != CASS_OK) {
+		std::string desc("Impossible to connect to database: ");
+		desc.append(cass_error_desc(rc));
+		throw std::runtime_error(desc);
+	}
+
+	entry = session;
+	return session;
+}
+
+}
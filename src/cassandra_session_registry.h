@@ -0,0 +1,95 @@
+/**
+ * @file cassandra_session_registry.h
+ * @brief Definition of the CassandraSessionRegistry class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CASSANDRA_SESSION_REGISTRY_H
+#define CASSANDRA_SESSION_REGISTRY_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <cassandra.h>
+
+#include "connection_options.h"
+
+namespace meteodata {
+
+/**
+ * @brief The process-wide registry of the Cassandra sessions
+ *
+ * A Cassandra session maintains its own pool of connections to each node of
+ * the cluster and is safe to use from several threads. All the database
+ * connection objects connecting to the same cluster with the same credentials
+ * share one session, which is closed when the last of them is destroyed.
+ */
+class CassandraSessionRegistry
+{
+public:
+	/**
+	 * @brief A connected session and its cluster configuration
+	 */
+	struct Session
+	{
+		std::unique_ptr<CassCluster, void(&)(CassCluster*)> cluster{cass_cluster_new(), cass_cluster_free};
+		// declared after the cluster so as to be closed before it's
+		// freed
+		std::unique_ptr<CassSession, void(&)(CassSession*)> session{cass_session_new(), cass_session_free};
+	};
+
+	/**
+	 * @brief Get the session connected to a cluster, connecting a new
+	 * one if there is none
+	 *
+	 * Sessions are only shared between connections with the same
+	 * Cassandra options.
+	 *
+	 * @param address The contact points of the cluster
+	 * @param user The username, may be empty
+	 * @param password The password, may be empty
+	 * @param options The settings of the cluster
+	 *
+	 * @return The session, kept open as long as a copy of the pointer
+	 * exists
+	 *
+	 * @throw std::runtime_error If the connection fails
+	 */
+	static std::shared_ptr<Session> get(const std::string& address, const std::string& user, const std::string& password,
+		const ConnectionOptions& options = ConnectionOptions{});
+
+private:
+	using Key = std::tuple<std::string, std::string, std::string,
+		unsigned int, unsigned int, bool, bool,
+		std::chrono::milliseconds, std::chrono::milliseconds, std::chrono::milliseconds, int>;
+
+	std::mutex _mutex;
+	std::map<Key, std::weak_ptr<Session>> _sessions;
+
+	static CassandraSessionRegistry& instance();
+};
+
+}
+
+#endif
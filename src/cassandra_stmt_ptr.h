@@ -24,11 +24,18 @@
 #ifndef CASSANDRA_STMT_PTR_H
 #define CASSANDRA_STMT_PTR_H
 
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
 
 #include <cassandra.h>
 
+#include "statement_metrics.h"
+
 namespace meteodata {
 
 class CassandraStmtPtrDeleter
@@ -39,7 +46,146 @@ public:
 	}
 };
 
-using CassandraStmtPtr = std::unique_ptr<const CassPrepared, CassandraStmtPtrDeleter>;
+/**
+ * @brief An owning pointer to a Cassandra prepared statement
+ *
+ * The statement is either set with reset() once prepared, or deferred with
+ * defer(), in which case it's prepared by the first call to get(). Concurrent
+ * calls to get() are safe, the statement is prepared only once. If the
+ * preparation fails, it's attempted again on the next call.
+ *
+ * The pointer also carries the latency series the executions of the statement
+ * are recorded in.
+ */
+class CassandraStmtPtr
+{
+public:
+	CassandraStmtPtr() = default;
+
+	CassandraStmtPtr(CassandraStmtPtr&& other) noexcept :
+		_stmt{other._stmt.exchange(nullptr)},
+		_deferred{std::move(other._deferred)},
+		_metrics{other._metrics}
+	{}
+
+	CassandraStmtPtr& operator=(CassandraStmtPtr&& other) noexcept
+	{
+		reset(other._stmt.exchange(nullptr));
+		_deferred = std::move(other._deferred);
+		_metrics = other._metrics;
+		return *this;
+	}
+
+	~CassandraStmtPtr()
+	{
+		reset();
+	}
+
+	/**
+	 * @brief Get the prepared statement, preparing it first if it has
+	 * been deferred
+	 *
+	 * @return The prepared statement, or nullptr if it has been neither
+	 * set nor deferred, or if it could not be prepared
+	 */
+	const CassPrepared* get() const
+	{
+		const CassPrepared* stmt = _stmt.load(std::memory_order_acquire);
+		if (stmt || !_deferred)
+			return stmt;
+		return prepare();
+	}
+
+	/**
+	 * @brief Bind a new statement from the prepared statement, preparing
+	 * it first if it has been deferred
+	 *
+	 * @return The statement, to be freed by the caller, or nullptr if
+	 * the prepared statement is not available
+	 */
+	CassStatement* bind() const
+	{
+		const CassPrepared* stmt = get();
+		return stmt ? cass_prepared_bind(stmt) : nullptr;
+	}
+
+	/**
+	 * @brief Replace the prepared statement, freeing the previous one
+	 */
+	void reset(const CassPrepared* stmt = nullptr)
+	{
+		const CassPrepared* previous = _stmt.exchange(stmt, std::memory_order_acq_rel);
+		if (previous)
+			CassandraStmtPtrDeleter{}(previous);
+	}
+
+	/**
+	 * @brief Record a query to be prepared on the first call to get()
+	 *
+	 * @param session The Cassandra session, it must outlive this object
+	 * @param query The query of the prepared statement
+	 */
+	void defer(CassSession* session, std::string query)
+	{
+		reset();
+		_deferred = std::make_unique<Deferred>();
+		_deferred->session = session;
+		_deferred->query = std::move(query);
+	}
+
+	/**
+	 * @brief Set the series the executions of the statement are recorded
+	 * in
+	 */
+	void setMetrics(StatementMetrics::Series& metrics)
+	{
+		_metrics = &metrics;
+	}
+
+	/**
+	 * @brief Get the series the executions of the statement are recorded
+	 * in, a catch-all series if none has been set
+	 */
+	StatementMetrics::Series& metrics() const
+	{
+		if (!_metrics)
+			_metrics = &StatementMetrics::series(StatementMetrics::Backend::CASSANDRA, "unnamed");
+		return *_metrics;
+	}
+
+private:
+	struct Deferred
+	{
+		CassSession* session;
+		std::string query;
+		std::mutex mutex;
+	};
+
+	mutable std::atomic<const CassPrepared*> _stmt{nullptr};
+	std::unique_ptr<Deferred> _deferred;
+	mutable StatementMetrics::Series* _metrics = nullptr;
+
+	const CassPrepared* prepare() const
+	{
+		std::lock_guard locked{_deferred->mutex};
+		const CassPrepared* stmt = _stmt.load(std::memory_order_acquire);
+		if (stmt)
+			return stmt;
+
+		std::unique_ptr<CassFuture, void(&)(CassFuture*)> prepareFuture{
+			cass_session_prepare(_deferred->session, _deferred->query.c_str()),
+			cass_future_free
+		};
+		CassError rc = cass_future_error_code(prepareFuture.get());
+		if (rc != CASS_OK) {
+			std::cerr << "Could not prepare statement \"" << _deferred->query << "\": " << cass_error_desc(rc) << std::endl;
+			return nullptr;
+		}
+		stmt = cass_future_get_prepared(prepareFuture.get());
+		_stmt.store(stmt, std::memory_order_release);
+		return stmt;
+	}
+};
 }
 
 #endif
@@ -0,0 +1,110 @@
+/**
+ * @file connection_options.h
+ * @brief Definition of the ConnectionOptions structure
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONNECTION_OPTIONS_H
+#define CONNECTION_OPTIONS_H
+
+#include <chrono>
+#include <cstddef>
+
+namespace meteodata {
+
+/**
+ * @brief When the Cassandra statements are prepared
+ */
+enum class StatementPreparation {
+	/**
+	 * @brief All the statements are prepared when the connection is
+	 * constructed
+	 */
+	EAGER,
+	/**
+	 * @brief Each statement is prepared the first time it's used, for
+	 * the programs using only a few of them
+	 *
+	 * A statement that cannot be prepared makes the methods using it
+	 * fail, its preparation is attempted again on the next use.
+	 */
+	LAZY
+};
+
+/**
+ * @brief The tuning knobs of the database connections
+ *
+ * The defaults leave the Cassandra driver's own defaults in place: the
+ * zero values mean "not set".
+ */
+struct ConnectionOptions
+{
+	/**
+	 * @brief The number of threads handling the I/O of the Cassandra
+	 * session
+	 */
+	unsigned int ioThreads = 0;
+	/**
+	 * @brief The number of connections opened to each Cassandra node per
+	 * I/O thread
+	 */
+	unsigned int coreConnectionsPerHost = 0;
+	/**
+	 * @brief Whether the queries are sent to a replica of the partition
+	 * they target
+	 */
+	bool tokenAwareRouting = true;
+	/**
+	 * @brief Whether the nodes answering much slower than the others
+	 * are avoided
+	 */
+	bool latencyAwareRouting = false;
+	/**
+	 * @brief How long to wait for the response to a query
+	 */
+	std::chrono::milliseconds requestTimeout{0};
+	/**
+	 * @brief How long to wait for a connection to a node to be established
+	 */
+	std::chrono::milliseconds connectTimeout{0};
+	/**
+	 * @brief How long to wait for the response to an idempotent query
+	 * before sending it again to another node
+	 */
+	std::chrono::milliseconds speculativeExecutionDelay{0};
+	/**
+	 * @brief The maximum number of additional executions of an idempotent
+	 * query, zero to disable the speculative execution
+	 */
+	int maxSpeculativeExecutions = 0;
+	/**
+	 * @brief When to prepare the Cassandra statements
+	 */
+	StatementPreparation preparation = StatementPreparation::EAGER;
+	/**
+	 * @brief The maximum number of connections to the PostgreSQL database,
+	 * opened as threads need them
+	 */
+	std::size_t pgPoolSize = 1;
+};
+
+}
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * @file daily_aggregator.cpp
+ * @brief Implementation of the DailyAggregator class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "daily_aggregator.h"
+#include "minmax_storage.h"
+#include "observation.h"
+#include "wind_histogram.h"
+
+namespace meteodata {
+
+namespace chrono = std::chrono;
+
+constexpr date::days DailyAggregator::DAYS_KEPT;
+
+void DailyAggregator::Window6hTo6h::add(const Observation& obs)
+{
+	insideTemp.add(obs.insidetemp);
+	for (int i = 0 ; i < 2 ; i++)
+		leafTemp[i].add(obs.leaftemp[i]);
+	outsideTemp.add(obs.outsidetemp);
+	maxOutsideTemperature.add(obs.max_outside_temperature);
+	for (int i = 0 ; i < 4 ; i++)
+		soilTemp[i].add(obs.soiltemp[i]);
+	for (int i = 0 ; i < 3 ; i++)
+		extraTemp[i].add(obs.extratemp[i]);
+	rainfall.add(obs.rainfall);
+	rainrate.add(obs.rainrate);
+}
+
+void DailyAggregator::Window6hTo6h::get(Values& values) const
+{
+	values.insideTemp_max = insideTemp.max;
+	for (int i = 0 ; i < 2 ; i++)
+		values.leafTemp_max[i] = leafTemp[i].max;
+	// Like in DbConnectionMinmax, the real maximum is preferred to the
+	// maximum of the instantaneous temperatures
+	values.outsideTemp_max = maxOutsideTemperature.max.first ? maxOutsideTemperature.max : outsideTemp.max;
+	for (int i = 0 ; i < 4 ; i++)
+		values.soilTemp_max[i] = soilTemp[i].max;
+	for (int i = 0 ; i < 3 ; i++)
+		values.extraTemp_max[i] = extraTemp[i].max;
+	values.rainfall = rainfall.total();
+	values.rainrate_max = rainrate.max;
+}
+
+void DailyAggregator::Window18hTo18h::add(const Observation& obs)
+{
+	insideTemp.add(obs.insidetemp);
+	for (int i = 0 ; i < 2 ; i++)
+		leafTemp[i].add(obs.leaftemp[i]);
+	outsideTemp.add(obs.outsidetemp);
+	minOutsideTemperature.add(obs.min_outside_temperature);
+	for (int i = 0 ; i < 4 ; i++)
+		soilTemp[i].add(obs.soiltemp[i]);
+	for (int i = 0 ; i < 3 ; i++)
+		extraTemp[i].add(obs.extratemp[i]);
+}
+
+void DailyAggregator::Window18hTo18h::get(Values& values) const
+{
+	values.insideTemp_min = insideTemp.min;
+	for (int i = 0 ; i < 2 ; i++)
+		values.leafTemp_min[i] = leafTemp[i].min;
+	values.outsideTemp_min = minOutsideTemperature.min.first ? minOutsideTemperature.min : outsideTemp.min;
+	for (int i = 0 ; i < 4 ; i++)
+		values.soilTemp_min[i] = soilTemp[i].min;
+	for (int i = 0 ; i < 3 ; i++)
+		values.extraTemp_min[i] = extraTemp[i].min;
+}
+
+void DailyAggregator::Window0hTo0h::add(const Observation& obs)
+{
+	barometer.add(obs.barometer);
+	for (int i = 0 ; i < 2 ; i++)
+		leafWetnesses[i].add(obs.leafwetnesses[i]);
+	for (int i = 0 ; i < 4 ; i++)
+		soilMoistures[i].add(obs.soilmoistures[i]);
+	insideHum.add(obs.insidehum);
+	outsideHum.add(obs.outsidehum);
+	for (int i = 0 ; i < 2 ; i++)
+		extraHum[i].add(obs.extrahum[i]);
+	solarRad.add(obs.solarrad);
+	uv.add(obs.uv);
+	windgust.add(obs.windgust);
+	windspeed.add(obs.windspeed);
+	dewpoint.add(obs.dewpoint);
+	et.add(obs.et);
+	insolationTime.add(obs.insolation_time);
+	if (obs.winddir.first && obs.windspeed.first)
+		winddir.add(obs.winddir.second, obs.windspeed.second);
+}
+
+void DailyAggregator::Window0hTo0h::get(Values& values) const
+{
+	values.barometer_min = barometer.min;
+	values.barometer_max = barometer.max;
+	values.barometer_avg = barometer.avg();
+	for (int i = 0 ; i < 2 ; i++) {
+		values.leafWetnesses_min[i] = leafWetnesses[i].min;
+		values.leafWetnesses_max[i] = leafWetnesses[i].max;
+		values.leafWetnesses_avg[i] = leafWetnesses[i].avg();
+	}
+	for (int i = 0 ; i < 4 ; i++) {
+		values.soilMoistures_min[i] = soilMoistures[i].min;
+		values.soilMoistures_max[i] = soilMoistures[i].max;
+		values.soilMoistures_avg[i] = soilMoistures[i].avg();
+	}
+	values.insideHum_min = insideHum.min;
+	values.insideHum_max = insideHum.max;
+	values.insideHum_avg = insideHum.avg();
+	values.outsideHum_min = outsideHum.min;
+	values.outsideHum_max = outsideHum.max;
+	values.outsideHum_avg = outsideHum.avg();
+	for (int i = 0 ; i < 2 ; i++) {
+		values.extraHum_min[i] = extraHum[i].min;
+		values.extraHum_max[i] = extraHum[i].max;
+		values.extraHum_avg[i] = extraHum[i].avg();
+	}
+	values.solarRad_max = solarRad.max;
+	values.solarRad_avg = solarRad.avg();
+	values.uv_max = uv.max;
+	values.uv_avg = uv.avg();
+	values.windgust_max = windgust.max;
+	values.windgust_avg = windgust.avg();
+	values.windspeed_max = windspeed.max;
+	values.windspeed_avg = windspeed.avg();
+	values.dewpoint_min = dewpoint.min;
+	values.dewpoint_max = dewpoint.max;
+	values.dewpoint_avg = dewpoint.avg();
+	values.et = et.total();
+	values.insolation_time = insolationTime.total();
+	auto sectors = winddir.sectors();
+	values.winddir = { !winddir.empty(), std::vector<int>(sectors.begin(), sectors.end()) };
+	values.windHistogram = { !winddir.empty(), winddir };
+}
+
+DailyAggregator::StationKey DailyAggregator::keyOf(const CassUuid& station)
+{
+	return { station.time_and_version, station.clock_seq_and_node };
+}
+
+bool DailyAggregator::accumulate(const Observation& obs)
+{
+	std::lock_guard locked{_mutex};
+
+	auto it = _stations.find(keyOf(obs.station));
+	if (it == _stations.end()) {
+		it = _stations.emplace(keyOf(obs.station), Station{}).first;
+		it->second.since = obs.time;
+		it->second.latest = obs.time;
+	} else if (obs.time < it->second.since ||
+		   date::floor<date::days>(obs.time - chrono::hours{6}) < date::floor<date::days>(it->second.latest) - DAYS_KEPT) {
+		// The windows of the observation are either incomplete
+		// anyway or already discarded
+		return false;
+	} else if (it->second.times.count(obs.time)) {
+		// The observation replaces one already counted, which
+		// cannot be taken out of the aggregates
+		_stations.erase(it);
+		return false;
+	}
+
+	Station& station = it->second;
+	station.latest = std::max(station.latest, obs.time);
+	station.times.insert(obs.time);
+	station.days[date::floor<date::days>(obs.time - chrono::hours{6})].from6h.add(obs);
+	station.days[date::floor<date::days>(obs.time + chrono::hours{6})].from18h.add(obs);
+	station.days[date::floor<date::days>(obs.time)].allDay.add(obs);
+
+	date::sys_days oldest = date::floor<date::days>(station.latest) - DAYS_KEPT;
+	station.days.erase(station.days.begin(), station.days.lower_bound(oldest));
+	station.times.erase(station.times.begin(), station.times.lower_bound(oldest + chrono::hours{6}));
+	return true;
+}
+
+bool DailyAggregator::getValues(const CassUuid& station, const date::sys_days& day, Values& values) const
+{
+	std::lock_guard locked{_mutex};
+
+	auto it = _stations.find(keyOf(station));
+	if (it == _stations.end() || it->second.since > day - chrono::hours{6})
+		return false;
+
+	auto d = it->second.days.find(day);
+	if (d == it->second.days.end()) {
+		// No observation in the windows of the day yet, unless the
+		// day has been discarded already
+		if (day < date::floor<date::days>(it->second.latest) - DAYS_KEPT)
+			return false;
+		Day empty;
+		empty.from6h.get(values);
+		empty.from18h.get(values);
+		empty.allDay.get(values);
+	} else {
+		d->second.from6h.get(values);
+		d->second.from18h.get(values);
+		d->second.allDay.get(values);
+	}
+	return true;
+}
+
+bool DailyAggregator::flush(const CassUuid& station, const date::sys_days& day, MinmaxStorage& storage) const
+{
+	std::vector<Values> values(1);
+	if (!getValues(station, day, values[0]))
+		return false;
+
+	Values previous;
+	bool known = storage.getCumulativeValues(station, day - date::days{1}, previous);
+	MinmaxStorage::chainCumulativeValues(day, known ? &previous : nullptr, values);
+	return storage.insertDataPoint(station, day, values[0]) &&
+		storage.insertDataPointInTimescaleDB(station, day, values[0]);
+}
+
+void DailyAggregator::invalidate(const CassUuid& station)
+{
+	std::lock_guard locked{_mutex};
+	_stations.erase(keyOf(station));
+}
+
+void DailyAggregator::clear()
+{
+	std::lock_guard locked{_mutex};
+	_stations.clear();
+}
+
+}
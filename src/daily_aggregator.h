@@ -0,0 +1,254 @@
+/**
+ * @file daily_aggregator.h
+ * @brief Definition of the DailyAggregator class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DAILY_AGGREGATOR_H
+#define DAILY_AGGREGATOR_H
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "observation.h"
+#include "minmax_storage.h"
+#include "wind_histogram.h"
+
+namespace meteodata {
+
+/**
+ * @brief An in-memory, per-station, running aggregate of the observations of
+ * the current days, used to get the minmax values of a day so far without
+ * reading its observations back from the database
+ *
+ * Each observation is added to the three windows it belongs to: the one from
+ * 0h to 0h of its day, the one from 6h to 6h starting on its day or the day
+ * before, and the one from 18h to 18h ending on its day or the day after.
+ * The windows compute the same values as the queries of DbConnectionMinmax,
+ * except for the ones derived from the cumulative columns not part of an
+ * Observation (rainfall24, insolation_time24, tx and tn).
+ *
+ * The aggregator only knows about the observations accumulated through it.
+ * They need not come in chronological order, the aggregates do not depend on
+ * it, but an observation accumulated twice cannot be told apart from two
+ * observations, so it makes the aggregator forget the station. The values of
+ * a day are only available if the station has been followed since the
+ * beginning of the earliest window of the day, at 18h the day before.
+ */
+class DailyAggregator
+{
+public:
+	using Values = MinmaxStorage::Values;
+
+	/**
+	 * @brief The aggregate functions of SQL over one column, null values
+	 * being ignored
+	 */
+	template<typename T>
+	struct Column
+	{
+		std::pair<bool, T> min = { false, T{} };
+		std::pair<bool, T> max = { false, T{} };
+		double sum = 0;
+		int count = 0;
+
+		template<typename U>
+		void add(const std::pair<bool, U>& value)
+		{
+			if (!value.first)
+				return;
+			T v = static_cast<T>(value.second);
+			if (!min.first || v < min.second)
+				min = { true, v };
+			if (!max.first || v > max.second)
+				max = { true, v };
+			sum += v;
+			count++;
+		}
+
+		std::pair<bool, T> avg() const
+		{
+			return { count > 0, count > 0 ? static_cast<T>(sum / count) : T{} };
+		}
+
+		std::pair<bool, T> total() const
+		{
+			return { count > 0, static_cast<T>(sum) };
+		}
+	};
+
+	/**
+	 * @brief The maxima of the temperatures and the rainfall, from 6h to
+	 * 6h the day after
+	 */
+	struct Window6hTo6h
+	{
+		Column<float> insideTemp;
+		Column<float> leafTemp[2];
+		Column<float> outsideTemp;
+		Column<float> maxOutsideTemperature;
+		Column<float> soilTemp[4];
+		Column<float> extraTemp[3];
+		Column<float> rainfall;
+		Column<float> rainrate;
+
+		void add(const Observation& obs);
+		void get(Values& values) const;
+	};
+
+	/**
+	 * @brief The minima of the temperatures, from 18h the day before to
+	 * 18h
+	 */
+	struct Window18hTo18h
+	{
+		Column<float> insideTemp;
+		Column<float> leafTemp[2];
+		Column<float> outsideTemp;
+		Column<float> minOutsideTemperature;
+		Column<float> soilTemp[4];
+		Column<float> extraTemp[3];
+
+		void add(const Observation& obs);
+		void get(Values& values) const;
+	};
+
+	/**
+	 * @brief The other values, over the civil day
+	 */
+	struct Window0hTo0h
+	{
+		Column<float> barometer;
+		Column<int> leafWetnesses[2];
+		Column<int> soilMoistures[4];
+		Column<int> insideHum;
+		Column<int> outsideHum;
+		Column<int> extraHum[2];
+		Column<int> solarRad;
+		Column<int> uv;
+		Column<float> windgust;
+		Column<float> windspeed;
+		Column<float> dewpoint;
+		Column<float> et;
+		Column<int> insolationTime;
+		WindHistogram winddir;
+
+		void add(const Observation& obs);
+		void get(Values& values) const;
+	};
+
+	/**
+	 * @brief Add a new observation to the windows it belongs to
+	 *
+	 * @param obs The new observation, already filtered
+	 *
+	 * @return True if the observation could be accumulated, false if it
+	 * is older than the beginning of the station's follow-up or than the
+	 * days kept, in which case it is ignored, or if an observation at the
+	 * same time has already been accumulated, in which case the station
+	 * is forgotten and followed again from the next observation
+	 */
+	bool accumulate(const Observation& obs);
+
+	/**
+	 * @brief Get the values of a day so far
+	 *
+	 * Only the daily values are computed, the monthly and yearly ones are
+	 * left untouched.
+	 *
+	 * @param station The station's UUID
+	 * @param day The day
+	 * @param[out] values The values of the windows of \a day
+	 *
+	 * @return True if the values are known, false if the station has not
+	 * been followed since the beginning of the windows of the day or if
+	 * the day is too old
+	 */
+	bool getValues(const CassUuid& station, const date::sys_days& day, Values& values) const;
+
+	/**
+	 * @brief Store the values of a day so far, with the monthly and yearly
+	 * sums chained from the ones stored for the day before
+	 *
+	 * @param station The station's UUID
+	 * @param day The day
+	 * @param storage Where to store the values, in both minmax tables
+	 *
+	 * @return True if the values are known and could be stored, false
+	 * otherwise
+	 */
+	bool flush(const CassUuid& station, const date::sys_days& day, MinmaxStorage& storage) const;
+
+	/**
+	 * @brief Forget about a station, it will be followed again from the
+	 * next observation
+	 *
+	 * @param station The station's UUID
+	 */
+	void invalidate(const CassUuid& station);
+
+	/**
+	 * @brief Forget about all stations
+	 */
+	void clear();
+
+private:
+	/**
+	 * @brief The number of days before the day of the last observation
+	 * kept for each station
+	 */
+	constexpr static date::days DAYS_KEPT{2};
+
+	struct Day
+	{
+		Window6hTo6h from6h;
+		Window18hTo18h from18h;
+		Window0hTo0h allDay;
+	};
+
+	struct Station
+	{
+		date::sys_seconds since;
+		date::sys_seconds latest;
+		std::map<date::sys_days, Day> days;
+		/**
+		 * @brief The times of the observations accumulated in the
+		 * days kept, to detect the ones accumulated twice
+		 */
+		std::set<date::sys_seconds> times;
+	};
+
+	using StationKey = std::pair<cass_uint64_t, cass_uint64_t>;
+
+	std::map<StationKey, Station> _stations;
+
+	mutable std::mutex _mutex;
+
+	static StationKey keyOf(const CassUuid& station);
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@
 #include <chrono>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include <vector>
 #include <cstring>
 
@@ -36,6 +37,9 @@
 #include <pqxx/strconv>
 
 #include "dbconnection_common.h"
+#include "cassandra_session_registry.h"
+#include "statement_metrics.h"
+#include "query_observer.h"
 
 using namespace date;
 
@@ -81,75 +85,114 @@ namespace meteodata {
 
 namespace chrono = std::chrono;
 
-DbConnectionCommon::DbConnectionCommon(const std::string& address, const std::string& user, const std::string& password) :
-	_session{cass_session_new(), cass_session_free},
-	_cluster{cass_cluster_new(), cass_cluster_free}
+DbConnectionCommon::DbConnectionCommon(const std::string& address, const std::string& user, const std::string& password,
+		const ConnectionOptions& options) :
+	_lazyPreparation{options.preparation == StatementPreparation::LAZY}
 {
-	cass_cluster_set_contact_points(_cluster.get(), address.c_str());
-	if (!user.empty() && !password.empty())
-		cass_cluster_set_credentials_n(_cluster.get(), user.c_str(), user.length(), password.c_str(), password.length());
-	cass_cluster_set_prepare_on_all_hosts(_cluster.get(), cass_true);
-	CassFuture* futureConn = cass_session_connect(_session.get(), _cluster.get());
-	CassError rc = cass_future_error_code(futureConn);
-	cass_future_free(futureConn);
-	if (rc != CASS_OK) {
-		std::string desc("Impossible to connect to database: ");
-		desc.append(cass_error_desc(rc));
-		throw std::runtime_error(desc);
-	} else {
-		DbConnectionCommon::prepareStatements();
+	// The deleters keep the shared session alive as long as this object
+	std::shared_ptr<CassandraSessionRegistry::Session> shared = CassandraSessionRegistry::get(address, user, password, options);
+	_session = {shared->session.get(), [shared](CassSession*) {}};
+	_cluster = {shared->cluster.get(), [shared](CassCluster*) {}};
+
+	DbConnectionCommon::prepareStatements();
+	waitForPreparedStatements();
+}
+
+void DbConnectionCommon::prepareOneStatement(CassandraStmtPtr& stmt, const std::string& name, const std::string& query)
+{
+	stmt.setMetrics(StatementMetrics::series(StatementMetrics::Backend::CASSANDRA, name));
+
+	if (_lazyPreparation) {
+		stmt.defer(_session.get(), query);
+		return;
+	}
+
+	_pendingPreparations.emplace_back(&stmt, std::unique_ptr<CassFuture, void(&)(CassFuture*)>{
+		cass_session_prepare(_session.get(), query.c_str()),
+		cass_future_free
+	});
+}
+
+void DbConnectionCommon::prepareOptionalStatement(CassandraStmtPtr& stmt, const std::string& name, const std::string& query)
+{
+	stmt.setMetrics(StatementMetrics::series(StatementMetrics::Backend::CASSANDRA, name));
+
+	if (_lazyPreparation) {
+		stmt.defer(_session.get(), query);
+		return;
 	}
+
+	_optionalPreparations.emplace_back(&stmt, std::unique_ptr<CassFuture, void(&)(CassFuture*)>{
+		cass_session_prepare(_session.get(), query.c_str()),
+		cass_future_free
+	});
 }
 
-void DbConnectionCommon::prepareOneStatement(CassandraStmtPtr& stmt, const std::string& query)
+void DbConnectionCommon::waitForPreparedStatements()
 {
-	CassFuture* prepareFuture = cass_session_prepare(_session.get(), query.c_str());
-	CassError rc = cass_future_error_code(prepareFuture);
-	if (rc != CASS_OK) {
+	// Wait for all the futures, even after an error, so that they are all
+	// freed before throwing
+	auto pending = std::move(_pendingPreparations);
+	_pendingPreparations.clear();
+	CassError error = CASS_OK;
+	for (auto& [stmt, prepareFuture] : pending) {
+		CassError rc = cass_future_error_code(prepareFuture.get());
+		if (rc != CASS_OK) {
+			if (error == CASS_OK)
+				error = rc;
+		} else {
+			stmt->reset(cass_future_get_prepared(prepareFuture.get()));
+		}
+	}
+
+	// The optional statements stay unset if they cannot be prepared
+	auto optional = std::move(_optionalPreparations);
+	_optionalPreparations.clear();
+	for (auto& [stmt, prepareFuture] : optional) {
+		if (cass_future_error_code(prepareFuture.get()) == CASS_OK)
+			stmt->reset(cass_future_get_prepared(prepareFuture.get()));
+	}
+
+	if (error != CASS_OK) {
 		std::string desc("Could not prepare statement: ");
-		desc.append(cass_error_desc(rc));
+		desc.append(cass_error_desc(error));
 		throw std::runtime_error(desc);
 	}
-	stmt.reset(cass_future_get_prepared(prepareFuture));
-	cass_future_free(prepareFuture);
 }
 
 void DbConnectionCommon::prepareStatements()
 {
-	prepareOneStatement(_selectAllStations, SELECT_ALL_STATIONS_STMT);
-	prepareOneStatement(_selectAllStationsFr, SELECT_ALL_STATIONS_FR_STMT);
-	prepareOneStatement(_selectStationDetails, SELECT_STATION_DETAILS_STMT);
-	prepareOneStatement(_selectStationLocation, SELECT_STATION_LOCATION_STMT);
-	prepareOneStatement(_selectWindValues, SELECT_WIND_VALUES_STMT);
+	prepareOneStatement(_selectAllStations, "select_all_stations", SELECT_ALL_STATIONS_STMT);
+	prepareOneStatement(_selectAllStationsFr, "select_all_stations_fr", SELECT_ALL_STATIONS_FR_STMT);
+	prepareOneStatement(_selectStationDetails, "select_station_details", SELECT_STATION_DETAILS_STMT);
+	prepareOneStatement(_selectStationLocation, "select_station_location", SELECT_STATION_LOCATION_STMT);
+	prepareOneStatement(_selectWindValues, "select_wind_values", SELECT_WIND_VALUES_STMT);
 }
 
 bool DbConnectionCommon::getAllStations(std::vector<CassUuid>& stations)
 {
-	bool ret = performSelect(_selectAllStations.get(),
-		[&](const CassRow* row) {
-			CassUuid uuid;
-			cass_value_get_uuid(cass_row_get_column(row, 0), &uuid);
-			stations.push_back(uuid);
-		}
-	);
-
-	if (!ret)
-		return false;
-
-	ret = performSelect(_selectAllStationsFr.get(),
-		[&](const CassRow* row) {
-			CassUuid uuid;
-			cass_value_get_uuid(cass_row_get_column(row, 0), &uuid);
-			stations.push_back(uuid);
-		}
-	);
+	auto collect = [&](const std::pair<bool, CassUuid>& uuid) {
+		stations.push_back(uuid.second);
+	};
 
-	return ret;
+	return performTypedSelect<CassUuid>(_selectAllStations, collect) &&
+	       performTypedSelect<CassUuid>(_selectAllStationsFr, collect);
 }
 
 bool DbConnectionCommon::getStationDetails(const CassUuid& uuid, std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements)
 {
-	return performSelect(_selectStationDetails.get(),
+	StationCache::Details details;
+	if (_stationCache.getDetails(uuid, details)) {
+		name = std::move(details.name);
+		pollPeriod = details.pollPeriod;
+		lastArchiveDownloadTime = details.lastArchiveDownloadTime;
+		if (storeInsideMeasurements)
+			*storeInsideMeasurements = details.storeInsideMeasurements;
+		return true;
+	}
+
+	bool found = false;
+	bool ret = performSelect(_selectStationDetails,
 		[&](const CassRow* row) {
 			const CassValue* v = cass_row_get_column(row, 0);
 			if (cass_value_is_null(v))
@@ -161,52 +204,80 @@ bool DbConnectionCommon::getStationDetails(const CassUuid& uuid, std::string& na
 			v = cass_row_get_column(row, 1);
 			if (cass_value_is_null(v))
 				return;
-			cass_value_get_int32(v, &pollPeriod);
+			cass_value_get_int32(v, &details.pollPeriod);
 
 			v = cass_row_get_column(row, 2);
 			if (cass_value_is_null(v))
 				return;
 			cass_int64_t timeMillisec;
 			cass_value_get_int64(v, &timeMillisec);
-			lastArchiveDownloadTime = timeMillisec/1000;
-
-			name.clear();
-			name.insert(0, stationName, size);
-
-			if (storeInsideMeasurements) {
-				v = cass_row_get_column(row, 3);
-				if (cass_value_is_null(v)) {
-					*storeInsideMeasurements = false;
-				} else {
-					cass_bool_t store;
-					cass_value_get_bool(v, &store);
-					*storeInsideMeasurements = store == cass_true;
-				}
+			details.lastArchiveDownloadTime = timeMillisec/1000;
+
+			details.name.assign(stationName, size);
+
+			v = cass_row_get_column(row, 3);
+			if (cass_value_is_null(v)) {
+				details.storeInsideMeasurements = false;
+			} else {
+				cass_bool_t store;
+				cass_value_get_bool(v, &store);
+				details.storeInsideMeasurements = store == cass_true;
 			}
+			found = true;
 		},
 		[&](CassStatement* stmt) {
 			cass_statement_bind_uuid(stmt, 0, uuid);
-		}
+		},
+		&uuid
 	);
+
+	if (found) {
+		name = details.name;
+		pollPeriod = details.pollPeriod;
+		lastArchiveDownloadTime = details.lastArchiveDownloadTime;
+		if (storeInsideMeasurements)
+			*storeInsideMeasurements = details.storeInsideMeasurements;
+		_stationCache.putDetails(uuid, std::move(details));
+	}
+	return ret;
 }
 
 bool DbConnectionCommon::getStationLocation(const CassUuid& uuid, float& latitude, float& longitude, int& elevation)
 {
-	return performSelect(_selectStationLocation.get(),
+	StationCache::Location location{latitude, longitude, elevation};
+	if (_stationCache.getLocation(uuid, location)) {
+		latitude = location.latitude;
+		longitude = location.longitude;
+		elevation = location.elevation;
+		return true;
+	}
+
+	bool found = false;
+	bool ret = performSelect(_selectStationLocation,
 		[&](const CassRow* row) {
-			cass_value_get_float(cass_row_get_column(row,0), &latitude);
-			cass_value_get_float(cass_row_get_column(row,1), &longitude);
-			cass_value_get_int32(cass_row_get_column(row,2), &elevation);
+			cass_value_get_float(cass_row_get_column(row,0), &location.latitude);
+			cass_value_get_float(cass_row_get_column(row,1), &location.longitude);
+			cass_value_get_int32(cass_row_get_column(row,2), &location.elevation);
+			found = true;
 		},
 		[&](CassStatement* stmt) {
 			cass_statement_bind_uuid(stmt, 0, uuid);
-		}
+		},
+		&uuid
 	);
+
+	if (found) {
+		latitude = location.latitude;
+		longitude = location.longitude;
+		elevation = location.elevation;
+		_stationCache.putLocation(uuid, location);
+	}
+	return ret;
 }
 
 bool DbConnectionCommon::getWindValues(const CassUuid& uuid, const date::sys_days& date, std::vector<std::pair<int,float>>& values)
 {
-	return performSelect(_selectWindValues.get(),
+	return performSelect(_selectWindValues,
 		[this, &values](const CassRow* row) {
 			std::pair<bool, int> dir;
 			std::pair<bool, float> speed;
@@ -218,53 +289,139 @@ bool DbConnectionCommon::getWindValues(const CassUuid& uuid, const date::sys_day
 		[&](CassStatement* stmt) {
 			cass_statement_bind_uuid(stmt, 0, uuid);
 			cass_statement_bind_uint32(stmt, 1, from_sysdays_to_CassandraDate(date));
-		}
+		},
+		&uuid
 	);
 }
 
-bool DbConnectionCommon::performSelect(const CassPrepared* stmt,
-	const std::function<void(const CassRow*)>& rowHandler,
-	const std::function<void(CassStatement*)>& parameterBinder
-	)
+bool DbConnectionCommon::getWindValues(const CassUuid& uuid, const date::sys_days& date, WindHistogram& histogram)
 {
-	std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-		cass_prepared_bind(stmt),
-		cass_statement_free
+	return performTypedSelect<int, float>(_selectWindValues,
+		[&histogram](const std::pair<bool, int>& dir, const std::pair<bool, float>& speed) {
+			if (dir.first && speed.first && dir.second >= 0 && dir.second <= 360)
+				histogram.add(dir.second, speed.second);
+		},
+		[&](CassStatement* stmt) {
+			cass_statement_bind_uuid(stmt, 0, uuid);
+			cass_statement_bind_uint32(stmt, 1, from_sysdays_to_CassandraDate(date));
+		},
+		&uuid
+	);
+}
+
+namespace {
+	/**
+	 * @brief The start of an execution, recorded when the future completes
+	 */
+	struct PendingExecution
+	{
+		StatementMetrics::Series* series;
+		QueryObserver* observer;
+		QueryObserver::Query query;
+		std::chrono::steady_clock::time_point start;
+		std::function<void(CassFuture*)> onCompletion;
 	};
-	cass_statement_set_is_idempotent(statement.get(), cass_true);
-	parameterBinder(statement.get());
-
-	cass_bool_t hasMorePages = cass_true;
-	bool ret = true;
-	while (ret && hasMorePages) {
-		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
-			cass_future_free
-		};
+
+	void recordExecution(CassFuture* future, void* data)
+	{
+		std::unique_ptr<PendingExecution> execution{static_cast<PendingExecution*>(data)};
+		std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - execution->start;
+		bool success = cass_future_error_code(future) == CASS_OK;
+		execution->series->record(duration, success);
+		if (!execution->observer) {
+			if (execution->onCompletion)
+				execution->onCompletion(future);
+			return;
+		}
+
+		// The result is only walked through when somebody is
+		// interested in its size
+		std::size_t rows = 0;
+		std::size_t bytes = 0;
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
-			cass_future_get_result(query.get()),
+			cass_future_get_result(future),
 			cass_result_free
 		};
-		ret = false;
 		if (result) {
+			rows = cass_result_row_count(result.get());
+			std::size_t columns = cass_result_column_count(result.get());
 			std::unique_ptr<CassIterator, void(&)(CassIterator*)> iterator{
 				cass_iterator_from_result(result.get()),
 				cass_iterator_free
 			};
 			while (cass_iterator_next(iterator.get())) {
 				const CassRow* row = cass_iterator_get_row(iterator.get());
-				if (row)
-					rowHandler(row);
-			}
-			ret = true;
-
-			hasMorePages = cass_result_has_more_pages(result.get());
-			if (hasMorePages) {
-				cass_statement_set_paging_state(statement.get(), result.get());
+				for (std::size_t i = 0 ; i < columns ; i++) {
+					const cass_byte_t* value;
+					std::size_t size;
+					if (cass_value_get_bytes(cass_row_get_column(row, i), &value, &size) == CASS_OK)
+						bytes += size;
+				}
 			}
 		}
+		execution->observer->onQueryEnd(execution->query, {success, rows, bytes, duration});
+		if (execution->onCompletion)
+			execution->onCompletion(future);
 	}
 
-	return ret;
+	std::unique_ptr<PendingExecution> startExecution(const CassandraStmtPtr& stmt, const CassUuid* station)
+	{
+		StatementMetrics::Series& series = stmt.metrics();
+		QueryObserver* observer = QueryObserver::installed();
+		auto execution = std::make_unique<PendingExecution>(PendingExecution{
+			&series,
+			observer,
+			{StatementMetrics::Backend::CASSANDRA, series.name(), {station != nullptr, station ? *station : CassUuid{}}},
+			{}
+		});
+		if (observer)
+			observer->onQueryStart(execution->query);
+		execution->start = std::chrono::steady_clock::now();
+		return execution;
+	}
+
+	CassFuture* watch(CassFuture* future, std::unique_ptr<PendingExecution> execution)
+	{
+		if (cass_future_set_callback(future, &recordExecution, execution.get()) == CASS_OK)
+			execution.release();
+		return future;
+	}
+}
+
+CassFuture* DbConnectionCommon::execute(const CassandraStmtPtr& stmt, const CassStatement* statement, const CassUuid* station)
+{
+	auto execution = startExecution(stmt, station);
+	return watch(cass_session_execute(_session.get(), statement), std::move(execution));
+}
+
+CassFuture* DbConnectionCommon::execute(const CassandraStmtPtr& stmt, const CassBatch* batch, const CassUuid* station)
+{
+	auto execution = startExecution(stmt, station);
+	return watch(cass_session_execute_batch(_session.get(), batch), std::move(execution));
+}
+
+void DbConnectionCommon::execute(const CassandraStmtPtr& stmt, const CassStatement* statement, const CassUuid* station, std::function<void(CassFuture*)> onCompletion)
+{
+	auto execution = startExecution(stmt, station);
+	execution->onCompletion = std::move(onCompletion);
+	CassFuture* future = cass_session_execute(_session.get(), statement);
+	if (cass_future_set_callback(future, &recordExecution, execution.get()) == CASS_OK) {
+		execution.release();
+	} else {
+		// Only possible if a callback is already set, which cannot
+		// be the case for a new future
+		cass_future_wait(future);
+		recordExecution(future, execution.release());
+	}
+	cass_future_free(future);
+}
+
+bool DbConnectionCommon::performSelect(const CassandraStmtPtr& stmt,
+	const std::function<void(const CassRow*)>& rowHandler,
+	const std::function<void(CassStatement*)>& parameterBinder,
+	const CassUuid* station
+	)
+{
+	return forEachRow(stmt, rowHandler, parameterBinder, station);
 }
 }
@@ -26,6 +26,7 @@
 
 #include <ctime>
 #include <functional>
+#include <memory>
 #include <tuple>
 #include <vector>
 #include <string>
@@ -36,6 +37,10 @@
 #include <pqxx/strconv>
 
 #include "cassandra_stmt_ptr.h"
+#include "cassandra_row_decoder.h"
+#include "connection_options.h"
+#include "station_cache.h"
+#include "wind_histogram.h"
 
 namespace pqxx
 {
@@ -63,13 +68,18 @@ class DbConnectionCommon
 		inline static void noParametersUsed(CassStatement* stmt) { }
 
 	public:
+		using StatementPreparation = meteodata::StatementPreparation;
+
 		/**
 		 * @brief Construct a connection to the database
 		 *
 		 * @param user the username to use
 		 * @param password the password corresponding to the username
+		 * @param options the tuning of the Cassandra session and when
+		 * to prepare the statements
 		 */
-		DbConnectionCommon(const std::string& address = "127.0.0.1", const std::string& user = "", const std::string& password = "");
+		DbConnectionCommon(const std::string& address = "127.0.0.1", const std::string& user = "", const std::string& password = "",
+			const ConnectionOptions& options = ConnectionOptions{});
 		/**
 		 * @brief Close the connection and destroy the database handle
 		 */
@@ -106,10 +116,64 @@ class DbConnectionCommon
 		 */
 		bool getStationLocation(const CassUuid& uuid, float& latitude, float& longitude, int& elevation);
 		bool getWindValues(const CassUuid& station, const date::sys_days& date, std::vector<std::pair<int,float>>& values);
+		/**
+		 * @brief Count the wind observations of a day in a histogram,
+		 * without keeping them
+		 *
+		 * @param station The station identifier
+		 * @param date The day
+		 * @param[in,out] histogram The histogram where to add the
+		 * observations with both a direction between 0 and 360° and a
+		 * speed
+		 *
+		 * @return True if, and only if, all went well
+		 */
+		bool getWindValues(const CassUuid& station, const date::sys_days& date, WindHistogram& histogram);
+		/**
+		 * @brief Set the number of rows fetched per page by the SELECT
+		 * queries
+		 *
+		 * Larger pages mean fewer round-trips for large scans but more
+		 * memory held per query.
+		 *
+		 * @param pageSize The number of rows per page, or zero or a negative
+		 * value to use the Cassandra driver's default
+		 */
+		void setSelectPageSize(int pageSize) { _selectPageSize = pageSize; }
+		/**
+		 * @brief Set how long the stations metadata are kept in the
+		 * cache before being read again from the database
+		 *
+		 * @param ttl The time to live of the cached metadata, the cache
+		 * is disabled if it's not positive
+		 */
+		void setStationCacheTtl(chrono::seconds ttl) { _stationCache.setTtl(ttl); }
+		/**
+		 * @brief Forget the cached metadata of a station, they will be
+		 * read again from the database on the next access
+		 *
+		 * This must be called when the station is modified by another
+		 * process, unless it's acceptable to see the old metadata for
+		 * up to the cache's time to live.
+		 *
+		 * @param station The station's UUID
+		 */
+		void invalidateStation(const CassUuid& station) { _stationCache.invalidate(station); }
+		/**
+		 * @brief Forget the cached metadata of all stations
+		 */
+		void invalidateAllStations() { _stationCache.clear(); }
+		/**
+		 * @brief Get the number of hits and misses of the stations
+		 * metadata cache
+		 */
+		StationCache::Statistics getStationCacheStatistics() const { return _stationCache.statistics(); }
 
 	protected:
 		/**
-		 * @brief The Cassandra session data
+		 * @brief The Cassandra session data, shared with all the
+		 * connections to the same cluster with the same credentials
+		 * (see CassandraSessionRegistry)
 		 */
 		std::unique_ptr<CassSession, std::function<void(CassSession*)>> _session;
 		/**
@@ -271,16 +335,229 @@ class DbConnectionCommon
 		}
 
 		/**
-		 * @brief Prepare one Cassandra query/insert statement
+		 * @brief Start preparing one Cassandra query/insert statement
+		 *
+		 * The statement is prepared asynchronously, all the statements
+		 * being prepared concurrently, \a stmt is only set once
+		 * waitForPreparedStatements() returns. With lazy preparation,
+		 * the statement is prepared by the first call to \a stmt.get()
+		 * or \a stmt.bind() instead.
 		 *
 		 * @param[out] stmt The Cassandra prepared statement to set up
+		 * @param[in]  name The name of the statement, under which its
+		 * executions are recorded in the StatementMetrics
 		 * @param[in]  query The query of the prepared statement
 		 */
-		void prepareOneStatement(CassandraStmtPtr& stmt, const std::string& query);
+		void prepareOneStatement(CassandraStmtPtr& stmt, const std::string& name, const std::string& query);
+
+		/**
+		 * @brief Start preparing one Cassandra statement on a table
+		 * which may not exist in the cluster
+		 *
+		 * This is the same as prepareOneStatement(), except that
+		 * waitForPreparedStatements() does not fail if the statement
+		 * cannot be prepared, \a stmt is left unset instead and its
+		 * get() method returns nullptr. This lets the library run
+		 * against the clusters whose schema predates the table.
+		 *
+		 * @param[out] stmt The Cassandra prepared statement to set up
+		 * @param[in]  name The name of the statement, under which its
+		 * executions are recorded in the StatementMetrics
+		 * @param[in]  query The query of the prepared statement
+		 */
+		void prepareOptionalStatement(CassandraStmtPtr& stmt, const std::string& name, const std::string& query);
+
+		/**
+		 * @brief Wait for all the statements passed to
+		 * prepareOneStatement() to be prepared
+		 *
+		 * This must be called by the constructor of each subclass once
+		 * its statements are submitted.
+		 *
+		 * @throw std::runtime_error If a statement passed to
+		 * prepareOneStatement() could not be prepared
+		 */
+		void waitForPreparedStatements();
+
+		/**
+		 * @brief Execute a statement bound from a prepared statement,
+		 * recording its latency and its outcome in the series of the
+		 * prepared statement
+		 *
+		 * The measurement is made in a callback of the future, so it
+		 * does not matter whether the future is ever waited for. The
+		 * installed QueryObserver, if any, is notified too.
+		 *
+		 * @param stmt The prepared statement \a statement is bound from
+		 * @param statement The statement to execute
+		 * @param station The station concerned by the statement, if
+		 * known, for the QueryObserver
+		 *
+		 * @return The future of the execution, to be freed by the caller
+		 */
+		CassFuture* execute(const CassandraStmtPtr& stmt, const CassStatement* statement, const CassUuid* station = nullptr);
+
+		/**
+		 * @brief Execute a batch of statements, all bound from the same
+		 * prepared statement, recording its latency and its outcome in
+		 * the series of the prepared statement
+		 *
+		 * @param stmt The prepared statement the statements of \a batch
+		 * are bound from
+		 * @param batch The batch to execute
+		 * @param station The station concerned by the statements, if
+		 * known, for the QueryObserver
+		 *
+		 * @return The future of the execution, to be freed by the caller
+		 */
+		CassFuture* execute(const CassandraStmtPtr& stmt, const CassBatch* batch, const CassUuid* station = nullptr);
+
+		/**
+		 * @brief Execute a statement bound from a prepared statement
+		 * without waiting for it, like execute(const CassandraStmtPtr&, const CassStatement*, const CassUuid*)
+		 *
+		 * @param stmt The prepared statement \a statement is bound from
+		 * @param statement The statement to execute
+		 * @param station The station concerned by the statement, if
+		 * known, for the QueryObserver
+		 * @param onCompletion The function called with the future once
+		 * the execution has completed, from a thread of the driver, it
+		 * must not block
+		 */
+		void execute(const CassandraStmtPtr& stmt, const CassStatement* statement, const CassUuid* station, std::function<void(CassFuture*)> onCompletion);
+
+		bool performSelect(const CassandraStmtPtr& stmt, const std::function<void(const CassRow*)>& rowHandler, const std::function<void(CassStatement*)>& parameterBinder = &noParametersUsed, const CassUuid* station = nullptr);
+
+		/**
+		 * @brief Run a SELECT query and decode each row into typed values
+		 *
+		 * The columns are decoded in order into a tuple of
+		 * std::pair<bool, Columns>..., the first element of each pair being
+		 * false for null values, and the row handler is called with the
+		 * elements of the tuple as arguments. Everything is resolved at
+		 * compile time, there is no std::function call and no temporary
+		 * string per row (std::string_view columns refer to the Cassandra
+		 * result and must be copied if they are to outlive the call to the
+		 * row handler).
+		 *
+		 * @tparam Columns The types of the columns, among those supported by
+		 * cassandra_row::decode()
+		 * @param[in] stmt The prepared statement
+		 * @param[in] rowHandler The function called for each row
+		 * @param[in] parameterBinder The function binding the parameters of
+		 * the query, if any
+		 * @param[in] station The station concerned by the query, if
+		 * known, for the QueryObserver
+		 *
+		 * @return True if, and only if, all went well
+		 */
+		template<typename... Columns, typename RowHandler, typename ParameterBinder = decltype(&noParametersUsed)>
+		bool performTypedSelect(const CassandraStmtPtr& stmt, RowHandler&& rowHandler, ParameterBinder&& parameterBinder = &noParametersUsed, const CassUuid* station = nullptr)
+		{
+			std::tuple<std::pair<bool, Columns>...> values;
+			return forEachRow(stmt,
+				[&](const CassRow* row) {
+					cassandra_row::decodeRow(row, values);
+					std::apply(rowHandler, values);
+				},
+				parameterBinder,
+				station
+			);
+		}
 
-		bool performSelect(const CassPrepared* stmt, const std::function<void(const CassRow*)>& rowHandler, const std::function<void(CassStatement*)>& parameterBinder = &noParametersUsed);
+		/**
+		 * @brief Execute a prepared statement, going through all the pages of
+		 * the result, and call a function on each row
+		 *
+		 * This is the loop shared by performSelect() and
+		 * performTypedSelect(). The next page is requested as soon as the
+		 * current one is received, before the rows of the current one are
+		 * handled, so that the network round-trip overlaps with the
+		 * processing. Two statements are used alternatively since the
+		 * driver keeps a reference to a statement being executed and its
+		 * paging state cannot be changed in the meantime.
+		 */
+		template<typename RowHandler, typename ParameterBinder>
+		bool forEachRow(const CassandraStmtPtr& stmt, RowHandler&& rowHandler, ParameterBinder&& parameterBinder, const CassUuid* station = nullptr)
+		{
+			using StatementPtr = std::unique_ptr<CassStatement, void(&)(CassStatement*)>;
+			using FuturePtr = std::unique_ptr<CassFuture, void(&)(CassFuture*)>;
+			using ResultPtr = std::unique_ptr<const CassResult, void(&)(const CassResult*)>;
+
+			StatementPtr statements[2] = {
+				{ stmt.bind(), cass_statement_free },
+				{ stmt.bind(), cass_statement_free }
+			};
+			if (!statements[0] || !statements[1])
+				return false;
+			for (StatementPtr& statement : statements) {
+				cass_statement_set_is_idempotent(statement.get(), cass_true);
+				if (_selectPageSize > 0)
+					cass_statement_set_paging_size(statement.get(), _selectPageSize);
+				parameterBinder(statement.get());
+			}
+
+			int current = 0;
+			FuturePtr query{execute(stmt, statements[current].get(), station), cass_future_free};
+			while (query) {
+				ResultPtr result{cass_future_get_result(query.get()), cass_result_free};
+				query.reset();
+				if (!result)
+					return false;
+
+				// Prefetch the next page while this one is processed
+				if (cass_result_has_more_pages(result.get())) {
+					current = 1 - current;
+					cass_statement_set_paging_state(statements[current].get(), result.get());
+					query.reset(execute(stmt, statements[current].get(), station));
+				}
+
+				std::unique_ptr<CassIterator, void(&)(CassIterator*)> iterator{
+					cass_iterator_from_result(result.get()),
+					cass_iterator_free
+				};
+				while (cass_iterator_next(iterator.get())) {
+					const CassRow* row = cass_iterator_get_row(iterator.get());
+					if (row)
+						rowHandler(row);
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * @brief The number of rows fetched per page by performSelect() and
+		 * performTypedSelect(), the driver's default if not positive
+		 */
+		int _selectPageSize = 0;
+
+		/**
+		 * @brief The cache of the stations metadata, in front of
+		 * getStationDetails(), getStationLocation() and the station
+		 * lookups of the subclasses
+		 */
+		StationCache _stationCache;
 
 	private:
+		/**
+		 * @brief Whether the statements are prepared on first use
+		 */
+		bool _lazyPreparation;
+
+		/**
+		 * @brief The statements submitted by prepareOneStatement() and
+		 * the futures of their preparation
+		 */
+		std::vector<std::pair<CassandraStmtPtr*, std::unique_ptr<CassFuture, void(&)(CassFuture*)>>> _pendingPreparations;
+
+		/**
+		 * @brief The statements submitted by
+		 * prepareOptionalStatement() and the futures of their
+		 * preparation
+		 */
+		std::vector<std::pair<CassandraStmtPtr*, std::unique_ptr<CassFuture, void(&)(CassFuture*)>>> _optionalPreparations;
+
 		/**
 		 * @brief The raw query string to select all stations from the database
 		 */
@@ -34,6 +34,7 @@
 #include <date/date.h>
 
 #include "dbconnection_jobs.h"
+#include "query_observer.h"
 
 namespace meteodata {
 
@@ -77,18 +78,22 @@ void DbConnectionJobs::prepareStatements()
 	_retrieveJobStmt.reset(mysql_stmt_init(_db.get()));
 	if (mysql_stmt_prepare(_retrieveJobStmt.get(), RETRIEVE_JOB, sizeof(RETRIEVE_JOB)))
 		panic("Could not prepare statement \"retrieveJob\"");
+	_retrieveJobMetrics = &StatementMetrics::series(StatementMetrics::Backend::MYSQL, "retrieveJob");
 
 	_publishJobStmt.reset(mysql_stmt_init(_db.get()));
 	if (mysql_stmt_prepare(_publishJobStmt.get(), PUBLISH_JOB, sizeof(PUBLISH_JOB)))
 		panic("Could not prepare statement \"publishJob\"");
+	_publishJobMetrics = &StatementMetrics::series(StatementMetrics::Backend::MYSQL, "publishJob");
 
 	_reserveJobStmt.reset(mysql_stmt_init(_db.get()));
 	if (mysql_stmt_prepare(_reserveJobStmt.get(), RESERVE_JOB, sizeof(RESERVE_JOB)))
 		panic("Could not prepare statement \"reserveJob\"");
+	_reserveJobMetrics = &StatementMetrics::series(StatementMetrics::Backend::MYSQL, "reserveJob");
 
 	_markJobAsFinishedStmt.reset(mysql_stmt_init(_db.get()));
 	if (mysql_stmt_prepare(_markJobAsFinishedStmt.get(), MARK_JOB_AS_FINISHED, sizeof(MARK_JOB_AS_FINISHED)))
 		panic("Could not prepare statement \"markJobAsFinishedJob\"");
+	_markJobAsFinishedMetrics = &StatementMetrics::series(StatementMetrics::Backend::MYSQL, "markJobAsFinished");
 }
 
 std::optional<DbConnectionJobs::StationJob> DbConnectionJobs::retrieveStationJob(const char* job)
@@ -115,7 +120,10 @@ std::optional<DbConnectionJobs::StationJob> DbConnectionJobs::retrieveStationJob
 
 	if (mysql_stmt_bind_param(stmt, params))
 		panic(stmt, "Failed to bind params in statement \"retrieveJob\"");
-	if (mysql_stmt_execute(stmt))
+	QueryTrace trace{*_retrieveJobMetrics};
+	bool failed = mysql_stmt_execute(stmt);
+	trace.stop(!failed);
+	if (failed)
 		panic(stmt, "Failed to execute statement \"retrieveJob\"");
 
 	constexpr int NB_COLS = 6;
@@ -217,7 +225,10 @@ std::optional<DbConnectionJobs::StationJob> DbConnectionJobs::retrieveStationJob
 
 	if (mysql_stmt_bind_param(reserveJobStmt, params))
 		panic(reserveJobStmt, "Failed to bind params in statement \"reserveJob\"");
-	if (mysql_stmt_execute(reserveJobStmt))
+	QueryTrace reserveJobTrace{*_reserveJobMetrics};
+	bool reserveJobFailed = mysql_stmt_execute(reserveJobStmt);
+	reserveJobTrace.stop(!reserveJobFailed);
+	if (reserveJobFailed)
 		panic(reserveJobStmt, "Failed to execute statement \"reserveJob\"");
 
 	// Release the sentinel value to delete it manually and commit the
@@ -254,7 +265,10 @@ bool DbConnectionJobs::markJobAsFinished(int jobId, time_t completionTimestamp,
 		panic(stmt, "Failed to bind params in statement \"markJobAsFinished\"");
 		return false;
 	}
-	if (mysql_stmt_execute(stmt)) {
+	QueryTrace trace{*_markJobAsFinishedMetrics};
+	bool failed = mysql_stmt_execute(stmt);
+	trace.stop(!failed);
+	if (failed) {
 		panic(stmt, "Failed to execute statement \"markJobAsFinished\"");
 		return false;
 	}
@@ -291,7 +305,10 @@ bool DbConnectionJobs::publishStationJob(const char* jobType,
 		panic(stmt, "Failed to bind params in statement \"publishJob\"");
 		return false;
 	}
-	if (mysql_stmt_execute(stmt)) {
+	QueryTrace trace{*_publishJobMetrics, &station};
+	bool failed = mysql_stmt_execute(stmt);
+	trace.stop(!failed);
+	if (failed) {
 		panic(stmt, "Failed to execute statement \"publishJob\"");
 		return false;
 	}
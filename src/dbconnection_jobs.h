@@ -41,13 +41,15 @@
 #include "message.h"
 #include "dbconnection_common.h"
 #include "observation.h"
+#include "job_storage.h"
+#include "statement_metrics.h"
 
 namespace meteodata {
 /**
  * @brief A handle to the database to insert and retrieves jobs or tasks to
  * complete
  */
-class DbConnectionJobs
+class DbConnectionJobs : public JobStorage
 {
 public:
 	/**
@@ -62,86 +64,20 @@ public:
 	 */
 	virtual ~DbConnectionJobs() = default;
 
-	struct JobType {
-		static constexpr char MINMAX[] = "minmax";
-		static constexpr char MONTH_MINMAX[] = "month_minmax";
-		static constexpr char ANOMALY_MONITORING[] = "anomaly_monitoring";
-	};
-
-	struct StationJob
-	{
-		long id;
-		std::string job;
-		CassUuid station;
-		date::sys_seconds submissionDatetime;
-		date::sys_seconds begin;
-		date::sys_seconds end;
-	};
+	using JobType = JobStorage::JobType;
+	using StationJob = JobStorage::StationJob;
 
-	/**
-	 * @brief Publish a minmax job
-	 *
-	 * @param station The station's UUID
-	 * @param begin The beginning of the period to (re)compute
-	 * @param end The end of the period to (re)compute
-	 *
-	 * @return The boolean value true if everything went well, false if an error occurred
-	 */
-	bool publishMinmax(const CassUuid& station, time_t beginning, time_t end);
-	/**
-	 * @brief Retrieve the next available minmax job
-	 *
-	 * @return A station job if one could be found or an empty value
-	 */
-	std::optional<StationJob> retrieveMinmax();
+	bool publishMinmax(const CassUuid& station, time_t beginning, time_t end) override;
+	std::optional<StationJob> retrieveMinmax() override;
 
-	/**
-	 * @brief Publish a minmax job
-	 *
-	 * @param station The station's UUID
-	 * @param begin The beginning of the period to (re)compute
-	 * @param end The end of the period to (re)compute
-	 *
-	 * @return The boolean value true if everything went well, false if an error occurred
-	 */
-	bool publishMonthMinmax(const CassUuid& station, time_t beginning, time_t end);
-	/**
-	 * @brief Publish a monthly minmax job
-	 *
-	 * @return A station job if one could be found or an empty value
-	 */
-	std::optional<StationJob> retrieveMonthMinmax();
+	bool publishMonthMinmax(const CassUuid& station, time_t beginning, time_t end) override;
+	std::optional<StationJob> retrieveMonthMinmax() override;
 
-	/**
-	 * @brief Publish an anomaly monitoring job
-	 *
-	 * @param station The station's UUID
-	 * @param begin The beginning of the period to (re)compute
-	 * @param end The end of the period to (re)compute
-	 *
-	 * @return The boolean value true if everything went well, false if an error occurred
-	 */
-	bool publishAnomalyMonitoring(const CassUuid& station, time_t beginning, time_t end);
-	/**
-	 * @brief Publish an anomaly monitoring job
-	 *
-	 * @return A station job if one could be found or an empty value
-	 */
-	std::optional<StationJob> retrieveAnomalyMonitoring();
+	bool publishAnomalyMonitoring(const CassUuid& station, time_t beginning, time_t end) override;
+	std::optional<StationJob> retrieveAnomalyMonitoring() override;
 
-	/**
-	 * @brief Register a job in the database as finished, with a completion
-	 * date and a status code (0 if everything went well, an error code
-	 * otherwise)
-	 *
-	 * @param jobId The job id in the database, as retrieved from a
-	 * "retrieve" query
-	 * @param completionTimestamp A timestamp of when the job was done (or
-	 * unsuccesfully attempted and deemed not doable)
-	 * @param statusCode The exit code of the program that did the job
-	 */
 	bool markJobAsFinished(int jobId, time_t completionDatetime,
-			int statusCode);
+			int statusCode) override;
 
 
 private:
@@ -150,10 +86,12 @@ private:
 	static constexpr char RESERVE_JOB[] =
 			"UPDATE jobs SET started_at = NOW() WHERE jobs.id = ?";
 	std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)> _reserveJobStmt;
+	StatementMetrics::Series* _reserveJobMetrics = nullptr;
 
 	static constexpr char MARK_JOB_AS_FINISHED[] =
 			"UPDATE jobs SET completed_at = FROM_UNIXTIME(?), status_code = ? WHERE jobs.id = ?";
 	std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)> _markJobAsFinishedStmt;
+	StatementMetrics::Series* _markJobAsFinishedMetrics = nullptr;
 
 	static constexpr char RETRIEVE_JOB[] =
 			"SELECT j.id, j.command, j.station, j.begin, j.end, j.submitted_at "
@@ -161,11 +99,13 @@ private:
 			" WHERE j.command = ? AND j.started_at IS NULL "
 			" ORDER BY j.submitted_at LIMIT 1 FOR UPDATE SKIP LOCKED";
 	std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)> _retrieveJobStmt;
+	StatementMetrics::Series* _retrieveJobMetrics = nullptr;
 
 	static constexpr char PUBLISH_JOB[] =
 			"INSERT INTO jobs (command, station, begin, end) "
 			" VALUES (?, ?, FROM_UNIXTIME(?), FROM_UNIXTIME(?)) ";
 	std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)> _publishJobStmt;
+	StatementMetrics::Series* _publishJobMetrics = nullptr;
 
 	void prepareStatements();
 	void panic(const std::string& msg);
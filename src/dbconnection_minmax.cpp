@@ -28,6 +28,7 @@
 #include <pqxx/except.hxx>
 #include <vector>
 #include <string>
+#include <sstream>
 
 #include <cassandra.h>
 #include <syslog.h>
@@ -37,6 +38,9 @@
 #include "dbconnection_minmax.h"
 #include "dbconnection_common.h"
 #include "cassandra_stmt_ptr.h"
+#include "daily_aggregator.h"
+#include "observation.h"
+#include "query_observer.h"
 
 using namespace date;
 
@@ -54,66 +58,177 @@ constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL[];
 constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL_STMT[];
 constexpr char DbConnectionMinmax::SELECT_VALUES_BEFORE_18H_STMT[];
 constexpr char DbConnectionMinmax::SELECT_VALUES_AFTER_18H_STMT[];
+constexpr char DbConnectionMinmax::SELECT_OBSERVATIONS_STMT[];
 constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL[];
 constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL_STMT[];
 constexpr char DbConnectionMinmax::SELECT_YEARLY_VALUES_STMT[];
 constexpr char DbConnectionMinmax::SELECT_YEARLY_VALUES_POSTGRESQL[];
 constexpr char DbConnectionMinmax::SELECT_YEARLY_VALUES_POSTGRESQL_STMT[];
+constexpr char DbConnectionMinmax::SELECT_CUMULATIVE_VALUES_POSTGRESQL[];
+constexpr char DbConnectionMinmax::SELECT_CUMULATIVE_VALUES_POSTGRESQL_STMT[];
+constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL[];
+constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL_STMT[];
+constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL[];
+constexpr char DbConnectionMinmax::SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL_STMT[];
+constexpr char DbConnectionMinmax::SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL[];
+constexpr char DbConnectionMinmax::SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL_STMT[];
 
 namespace chrono = std::chrono;
 
 
 DbConnectionMinmax::DbConnectionMinmax(
 		const std::string& address, const std::string& user, const std::string& password,
-		const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword) :
-	DbConnectionCommon(address, user, password),
-	_pqConnection{"host=" + pgAddress + " user=" + pgUser + " password=" + pgPassword + " dbname=meteodata"}
+		const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword,
+		const ConnectionOptions& options) :
+	DbConnectionCommon(address, user, password, options),
+	_pqConnections{"host=" + pgAddress + " user=" + pgUser + " password=" + pgPassword + " dbname=meteodata", options.pgPoolSize}
 {
 	DbConnectionMinmax::prepareStatements();
+	waitForPreparedStatements();
 }
 
 void DbConnectionMinmax::prepareStatements()
 {
-	prepareOneStatement(_selectValuesBefore6h, SELECT_VALUES_BEFORE_6H_STMT);
-	prepareOneStatement(_selectValuesAfter6h, SELECT_VALUES_AFTER_6H_STMT);
-	prepareOneStatement(_selectValuesAllDay, SELECT_VALUES_ALL_DAY_STMT);
-	prepareOneStatement(_selectValuesBefore18h, SELECT_VALUES_BEFORE_18H_STMT);
-	prepareOneStatement(_selectValuesAfter18h, SELECT_VALUES_AFTER_18H_STMT);
-	prepareOneStatement(_selectYearlyValues, SELECT_YEARLY_VALUES_STMT);
-	prepareOneStatement(_insertDataPoint, INSERT_DATAPOINT_STMT);
-	_pqConnection.prepare(UPSERT_DATAPOINT_POSTGRESQL, UPSERT_DATAPOINT_POSTGRESQL_STMT);
-	_pqConnection.prepare(SELECT_YEARLY_VALUES_POSTGRESQL, SELECT_YEARLY_VALUES_POSTGRESQL_STMT);
-	_pqConnection.prepare(SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL, SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL_STMT);
-	_pqConnection.prepare(SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL, SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL_STMT);
-	_pqConnection.prepare(SELECT_VALUES_ALL_DAY_POSTGRESQL, SELECT_VALUES_ALL_DAY_POSTGRESQL_STMT);
+	prepareOneStatement(_selectValuesBefore6h, "minmax_select_values_before6h", SELECT_VALUES_BEFORE_6H_STMT);
+	prepareOneStatement(_selectValuesAfter6h, "minmax_select_values_after6h", SELECT_VALUES_AFTER_6H_STMT);
+	prepareOneStatement(_selectValuesAllDay, "minmax_select_values_all_day", SELECT_VALUES_ALL_DAY_STMT);
+	prepareOneStatement(_selectValuesBefore18h, "minmax_select_values_before18h", SELECT_VALUES_BEFORE_18H_STMT);
+	prepareOneStatement(_selectValuesAfter18h, "minmax_select_values_after18h", SELECT_VALUES_AFTER_18H_STMT);
+	prepareOneStatement(_selectObservations, "minmax_select_observations", SELECT_OBSERVATIONS_STMT);
+	prepareOneStatement(_selectYearlyValues, "minmax_select_yearly_values", SELECT_YEARLY_VALUES_STMT);
+	prepareOneStatement(_insertDataPoint, "minmax_insert_data_point", INSERT_DATAPOINT_STMT);
+	_pqConnections.prepare(UPSERT_DATAPOINT_POSTGRESQL, UPSERT_DATAPOINT_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_YEARLY_VALUES_POSTGRESQL, SELECT_YEARLY_VALUES_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL, SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL, SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_VALUES_ALL_DAY_POSTGRESQL, SELECT_VALUES_ALL_DAY_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_CUMULATIVE_VALUES_POSTGRESQL, SELECT_CUMULATIVE_VALUES_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL, SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL, SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL_STMT);
+	_pqConnections.prepare(SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL, SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL_STMT);
+}
+
+namespace {
+	void readCumulativeValues(const pqxx::row& r, DbConnectionMinmax::Values& values)
+	{
+		values.monthRain = { !r[0].is_null(), r[0].as<float>(0.f) };
+		values.monthEt   = { !r[1].is_null(), r[1].as<float>(0.f) };
+		values.yearRain  = { !r[2].is_null(), r[2].as<float>(0.f) };
+		values.yearEt    = { !r[3].is_null(), r[3].as<float>(0.f) };
+	}
+}
+
+void DbConnectionMinmax::read6hTo6h(const pqxx::row& r, Values& values)
+{
+	values.insideTemp_max   = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
+	values.leafTemp_max[0]  = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
+	values.leafTemp_max[1]  = { !r[ 2].is_null(), r[ 2].as<float>(0.f) };
+	values.outsideTemp_max  = { !r[ 3].is_null() || !r[4].is_null(), r[4].as<float>(r[3].as<float>(0.0f)) };
+	values.soilTemp_max[0]  = { !r[ 5].is_null(), r[ 5].as<float>(0.f) };
+	values.soilTemp_max[1]  = { !r[ 6].is_null(), r[ 6].as<float>(0.f) };
+	values.soilTemp_max[2]  = { !r[ 7].is_null(), r[ 7].as<float>(0.f) };
+	values.soilTemp_max[3]  = { !r[ 8].is_null(), r[ 8].as<float>(0.f) };
+	values.extraTemp_max[0] = { !r[ 9].is_null(), r[ 9].as<float>(0.f) };
+	values.extraTemp_max[1] = { !r[10].is_null(), r[10].as<float>(0.f) };
+	values.extraTemp_max[2] = { !r[11].is_null(), r[11].as<float>(0.f) };
+	values.rainfall         = { !r[12].is_null(), r[12].as<float>(0.f) };
+	values.rainrate_max     = { !r[13].is_null(), r[13].as<float>(0.f) };
+}
+
+void DbConnectionMinmax::read18hTo18h(const pqxx::row& r, Values& values)
+{
+	values.insideTemp_min   = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
+	values.leafTemp_min[0]  = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
+	values.leafTemp_min[1]  = { !r[ 2].is_null(), r[ 2].as<float>(0.f) };
+	values.outsideTemp_min  = { !r[ 3].is_null() || !r[4].is_null(), r[4].as<float>(r[3].as<float>(0.0f)) };
+	values.soilTemp_min[0]  = { !r[ 5].is_null(), r[ 5].as<float>(0.f) };
+	values.soilTemp_min[1]  = { !r[ 6].is_null(), r[ 6].as<float>(0.f) };
+	values.soilTemp_min[2]  = { !r[ 7].is_null(), r[ 7].as<float>(0.f) };
+	values.soilTemp_min[3]  = { !r[ 8].is_null(), r[ 8].as<float>(0.f) };
+	values.extraTemp_min[0] = { !r[ 9].is_null(), r[ 9].as<float>(0.f) };
+	values.extraTemp_min[1] = { !r[10].is_null(), r[10].as<float>(0.f) };
+	values.extraTemp_min[2] = { !r[11].is_null(), r[11].as<float>(0.f) };
+}
+
+void DbConnectionMinmax::read0hTo0h(const pqxx::row& r, Values& values)
+{
+	values.barometer_min        = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
+	values.barometer_max        = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
+	values.barometer_avg        = { !r[ 2].is_null(), r[ 2].as<float>(0.f) };
+	values.leafWetnesses_min[0] = { !r[ 3].is_null(), r[ 3].as<float>(0.f) };
+	values.leafWetnesses_max[0] = { !r[ 4].is_null(), r[ 4].as<float>(0.f) };
+	values.leafWetnesses_avg[0] = { !r[ 5].is_null(), r[ 5].as<float>(0.f) };
+	values.leafWetnesses_min[1] = { !r[ 6].is_null(), r[ 6].as<float>(0.f) };
+	values.leafWetnesses_max[1] = { !r[ 7].is_null(), r[ 7].as<float>(0.f) };
+	values.leafWetnesses_avg[1] = { !r[ 8].is_null(), r[ 8].as<float>(0.f) };
+	values.soilMoistures_min[0] = { !r[ 9].is_null(), r[ 9].as<float>(0.f) };
+	values.soilMoistures_max[0] = { !r[10].is_null(), r[10].as<float>(0.f) };
+	values.soilMoistures_avg[0] = { !r[11].is_null(), r[11].as<float>(0.f) };
+	values.soilMoistures_min[1] = { !r[12].is_null(), r[12].as<float>(0.f) };
+	values.soilMoistures_max[1] = { !r[13].is_null(), r[13].as<float>(0.f) };
+	values.soilMoistures_avg[1] = { !r[14].is_null(), r[14].as<float>(0.f) };
+	values.soilMoistures_min[2] = { !r[15].is_null(), r[15].as<float>(0.f) };
+	values.soilMoistures_max[2] = { !r[16].is_null(), r[16].as<float>(0.f) };
+	values.soilMoistures_avg[2] = { !r[17].is_null(), r[17].as<float>(0.f) };
+	values.soilMoistures_min[3] = { !r[18].is_null(), r[18].as<float>(0.f) };
+	values.soilMoistures_max[3] = { !r[19].is_null(), r[19].as<float>(0.f) };
+	values.soilMoistures_avg[3] = { !r[20].is_null(), r[20].as<float>(0.f) };
+	values.insideHum_min        = { !r[21].is_null(), r[21].as<float>(0.f) };
+	values.insideHum_max        = { !r[22].is_null(), r[22].as<float>(0.f) };
+	values.insideHum_avg        = { !r[23].is_null(), r[23].as<float>(0.f) };
+	values.outsideHum_min       = { !r[24].is_null(), r[24].as<float>(0.f) };
+	values.outsideHum_max       = { !r[25].is_null(), r[25].as<float>(0.f) };
+	values.outsideHum_avg       = { !r[26].is_null(), r[26].as<float>(0.f) };
+	values.extraHum_min[0]      = { !r[27].is_null(), r[27].as<float>(0.f) };
+	values.extraHum_max[0]      = { !r[28].is_null(), r[28].as<float>(0.f) };
+	values.extraHum_avg[0]      = { !r[29].is_null(), r[29].as<float>(0.f) };
+	values.extraHum_min[1]      = { !r[30].is_null(), r[30].as<float>(0.f) };
+	values.extraHum_max[1]      = { !r[31].is_null(), r[31].as<float>(0.f) };
+	values.extraHum_avg[1]      = { !r[32].is_null(), r[32].as<float>(0.f) };
+	values.solarRad_max         = { !r[33].is_null(), r[33].as<float>(0.f) };
+	values.solarRad_avg         = { !r[34].is_null(), r[34].as<float>(0.f) };
+	values.uv_max               = { !r[35].is_null(), r[35].as<float>(0.f) };
+	values.uv_avg               = { !r[36].is_null(), r[36].as<float>(0.f) };
+	values.windgust_max         = { !r[37].is_null(), r[37].as<float>(0.f) };
+	values.windgust_avg         = { !r[38].is_null(), r[38].as<float>(0.f) };
+	values.windspeed_max        = { !r[39].is_null(), r[39].as<float>(0.f) };
+	values.windspeed_avg        = { !r[40].is_null(), r[40].as<float>(0.f) };
+	values.dewpoint_min         = { !r[41].is_null(), r[41].as<float>(0.f) };
+	values.dewpoint_max         = { !r[42].is_null(), r[42].as<float>(0.f) };
+	values.dewpoint_avg         = { !r[43].is_null(), r[43].as<float>(0.f) };
+	values.et                   = { !r[44].is_null(), r[44].as<float>(0.f) };
+	values.insolation_time      = { !r[45].is_null(), r[45].as<float>(0.f) };
+	if (!r[46].is_null() && (!values.rainfall.first || values.rainfall.second < r[46].as<float>(0.0f))) {
+		values.rainfall  = { true, r[46].as<float>(0.f) };
+	}
+	if (!r[47].is_null() && (!values.insolation_time.first || values.insolation_time.second < r[47].as<float>(0.0f))) {
+		values.insolation_time  = { true, r[47].as<float>(0.f) };
+	}
+	if (!r[48].is_null() && (!values.outsideTemp_max.first || values.outsideTemp_max.second < r[48].as<float>(0.0f))) {
+		values.outsideTemp_max  = { true, r[48].as<float>(0.f) };
+	}
+	if (!r[49].is_null() && (!values.outsideTemp_min.first || values.outsideTemp_min.second < r[49].as<float>(0.0f))) {
+		values.outsideTemp_min  = { true, r[49].as<float>(0.f) };
+	}
 }
 
 bool DbConnectionMinmax::getValues6hTo6h(const CassUuid& uuid, const date::sys_days& date, DbConnectionMinmax::Values& values)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 
 	try {
 		char u[CASS_UUID_STRING_LENGTH];
 		cass_uuid_string(uuid, u);
+		QueryTrace trace{_pqConnections.metrics(SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL), &uuid};
 		pqxx::row r = tx.exec_prepared1(SELECT_VALUES_FROM_6H_TO_6H_POSTGRESQL,
 			u,
 			date::format("%F %T%z", date)
 		);
+		trace.addRow(r);
+		trace.stop();
 
-		values.insideTemp_max   = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
-		values.leafTemp_max[0]  = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
-		values.leafTemp_max[1]  = { !r[ 2].is_null(), r[ 2].as<float>(0.f) };
-		values.outsideTemp_max  = { !r[ 3].is_null() || !r[4].is_null(), r[4].as<float>(r[3].as<float>(0.0f)) };
-		values.soilTemp_max[0]  = { !r[ 5].is_null(), r[ 5].as<float>(0.f) };
-		values.soilTemp_max[1]  = { !r[ 6].is_null(), r[ 6].as<float>(0.f) };
-		values.soilTemp_max[2]  = { !r[ 7].is_null(), r[ 7].as<float>(0.f) };
-		values.soilTemp_max[3]  = { !r[ 8].is_null(), r[ 8].as<float>(0.f) };
-		values.extraTemp_max[0] = { !r[ 9].is_null(), r[ 9].as<float>(0.f) };
-		values.extraTemp_max[1] = { !r[10].is_null(), r[10].as<float>(0.f) };
-		values.extraTemp_max[2] = { !r[11].is_null(), r[11].as<float>(0.f) };
-		values.rainfall         = { !r[12].is_null(), r[12].as<float>(0.f) };
-		values.rainrate_max     = { !r[13].is_null(), r[13].as<float>(0.f) };
+		read6hTo6h(r, values);
 
 		tx.commit();
 		return true;
@@ -125,28 +240,21 @@ bool DbConnectionMinmax::getValues6hTo6h(const CassUuid& uuid, const date::sys_d
 
 bool DbConnectionMinmax::getValues18hTo18h(const CassUuid& uuid, const date::sys_days& date, DbConnectionMinmax::Values& values)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 
 	try {
 		char u[CASS_UUID_STRING_LENGTH];
 		cass_uuid_string(uuid, u);
+		QueryTrace trace{_pqConnections.metrics(SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL), &uuid};
 		pqxx::row r = tx.exec_prepared1(SELECT_VALUES_FROM_18H_TO_18H_POSTGRESQL,
 			u,
 			date::format("%F %T%z", date)
 		);
+		trace.addRow(r);
+		trace.stop();
 
-		values.insideTemp_min   = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
-		values.leafTemp_min[0]  = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
-		values.leafTemp_min[1]  = { !r[ 2].is_null(), r[ 2].as<float>(0.f) };
-		values.outsideTemp_min  = { !r[ 3].is_null() || !r[4].is_null(), r[4].as<float>(r[3].as<float>(0.0f)) };
-		values.soilTemp_min[0]  = { !r[ 5].is_null(), r[ 5].as<float>(0.f) };
-		values.soilTemp_min[1]  = { !r[ 6].is_null(), r[ 6].as<float>(0.f) };
-		values.soilTemp_min[2]  = { !r[ 7].is_null(), r[ 7].as<float>(0.f) };
-		values.soilTemp_min[3]  = { !r[ 8].is_null(), r[ 8].as<float>(0.f) };
-		values.extraTemp_min[0] = { !r[ 9].is_null(), r[ 9].as<float>(0.f) };
-		values.extraTemp_min[1] = { !r[10].is_null(), r[10].as<float>(0.f) };
-		values.extraTemp_min[2] = { !r[11].is_null(), r[11].as<float>(0.f) };
+		read18hTo18h(r, values);
 
 		tx.commit();
 		return true;
@@ -158,75 +266,21 @@ bool DbConnectionMinmax::getValues18hTo18h(const CassUuid& uuid, const date::sys
 
 bool DbConnectionMinmax::getValues0hTo0h(const CassUuid& uuid, const date::sys_days& date, DbConnectionMinmax::Values& values)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 
 	try {
 		char u[CASS_UUID_STRING_LENGTH];
 		cass_uuid_string(uuid, u);
+		QueryTrace trace{_pqConnections.metrics(SELECT_VALUES_ALL_DAY_POSTGRESQL), &uuid};
 		pqxx::row r = tx.exec_prepared1(SELECT_VALUES_ALL_DAY_POSTGRESQL,
 			u,
 			date::format("%F %T%z", date)
 		);
+		trace.addRow(r);
+		trace.stop();
 
-		values.barometer_min        = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
-		values.barometer_max        = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
-		values.barometer_avg        = { !r[ 2].is_null(), r[ 2].as<float>(0.f) };
-		values.leafWetnesses_min[0] = { !r[ 3].is_null(), r[ 3].as<float>(0.f) };
-		values.leafWetnesses_max[0] = { !r[ 4].is_null(), r[ 4].as<float>(0.f) };
-		values.leafWetnesses_avg[0] = { !r[ 5].is_null(), r[ 5].as<float>(0.f) };
-		values.leafWetnesses_min[1] = { !r[ 6].is_null(), r[ 6].as<float>(0.f) };
-		values.leafWetnesses_max[1] = { !r[ 7].is_null(), r[ 7].as<float>(0.f) };
-		values.leafWetnesses_avg[1] = { !r[ 8].is_null(), r[ 8].as<float>(0.f) };
-		values.soilMoistures_min[0] = { !r[ 9].is_null(), r[ 9].as<float>(0.f) };
-		values.soilMoistures_max[0] = { !r[10].is_null(), r[10].as<float>(0.f) };
-		values.soilMoistures_avg[0] = { !r[11].is_null(), r[11].as<float>(0.f) };
-		values.soilMoistures_min[1] = { !r[12].is_null(), r[12].as<float>(0.f) };
-		values.soilMoistures_max[1] = { !r[13].is_null(), r[13].as<float>(0.f) };
-		values.soilMoistures_avg[1] = { !r[14].is_null(), r[14].as<float>(0.f) };
-		values.soilMoistures_min[2] = { !r[15].is_null(), r[15].as<float>(0.f) };
-		values.soilMoistures_max[2] = { !r[16].is_null(), r[16].as<float>(0.f) };
-		values.soilMoistures_avg[2] = { !r[17].is_null(), r[17].as<float>(0.f) };
-		values.soilMoistures_min[3] = { !r[18].is_null(), r[18].as<float>(0.f) };
-		values.soilMoistures_max[3] = { !r[19].is_null(), r[19].as<float>(0.f) };
-		values.soilMoistures_avg[3] = { !r[20].is_null(), r[20].as<float>(0.f) };
-		values.insideHum_min        = { !r[21].is_null(), r[21].as<float>(0.f) };
-		values.insideHum_max        = { !r[22].is_null(), r[22].as<float>(0.f) };
-		values.insideHum_avg        = { !r[23].is_null(), r[23].as<float>(0.f) };
-		values.outsideHum_min       = { !r[24].is_null(), r[24].as<float>(0.f) };
-		values.outsideHum_max       = { !r[25].is_null(), r[25].as<float>(0.f) };
-		values.outsideHum_avg       = { !r[26].is_null(), r[26].as<float>(0.f) };
-		values.extraHum_min[0]      = { !r[27].is_null(), r[27].as<float>(0.f) };
-		values.extraHum_max[0]      = { !r[28].is_null(), r[28].as<float>(0.f) };
-		values.extraHum_avg[0]      = { !r[29].is_null(), r[29].as<float>(0.f) };
-		values.extraHum_min[1]      = { !r[30].is_null(), r[30].as<float>(0.f) };
-		values.extraHum_max[1]      = { !r[31].is_null(), r[31].as<float>(0.f) };
-		values.extraHum_avg[1]      = { !r[32].is_null(), r[32].as<float>(0.f) };
-		values.solarRad_max         = { !r[33].is_null(), r[33].as<float>(0.f) };
-		values.solarRad_avg         = { !r[34].is_null(), r[34].as<float>(0.f) };
-		values.uv_max               = { !r[35].is_null(), r[35].as<float>(0.f) };
-		values.uv_avg               = { !r[36].is_null(), r[36].as<float>(0.f) };
-		values.windgust_max         = { !r[37].is_null(), r[37].as<float>(0.f) };
-		values.windgust_avg         = { !r[38].is_null(), r[38].as<float>(0.f) };
-		values.windspeed_max        = { !r[39].is_null(), r[39].as<float>(0.f) };
-		values.windspeed_avg        = { !r[40].is_null(), r[40].as<float>(0.f) };
-		values.dewpoint_min         = { !r[41].is_null(), r[41].as<float>(0.f) };
-		values.dewpoint_max         = { !r[42].is_null(), r[42].as<float>(0.f) };
-		values.dewpoint_avg         = { !r[43].is_null(), r[43].as<float>(0.f) };
-		values.et                   = { !r[44].is_null(), r[44].as<float>(0.f) };
-		values.insolation_time      = { !r[45].is_null(), r[45].as<float>(0.f) };
-		if (!r[46].is_null() && (!values.rainfall.first || values.rainfall.second < r[46].as<float>(0.0f))) {
-			values.rainfall  = { true, r[46].as<float>(0.f) };
-		}
-		if (!r[47].is_null() && (!values.insolation_time.first || values.insolation_time.second < r[47].as<float>(0.0f))) {
-			values.insolation_time  = { true, r[47].as<float>(0.f) };
-		}
-		if (!r[48].is_null() && (!values.outsideTemp_max.first || values.outsideTemp_max.second < r[48].as<float>(0.0f))) {
-			values.outsideTemp_max  = { true, r[48].as<float>(0.f) };
-		}
-		if (!r[49].is_null() && (!values.outsideTemp_min.first || values.outsideTemp_min.second < r[49].as<float>(0.0f))) {
-			values.outsideTemp_min  = { true, r[49].as<float>(0.f) };
-		}
+		read0hTo0h(r, values);
 
 		tx.commit();
 		return true;
@@ -238,16 +292,19 @@ bool DbConnectionMinmax::getValues0hTo0h(const CassUuid& uuid, const date::sys_d
 
 bool DbConnectionMinmax::getYearlyValues(const CassUuid& uuid, const date::sys_days& date, std::pair<bool, float>& rain, std::pair<bool, float>& et)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 
 	try {
 		char u[CASS_UUID_STRING_LENGTH];
 		cass_uuid_string(uuid, u);
+		QueryTrace trace{_pqConnections.metrics(SELECT_YEARLY_VALUES_POSTGRESQL), &uuid};
 		pqxx::row r = tx.exec_prepared1(SELECT_YEARLY_VALUES_POSTGRESQL,
 			u,
 			date::format("%F", date)
 		);
+		trace.addRow(r);
+		trace.stop();
 
 		rain = { !r[0].is_null(), r[0].as<float>(0.f) };
 		et   = { !r[1].is_null(), r[1].as<float>(0.f) };
@@ -260,10 +317,204 @@ bool DbConnectionMinmax::getYearlyValues(const CassUuid& uuid, const date::sys_d
 	}
 }
 
+bool DbConnectionMinmax::getCumulativeValues(const CassUuid& uuid, const date::sys_days& date, Values& values)
+{
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
+
+	try {
+		char u[CASS_UUID_STRING_LENGTH];
+		cass_uuid_string(uuid, u);
+		QueryTrace trace{_pqConnections.metrics(SELECT_CUMULATIVE_VALUES_POSTGRESQL), &uuid};
+		pqxx::result result = tx.exec_prepared(SELECT_CUMULATIVE_VALUES_POSTGRESQL,
+			u,
+			date::format("%F", date)
+		);
+		trace.addResult(result);
+		trace.stop();
+
+		if (result.empty())
+			return false;
+		readCumulativeValues(result[0], values);
+
+		tx.commit();
+		return true;
+	} catch (const pqxx::pqxx_exception& e) {
+		std::cerr << e.base().what() << std::endl;
+		return false;
+	}
+}
+
+bool DbConnectionMinmax::getValuesForRange(const CassUuid& uuid, const date::sys_days& first, const date::sys_days& last, std::vector<Values>& values)
+{
+	values.clear();
+	if (last < first)
+		return true;
+	values.resize((last - first).count() + 1);
+
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
+
+	try {
+		char u[CASS_UUID_STRING_LENGTH];
+		cass_uuid_string(uuid, u);
+		std::string begin = date::format("%F %T%z", first);
+		std::string end = date::format("%F %T%z", last);
+
+		// The days without any observation in a window are absent from
+		// the result, their values are left null
+		auto readByDay = [&](const char* statement, int dayColumn, void (*read)(const pqxx::row&, Values&)) {
+			QueryTrace trace{_pqConnections.metrics(statement), &uuid};
+			pqxx::result result = tx.exec_prepared(statement, u, begin, end);
+			trace.addResult(result);
+			trace.stop();
+
+			for (const pqxx::row& r : result) {
+				date::sys_days day;
+				std::istringstream is{r[dayColumn].as<std::string>("")};
+				is >> date::parse("%F", day);
+				if (is.fail() || day < first || day > last)
+					continue;
+				read(r, values[(day - first).count()]);
+			}
+		};
+		readByDay(SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL, 14, &read6hTo6h);
+		readByDay(SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL, 12, &read18hTo18h);
+		readByDay(SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL, 50, &read0hTo0h);
+
+		QueryTrace trace{_pqConnections.metrics(SELECT_CUMULATIVE_VALUES_POSTGRESQL), &uuid};
+		pqxx::result result = tx.exec_prepared(SELECT_CUMULATIVE_VALUES_POSTGRESQL,
+			u,
+			date::format("%F", first - date::days{1})
+		);
+		trace.addResult(result);
+		trace.stop();
+
+		tx.commit();
+
+		Values previous;
+		if (!result.empty())
+			readCumulativeValues(result[0], previous);
+		chainCumulativeValues(first, result.empty() ? nullptr : &previous, values);
+		return true;
+	} catch (const pqxx::pqxx_exception& e) {
+		std::cerr << e.base().what() << std::endl;
+		return false;
+	}
+}
+
+bool DbConnectionMinmax::getValuesFromCassandra(const CassUuid& uuid, const date::sys_days& date, Values& values)
+{
+	DailyAggregator::Window6hTo6h from6h;
+	DailyAggregator::Window18hTo18h from18h;
+	DailyAggregator::Window0hTo0h allDay;
+	std::pair<bool, float> rainfall24 = { false, 0.f };
+	std::pair<bool, int> insolationTime24 = { false, 0 };
+	std::pair<bool, float> tx = { false, 0.f };
+	std::pair<bool, float> tn = { false, 0.f };
+
+	// The same observation is reused for all the rows, the fields read
+	// are overwritten each time
+	Observation obs;
+	auto handleResponse = [&](const CassRow* row) {
+		const CassValue* v = cass_row_get_column(row, 0);
+		cass_int64_t timeMillisec;
+		cass_value_get_int64(v, &timeMillisec);
+		date::sys_seconds t{std::chrono::seconds{timeMillisec / 1000}};
+
+		int column = 1;
+		storeCassandraFloat(row, column++, obs.insidetemp);
+		for (int i = 0 ; i < 2 ; i++)
+			storeCassandraFloat(row, column++, obs.leaftemp[i]);
+		storeCassandraFloat(row, column++, obs.outsidetemp);
+		storeCassandraFloat(row, column++, obs.max_outside_temperature);
+		storeCassandraFloat(row, column++, obs.min_outside_temperature);
+		for (int i = 0 ; i < 4 ; i++)
+			storeCassandraFloat(row, column++, obs.soiltemp[i]);
+		for (int i = 0 ; i < 3 ; i++)
+			storeCassandraFloat(row, column++, obs.extratemp[i]);
+		storeCassandraFloat(row, column++, obs.rainfall);
+		storeCassandraFloat(row, column++, obs.rainrate);
+		storeCassandraFloat(row, column++, obs.barometer);
+		for (int i = 0 ; i < 2 ; i++)
+			storeCassandraInt(row, column++, obs.leafwetnesses[i]);
+		for (int i = 0 ; i < 4 ; i++) {
+			// The soil moistures are integers in the database
+			std::pair<bool, int> moisture;
+			storeCassandraInt(row, column++, moisture);
+			obs.soilmoistures[i] = { moisture.first, float(moisture.second) };
+		}
+		storeCassandraInt(row, column++, obs.insidehum);
+		storeCassandraInt(row, column++, obs.outsidehum);
+		for (int i = 0 ; i < 2 ; i++)
+			storeCassandraInt(row, column++, obs.extrahum[i]);
+		storeCassandraInt(row, column++, obs.solarrad);
+		storeCassandraInt(row, column++, obs.uv);
+		storeCassandraFloat(row, column++, obs.windgust);
+		storeCassandraFloat(row, column++, obs.windspeed);
+		storeCassandraFloat(row, column++, obs.dewpoint);
+		storeCassandraFloat(row, column++, obs.et);
+		storeCassandraInt(row, column++, obs.insolation_time);
+		storeCassandraInt(row, column++, obs.winddir);
+
+		if (t > date + chrono::hours{6})
+			from6h.add(obs);
+		if (t < date + chrono::hours{18})
+			from18h.add(obs);
+		if (t >= date && t < date + chrono::hours{24}) {
+			allDay.add(obs);
+
+			std::pair<bool, float> f;
+			std::pair<bool, int> i;
+			storeCassandraFloat(row, column++, f);
+			computeMax(rainfall24, rainfall24, f);
+			storeCassandraInt(row, column++, i);
+			computeMax(insolationTime24, insolationTime24, i);
+			storeCassandraFloat(row, column++, f);
+			computeMax(tx, tx, f);
+			storeCassandraFloat(row, column++, f);
+			computeMin(tn, tn, f);
+		}
+	};
+
+	// The three partitions are read with the same bounds, each one is
+	// scanned only once
+	bool r = true;
+	for (date::sys_days day : { date - date::days{1}, date, date + date::days{1} }) {
+		if (!r)
+			break;
+		r = performSelect(_selectObservations,
+			handleResponse,
+			[&](CassStatement* stmt) {
+				cass_statement_bind_uuid(stmt, 0, uuid);
+				cass_statement_bind_uint32(stmt, 1, from_sysdays_to_CassandraDate(day));
+				cass_statement_bind_int64(stmt, 2, from_systime_to_CassandraDateTime(date - chrono::hours{6}));
+				cass_statement_bind_int64(stmt, 3, from_systime_to_CassandraDateTime(date + chrono::hours{30}));
+			},
+			&uuid
+		);
+	}
+	if (!r)
+		return false;
+
+	from6h.get(values);
+	from18h.get(values);
+	allDay.get(values);
+	// The cumulative values stored along the observations take
+	// precedence, like in read0hTo0h()
+	computeMax(values.rainfall, values.rainfall, rainfall24);
+	computeMax(values.insolation_time, values.insolation_time, insolationTime24);
+	computeMax(values.outsideTemp_max, values.outsideTemp_max, tx);
+	computeMin(values.outsideTemp_min, values.outsideTemp_min, tn);
+	return true;
+}
+
 bool DbConnectionMinmax::insertDataPoint(const CassUuid& station, const date::sys_days& date, const Values& values)
 {
 	CassFuture* query;
-	CassStatement* statement = cass_prepared_bind(_insertDataPoint.get());
+	CassStatement* statement = _insertDataPoint.bind();
+	if (!statement)
+		return false;
 	int param = 0;
 	auto ymd = year_month_day{date};
 	cass_statement_bind_uuid(statement,  param++, station);
@@ -333,7 +584,7 @@ bool DbConnectionMinmax::insertDataPoint(const CassUuid& station, const date::sy
 	bindCassandraFloat(statement, param++, values.windspeed_max);
 	bindCassandraFloat(statement, param++, values.windspeed_avg);
 	bindCassandraInt(statement, param++, values.insolation_time);
-	query = cass_session_execute(_session.get(), statement);
+	query = execute(_insertDataPoint, statement, &station);
 	cass_statement_free(statement);
 
 	const CassResult* result = cass_future_get_result(query);
@@ -352,8 +603,8 @@ bool DbConnectionMinmax::insertDataPoint(const CassUuid& station, const date::sy
 
 bool DbConnectionMinmax::insertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 	try {
 		doInsertDataPointInTimescaleDB(station, date, values, tx);
 		tx.commit();
@@ -364,10 +615,29 @@ bool DbConnectionMinmax::insertDataPointInTimescaleDB(const CassUuid& station, c
 	return true;
 }
 
+bool DbConnectionMinmax::insertDataPointsInTimescaleDB(const CassUuid& station, const date::sys_days& first, const std::vector<Values>& values)
+{
+	auto connection = _pqConnections.checkout();
+	try {
+		pqxx::work tx{*connection};
+		date::sys_days day = first;
+		for (const Values& v : values) {
+			doInsertDataPointInTimescaleDB(station, day, v, tx);
+			day += date::days{1};
+		}
+		tx.commit();
+	} catch (const pqxx::pqxx_exception& e) {
+		std::cerr << e.base().what() << std::endl;
+		return false;
+	}
+	return true;
+}
+
 void DbConnectionMinmax::doInsertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values, pqxx::transaction_base& tx)
 {
 	char uuid[CASS_UUID_STRING_LENGTH];
 	cass_uuid_string(station, uuid);
+	QueryTrace trace{_pqConnections.metrics(UPSERT_DATAPOINT_POSTGRESQL), &station};
 	tx.exec_prepared0(UPSERT_DATAPOINT_POSTGRESQL,
 		uuid,
 		date::format("%F", date),
@@ -457,6 +727,7 @@ void DbConnectionMinmax::doInsertDataPointInTimescaleDB(const CassUuid& station,
 		values.windspeed_avg.first ? &values.windspeed_avg.second : nullptr,
 		values.insolation_time.first ? &values.insolation_time.second : nullptr
 	);
+	trace.stop();
 }
 
 }
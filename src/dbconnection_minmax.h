@@ -40,7 +40,9 @@
 #include <pqxx/pqxx>
 
 #include "dbconnection_common.h"
+#include "minmax_storage.h"
 #include "cassandra_stmt_ptr.h"
+#include "pq_connection_pool.h"
 
 namespace meteodata {
 
@@ -111,7 +113,7 @@ inline std::pair<bool,T> computeMean(const std::pair<bool, T>& op1, const std::p
  * connector to query details about the station and insert measures in
  * the database periodically.
  */
-class DbConnectionMinmax : public DbConnectionCommon
+class DbConnectionMinmax : public DbConnectionCommon, public MinmaxStorage
 {
 public:
 	/**
@@ -119,96 +121,72 @@ public:
 	 *
 	 * @param user the username to use
 	 * @param password the password corresponding to the username
+	 * @param options the tuning of the Cassandra session, when to
+	 * prepare the statements and the maximum number of
+	 * connections to the PostgreSQL database
 	 */
 	DbConnectionMinmax(
 		const std::string& address = "127.0.0.1", const std::string& user = "", const std::string& password = "",
-		const std::string& pgAddress = "127.0.0.1", const std::string& pgUser = "", const std::string& pgPassword = ""
+		const std::string& pgAddress = "127.0.0.1", const std::string& pgUser = "", const std::string& pgPassword = "",
+		const ConnectionOptions& options = ConnectionOptions{}
 	);
 	/**
 	 * @brief Close the connection and destroy the database handle
 	 */
 	virtual ~DbConnectionMinmax() = default;
 
-	struct Values
-	{
-		// Values from 6h to 6h
-		std::pair<bool, float> insideTemp_max;
-		std::pair<bool, float> leafTemp_max[2];
-		std::pair<bool, float> outsideTemp_max;
-		std::pair<bool, float> soilTemp_max[4];
-		std::pair<bool, float> extraTemp_max[3];
-		std::pair<bool, float> rainfall;
-
-		// Values from 18h to 18h
-		std::pair<bool, float> insideTemp_min;
-		std::pair<bool, float> leafTemp_min[2];
-		std::pair<bool, float> outsideTemp_min;
-		std::pair<bool, float> soilTemp_min[4];
-		std::pair<bool, float> extraTemp_min[3];
-
-		// Values from 0h to 0h
-		std::pair<bool, float> barometer_min;
-		std::pair<bool, float> barometer_max;
-		std::pair<bool, float> barometer_avg;
-		std::pair<bool, int> leafWetnesses_min[2];
-		std::pair<bool, int> leafWetnesses_max[2];
-		std::pair<bool, int> leafWetnesses_avg[2];
-		std::pair<bool, int> soilMoistures_min[4];
-		std::pair<bool, int> soilMoistures_max[4];
-		std::pair<bool, int> soilMoistures_avg[4];
-		std::pair<bool, int> insideHum_min;
-		std::pair<bool, int> insideHum_max;
-		std::pair<bool, int> insideHum_avg;
-		std::pair<bool, int> outsideHum_min;
-		std::pair<bool, int> outsideHum_max;
-		std::pair<bool, int> outsideHum_avg;
-		std::pair<bool, int> extraHum_min[2];
-		std::pair<bool, int> extraHum_max[2];
-		std::pair<bool, int> extraHum_avg[2];
-		std::pair<bool, int> solarRad_max;
-		std::pair<bool, int> solarRad_avg;
-		std::pair<bool, int> uv_max;
-		std::pair<bool, int> uv_avg;
-		std::pair<bool, std::vector<int>> winddir;
-		std::pair<bool, float> windgust_max;
-		std::pair<bool, float> windgust_avg;
-		std::pair<bool, float> windspeed_max;
-		std::pair<bool, float> windspeed_avg;
-		std::pair<bool, float> rainrate_max;
-		std::pair<bool, float> dewpoint_min;
-		std::pair<bool, float> dewpoint_max;
-		std::pair<bool, float> dewpoint_avg;
-		std::pair<bool, float> et;
-		std::pair<bool, int> insolation_time;
-
-		// Computed values
-		std::pair<bool, float> dayRain;
-		std::pair<bool, float> monthRain;
-		std::pair<bool, float> yearRain;
-		std::pair<bool, float> dayEt;
-		std::pair<bool, float> monthEt;
-		std::pair<bool, float> yearEt;
-		std::pair<bool, float> insideTemp_avg;
-		std::pair<bool, float> leafTemp_avg[4];
-		std::pair<bool, float> outsideTemp_avg;
-		std::pair<bool, float> soilTemp_avg[4];
-		std::pair<bool, float> extraTemp_avg[3];
-	};
-
-	bool insertDataPoint(const CassUuid& station, const date::sys_days& date, const Values& values);
-
-	bool getValues6hTo6h(const CassUuid& station, const date::sys_days& date, Values& values);
-	bool getValues18hTo18h(const CassUuid& station, const date::sys_days& date, Values& values);
-	bool getValues0hTo0h(const CassUuid& station, const date::sys_days& date, Values& values);
-	bool getYearlyValues(const CassUuid& station, const date::sys_days& date, std::pair<bool, float>& rain, std::pair<bool, float>& et);
-
-	bool insertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values);
+	using Values = MinmaxStorage::Values;
+
+	bool insertDataPoint(const CassUuid& station, const date::sys_days& date, const Values& values) override;
+
+	bool getValues6hTo6h(const CassUuid& station, const date::sys_days& date, Values& values) override;
+	bool getValues18hTo18h(const CassUuid& station, const date::sys_days& date, Values& values) override;
+	bool getValues0hTo0h(const CassUuid& station, const date::sys_days& date, Values& values) override;
+	bool getYearlyValues(const CassUuid& station, const date::sys_days& date, std::pair<bool, float>& rain, std::pair<bool, float>& et) override;
+	bool getCumulativeValues(const CassUuid& station, const date::sys_days& date, Values& values) override;
+
+	/**
+	 * @brief Compute the values of all the days from \a first to \a last,
+	 * both included, with one query per kind of window for the whole
+	 * range instead of one query per window and per day
+	 *
+	 * @param[out] values The values, one per day, the first one being the
+	 * values of \a first
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	bool getValuesForRange(const CassUuid& station, const date::sys_days& first, const date::sys_days& last, std::vector<Values>& values) override;
+
+	/**
+	 * @brief Compute the values of a day from the observations stored in
+	 * Cassandra, with one scan of each day partition
+	 *
+	 * The observations from 18h the day before to 6h the day after are
+	 * fetched and all the windows are aggregated client-side, instead of
+	 * running the five aggregation queries of the windows, which read
+	 * the partition of \a date three times. The windows have the same
+	 * boundaries as these queries: (6h, 6h the day after], [18h the day
+	 * before, 18h) and [0h, 0h the day after).
+	 *
+	 * Only the daily values are computed, the monthly and yearly ones are
+	 * left untouched.
+	 *
+	 * @param station The station's UUID
+	 * @param date The day
+	 * @param[out] values The values of the day
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	bool getValuesFromCassandra(const CassUuid& station, const date::sys_days& date, Values& values);
+
+	bool insertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values) override;
+	bool insertDataPointsInTimescaleDB(const CassUuid& station, const date::sys_days& first, const std::vector<Values>& values) override;
 	template<typename I>
 	bool insertDataPointsInTimescaleDB(const CassUuid& station, I begin, I end)
 	{
-		std::lock_guard<std::mutex> mutexed{_pqTransactionMutex};
+		auto connection = _pqConnections.checkout();
 		try {
-			pqxx::work tx{_pqConnection};
+			pqxx::work tx{*connection};
 			for (I it = begin ; it != end ; ++it) {
 				doInsertDataPointInTimescaleDB(station, it->first, it->second, tx);
 			}
@@ -447,6 +425,31 @@ private:
 	CassandraStmtPtr _selectValuesBefore6h;
 	CassandraStmtPtr _selectValuesBefore18h;
 
+	/*
+	 * The observations aggregated client-side by getValuesFromCassandra(),
+	 * the columns are read by position
+	 */
+	static constexpr char SELECT_OBSERVATIONS_STMT[] =
+		"SELECT time,"
+			"insidetemp, leaftemp1, leaftemp2, outsidetemp,"
+			"max_outside_temperature, min_outside_temperature,"
+			"soiltemp1, soiltemp2, soiltemp3, soiltemp4,"
+			"extratemp1, extratemp2, extratemp3,"
+			"rainfall, rainrate, barometer,"
+			"leafwetnesses1, leafwetnesses2,"
+			"soilmoistures1, soilmoistures2, soilmoistures3, soilmoistures4,"
+			"insidehum, outsidehum, extrahum1, extrahum2,"
+			"solarrad, uv, windgust, windspeed, dewpoint, et, insolation_time,"
+			"winddir,"
+			"rainfall24, insolation_time24, tx, tn"
+			" FROM meteodata_v2.meteo WHERE station = ? AND day = ? AND time >= ? AND time <= ?";
+
+	/**
+	 * @brief The prepared statement for the getValuesFromCassandra()
+	 * method
+	 */
+	CassandraStmtPtr _selectObservations;
+
 	static constexpr char SELECT_YEARLY_VALUES_STMT[] =
 		"SELECT yearrain,yearet FROM meteodata_v2.minmax WHERE station = ? AND monthyear = ? AND day = ?";
 	static constexpr char SELECT_YEARLY_VALUES_POSTGRESQL[] = "select_yearly_values";
@@ -455,6 +458,112 @@ private:
 
 	CassandraStmtPtr _selectYearlyValues;
 
+	static constexpr char SELECT_CUMULATIVE_VALUES_POSTGRESQL[] = "select_cumulative_values";
+	static constexpr char SELECT_CUMULATIVE_VALUES_POSTGRESQL_STMT[] =
+		"SELECT monthrain,monthet,yearrain,yearet FROM meteodata.minmax WHERE station = $1 AND day = $2";
+
+	/*
+	 * The statements for getValuesForRange() have the same columns as
+	 * the ones for a single day, plus the day each group of observations
+	 * is attributed to in last position
+	 */
+	static constexpr char SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL[] = "select_values_from_6h_to_6h_by_day";
+	static constexpr char SELECT_VALUES_FROM_6H_TO_6H_BY_DAY_POSTGRESQL_STMT[] =
+		"SELECT "
+			"MAX(insidetemp)     AS insideTemp_max,"
+			"MAX(leaftemp1)      AS leafTemp1_max,"
+			"MAX(leaftemp2)      AS leafTemp2_max,"
+			"MAX(outsidetemp)    AS outsideTemp_max,"
+			"MAX(max_outside_temperature)    AS real_outsideTemp_max,"
+			"MAX(soiltemp1)      AS soilTemp1_max,"
+			"MAX(soiltemp2)      AS soilTemp2_max,"
+			"MAX(soiltemp3)      AS soilTemp3_max,"
+			"MAX(soiltemp4)      AS soilTemp4_max,"
+			"MAX(extratemp1)     AS extraTemp1_max,"
+			"MAX(extratemp2)     AS extraTemp2_max,"
+			"MAX(extratemp3)     AS extraTemp3_max,"
+			"SUM(rainfall)       AS rainfall,"
+			"MAX(rainrate)       AS rainrate_max,"
+			"((datetime AT TIME ZONE 'UTC') - INTERVAL 'PT6H')::date AS day"
+			" FROM meteodata.observations WHERE station = $1 AND datetime >= ($2::timestamptz + INTERVAL 'PT6H') AND datetime < ($3::timestamptz + INTERVAL 'PT30H')"
+			" GROUP BY day";
+
+	static constexpr char SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL[] = "select_values_from_18h_to_18h_by_day";
+	static constexpr char SELECT_VALUES_FROM_18H_TO_18H_BY_DAY_POSTGRESQL_STMT[] =
+		"SELECT "
+			"MIN(insidetemp)     AS insideTemp_min,"
+			"MIN(leaftemp1)      AS leafTemp1_min,"
+			"MIN(leaftemp2)      AS leafTemp2_min,"
+			"MIN(outsidetemp)    AS outsideTemp_min,"
+			"MIN(min_outside_temperature)    AS real_outsideTemp_min,"
+			"MIN(soiltemp1)      AS soilTemp1_min,"
+			"MIN(soiltemp2)      AS soilTemp2_min,"
+			"MIN(soiltemp3)      AS soilTemp3_min,"
+			"MIN(soiltemp4)      AS soilTemp4_min,"
+			"MIN(extratemp1)     AS extraTemp1_min,"
+			"MIN(extratemp2)     AS extraTemp2_min,"
+			"MIN(extratemp3)     AS extraTemp3_min,"
+			"((datetime AT TIME ZONE 'UTC') + INTERVAL 'PT6H')::date AS day"
+			" FROM meteodata.observations WHERE station = $1 AND datetime >= ($2::timestamptz - INTERVAL 'PT6H') AND datetime < ($3::timestamptz + INTERVAL 'PT18H')"
+			" GROUP BY day";
+
+	static constexpr char SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL[] = "select_values_all_day_by_day";
+	static constexpr char SELECT_VALUES_ALL_DAY_BY_DAY_POSTGRESQL_STMT[] =
+		"SELECT "
+			"MIN(barometer)          AS barometer_min,"
+			"MAX(barometer)          AS barometer_max,"
+			"AVG(barometer)          AS barometer_avg,"
+			"MIN(leafwetnesses1)     AS leafWetnesses1_min,"
+			"MAX(leafwetnesses1)     AS leafWetnesses1_max,"
+			"AVG(leafwetnesses1)     AS leafWetnesses1_avg,"
+			"MIN(leafwetnesses2)     AS leafWetnesses2_min,"
+			"MAX(leafwetnesses2)     AS leafWetnesses2_max,"
+			"AVG(leafwetnesses2)     AS leafWetnesses2_avg,"
+			"MIN(soilmoistures1)     AS soilMoistures1_min,"
+			"MAX(soilmoistures1)     AS soilMoistures1_max,"
+			"AVG(soilmoistures1)     AS soilMoistures1_avg,"
+			"MIN(soilmoistures2)     AS soilMoistures2_min,"
+			"MAX(soilmoistures2)     AS soilMoistures2_max,"
+			"AVG(soilmoistures2)     AS soilMoistures2_avg,"
+			"MIN(soilmoistures3)     AS soilMoistures3_min,"
+			"MAX(soilmoistures3)     AS soilMoistures3_max,"
+			"AVG(soilmoistures3)     AS soilMoistures3_avg,"
+			"MIN(soilmoistures4)     AS soilMoistures4_min,"
+			"MAX(soilmoistures4)     AS soilMoistures4_max,"
+			"AVG(soilmoistures4)     AS soilMoistures4_avg,"
+			"MIN(insidehum)          AS insideHum_min,"
+			"MAX(insidehum)          AS insideHum_max,"
+			"AVG(insidehum)          AS insideHum_avg,"
+			"MIN(outsidehum)         AS outsideHum_min,"
+			"MAX(outsidehum)         AS outsideHum_max,"
+			"AVG(outsidehum)         AS outsideHum_avg,"
+			"MIN(extrahum1)          AS extraHum1_min,"
+			"MAX(extrahum1)          AS extraHum1_max,"
+			"AVG(extrahum1)          AS extraHum1_avg,"
+			"MIN(extrahum2)          AS extraHum2_min,"
+			"MAX(extrahum2)          AS extraHum2_max,"
+			"AVG(extrahum2)          AS extraHum2_avg,"
+			"MAX(solarrad)           AS solarRad_max,"
+			"AVG(solarrad)           AS solarRad_avg,"
+			"MAX(uv)                 AS uv_max,"
+			"AVG(uv)                 AS uv_avg,"
+			"MAX(windgust)           AS windgust_max,"
+			"AVG(windgust)           AS windgust_avg,"
+			"MAX(windspeed)          AS windspeed_max,"
+			"AVG(windspeed)          AS windspeed_avg,"
+			"MIN(dewpoint)           AS dewpoint_min,"
+			"MAX(dewpoint)           AS dewpoint_max,"
+			"AVG(dewpoint)           AS dewpoint_avg,"
+			"SUM(et)                 AS et,"
+			"SUM(insolation_time)    AS insolation_time,"
+			"MAX(rainfall24)         AS rainfall24,"
+			"MAX(insolation_time24)  AS insolation_time24,"
+			"MAX(tx)                 AS tx,"
+			"MIN(tn)                 AS tn,"
+			"(datetime AT TIME ZONE 'UTC')::date AS day"
+			" FROM meteodata.observations WHERE station = $1 AND datetime >= $2::timestamptz AND datetime < ($3::timestamptz + INTERVAL 'PT24H')"
+			" GROUP BY day";
+
 	static constexpr char INSERT_DATAPOINT_STMT[] =
 		"INSERT INTO meteodata_v2.minmax ("
 		"station,"
@@ -697,11 +806,23 @@ private:
 	 */
 	void prepareStatements();
 
-	pqxx::connection _pqConnection;
-
-	std::mutex _pqTransactionMutex;
+	/**
+	 * @brief The pool of connections to the PostgreSQL database
+	 */
+	PqConnectionPool _pqConnections;
 
 	void doInsertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values, pqxx::transaction_base& tx);
+
+	/**
+	 * @brief Read the result of the queries over the windows from 6h to
+	 * 6h, from 18h to 18h, and from 0h to 0h
+	 *
+	 * The values from 0h to 0h must be read last since they are
+	 * compared to the ones of the other windows.
+	 */
+	static void read6hTo6h(const pqxx::row& r, Values& values);
+	static void read18hTo18h(const pqxx::row& r, Values& values);
+	static void read0hTo0h(const pqxx::row& r, Values& values);
 };
 }
 
@@ -35,6 +35,7 @@
 #include "dbconnection_month_minmax.h"
 #include "dbconnection_common.h"
 #include "cassandra_stmt_ptr.h"
+#include "query_observer.h"
 
 using namespace date;
 
@@ -51,36 +52,41 @@ namespace chrono = std::chrono;
 
 DbConnectionMonthMinmax::DbConnectionMonthMinmax(
 		const std::string& address, const std::string& user, const std::string& password,
-		const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword
+		const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword,
+		const ConnectionOptions& options
 	):
-	DbConnectionCommon(address, user, password),
-	_pqConnection{"host=" + pgAddress + " user=" + pgUser + " password=" + pgPassword + " dbname=meteodata"}
+	DbConnectionCommon(address, user, password, options),
+	_pqConnections{"host=" + pgAddress + " user=" + pgUser + " password=" + pgPassword + " dbname=meteodata", options.pgPoolSize}
 {
 	DbConnectionMonthMinmax::prepareStatements();
+	waitForPreparedStatements();
 }
 
 void DbConnectionMonthMinmax::prepareStatements()
 {
-	prepareOneStatement(_selectDailyValues, SELECT_DAILY_VALUES_STMT);
-	prepareOneStatement(_insertDataPoint, INSERT_DATAPOINT_STMT);
-	_pqConnection.prepare(SELECT_DAILY_VALUES_POSTGRESQL, SELECT_DAILY_VALUES_POSTGRESQL_STMT);
-	_pqConnection.prepare(UPSERT_DATAPOINT_POSTGRESQL, UPSERT_DATAPOINT_POSTGRESQL_STMT);
+	prepareOneStatement(_selectDailyValues, "month_minmax_select_daily_values", SELECT_DAILY_VALUES_STMT);
+	prepareOneStatement(_insertDataPoint, "month_minmax_insert_data_point", INSERT_DATAPOINT_STMT);
+	_pqConnections.prepare(SELECT_DAILY_VALUES_POSTGRESQL, SELECT_DAILY_VALUES_POSTGRESQL_STMT);
+	_pqConnections.prepare(UPSERT_DATAPOINT_POSTGRESQL, UPSERT_DATAPOINT_POSTGRESQL_STMT);
 }
 
 bool DbConnectionMonthMinmax::getDailyValues(const CassUuid& uuid, int year, int month, DbConnectionMonthMinmax::Values& values)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 
 	try {
 		char u[CASS_UUID_STRING_LENGTH];
 		cass_uuid_string(uuid, u);
 		char date[11];
 		sprintf(date, "%04d-%02d-01", year, month);
+		QueryTrace trace{_pqConnections.metrics(SELECT_DAILY_VALUES_POSTGRESQL), &uuid};
 		pqxx::row r = tx.exec_prepared1(SELECT_DAILY_VALUES_POSTGRESQL,
 			u,
 			date
 		);
+		trace.addRow(r);
+		trace.stop();
 
 		values.outsideTemp_avg     = { !r[ 0].is_null(), r[ 0].as<float>(0.f) };
 		values.outsideTemp_max_max = { !r[ 1].is_null(), r[ 1].as<float>(0.f) };
@@ -116,7 +122,9 @@ bool DbConnectionMonthMinmax::getDailyValues(const CassUuid& uuid, int year, int
 bool DbConnectionMonthMinmax::insertDataPoint(const CassUuid& station, int year, int month, const Values& values)
 {
 	CassFuture* query;
-	CassStatement* statement = cass_prepared_bind(_insertDataPoint.get());
+	CassStatement* statement = _insertDataPoint.bind();
+	if (!statement)
+		return false;
 	int param = 0;
 	cass_statement_bind_uuid(statement,  param++, station);
 	cass_statement_bind_int32(statement, param++, year);
@@ -148,7 +156,7 @@ bool DbConnectionMonthMinmax::insertDataPoint(const CassUuid& station, int year,
 	bindCassandraFloat(statement, param++, values.diff_outsideTemp_max_max);
 	bindCassandraFloat(statement, param++, values.diff_rainfall);
 	bindCassandraFloat(statement, param++, values.diff_insolationTime);
-	query = cass_session_execute(_session.get(), statement);
+	query = execute(_insertDataPoint, statement, &station);
 	cass_statement_free(statement);
 
 	const CassResult* result = cass_future_get_result(query);
@@ -167,8 +175,8 @@ bool DbConnectionMonthMinmax::insertDataPoint(const CassUuid& station, int year,
 
 bool DbConnectionMonthMinmax::insertDataPointInTimescaleDB(const CassUuid& station, const date::year_month& yearmonth, const Values& values)
 {
-	std::lock_guard locked{_pqTransactionMutex};
-	pqxx::work tx{_pqConnection};
+	auto connection = _pqConnections.checkout();
+	pqxx::work tx{*connection};
 	try {
 		doInsertDataPointInTimescaleDB(station, yearmonth, values, tx);
 		tx.commit();
@@ -183,6 +191,7 @@ void DbConnectionMonthMinmax::doInsertDataPointInTimescaleDB(const CassUuid& sta
 {
 	char uuid[CASS_UUID_STRING_LENGTH];
 	cass_uuid_string(station, uuid);
+	QueryTrace trace{_pqConnections.metrics(UPSERT_DATAPOINT_POSTGRESQL), &station};
 	tx.exec_prepared0(UPSERT_DATAPOINT_POSTGRESQL,
 		uuid,
 		date::format("%Y-%m-01", yearmonth),
@@ -214,6 +223,7 @@ void DbConnectionMonthMinmax::doInsertDataPointInTimescaleDB(const CassUuid& sta
 		values.diff_rainfall.first ? &values.diff_rainfall.second : nullptr,
 		values.diff_insolationTime.first ? &values.diff_insolationTime.second : nullptr
 	);
+	trace.stop();
 }
 
 }
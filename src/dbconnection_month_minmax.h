@@ -39,6 +39,7 @@
 
 #include "dbconnection_common.h"
 #include "cassandra_stmt_ptr.h"
+#include "pq_connection_pool.h"
 
 namespace meteodata {
 
@@ -57,10 +58,14 @@ class DbConnectionMonthMinmax : public DbConnectionCommon
 		 *
 		 * @param user the username to use
 		 * @param password the password corresponding to the username
+		 * @param options the tuning of the Cassandra session, when to
+		 * prepare the statements and the maximum number of
+		 * connections to the PostgreSQL database
 		 */
 		DbConnectionMonthMinmax(
 			const std::string& address = "127.0.0.1", const std::string& user = "", const std::string& password = "",
-			const std::string& pgAddress = "127.0.0.1", const std::string& pgUser = "", const std::string& pgPassword = ""
+			const std::string& pgAddress = "127.0.0.1", const std::string& pgUser = "", const std::string& pgPassword = "",
+			const ConnectionOptions& options = ConnectionOptions{}
 		);
 		/**
 		 * @brief Close the connection and destroy the database handle
@@ -112,9 +117,9 @@ class DbConnectionMonthMinmax : public DbConnectionCommon
 		template<typename I>
 		bool insertDataPointsInTimescaleDB(const CassUuid& station, I begin, I end)
 		{
-			std::lock_guard<std::mutex> mutexed{_pqTransactionMutex};
+			auto connection = _pqConnections.checkout();
 			try {
-				pqxx::work tx{_pqConnection};
+				pqxx::work tx{*connection};
 				for (I it = begin ; it != end ; ++it) {
 					doInsertDataPointInTimescaleDB(station, it->first, it->second, tx);
 				}
@@ -351,9 +356,10 @@ class DbConnectionMonthMinmax : public DbConnectionCommon
 		 */
 		void prepareStatements();
 
-		pqxx::connection _pqConnection;
-
-		std::mutex _pqTransactionMutex;
+		/**
+		 * @brief The pool of connections to the PostgreSQL database
+		 */
+		PqConnectionPool _pqConnections;
 
 		void doInsertDataPointInTimescaleDB(const CassUuid& station, const date::year_month& yearmonth, const Values& values, pqxx::transaction_base& tx);
 };
@@ -35,6 +35,7 @@
 #include <cassandra.h>
 
 #include "dbconnection_normals.h"
+#include "query_observer.h"
 
 namespace meteodata {
 
@@ -82,10 +83,12 @@ void DbConnectionNormals::prepareStatements()
 	_getStationsWithNormalsNearbyStmt.reset(mysql_stmt_init(_db.get()));
 	if (mysql_stmt_prepare(_getStationsWithNormalsNearbyStmt.get(), GET_STATIONS_WITH_NORMALS_NEARBY, sizeof(GET_STATIONS_WITH_NORMALS_NEARBY)))
 		panic("Could not prepare statement \"getStationsWithNormalsNearby\"");
+	_getStationsWithNormalsNearbyMetrics = &StatementMetrics::series(StatementMetrics::Backend::MYSQL, "getStationsWithNormalsNearby");
 
 	_getNormalsStmt.reset(mysql_stmt_init(_db.get()));
 	if (mysql_stmt_prepare(_getNormalsStmt.get(), GET_NORMALS, sizeof(GET_NORMALS)))
 		panic("Could not prepare statement \"getNormals\"");
+	_getNormalsMetrics = &StatementMetrics::series(StatementMetrics::Backend::MYSQL, "getNormals");
 }
 
 std::vector<Neighbor> DbConnectionNormals::getStationsWithNormalsNearby(const CassUuid& uuid)
@@ -106,7 +109,10 @@ std::vector<Neighbor> DbConnectionNormals::getStationsWithNormalsNearby(const Ca
 
 	if (mysql_stmt_bind_param(stmt, params))
 		panic(stmt, "Failed to bind params in statement \"getStationsWithNormalsNearby\"");
-	if (mysql_stmt_execute(stmt))
+	QueryTrace trace{*_getStationsWithNormalsNearbyMetrics, &uuid};
+	bool failed = mysql_stmt_execute(stmt);
+	trace.stop(!failed);
+	if (failed)
 		panic(stmt, "Failed to execute statement \"getStationsWithNormalsNearby\"");
 
 	constexpr int NB_PARAMS = 5;
@@ -215,7 +221,10 @@ void DbConnectionNormals::doGetNormals(int id, Values& normals, unsigned period)
 
 	if (mysql_stmt_bind_param(stmt, params))
 		panic(stmt, "Failed to bind params in statement \"getNormals\"");
-	if (mysql_stmt_execute(stmt))
+	QueryTrace trace{*_getNormalsMetrics};
+	bool failed = mysql_stmt_execute(stmt);
+	trace.stop(!failed);
+	if (failed)
 		panic(stmt, "Failed to execute statement \"getNormals\"");
 
 	constexpr int NB_PARAMS = 27;
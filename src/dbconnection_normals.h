@@ -34,6 +34,8 @@
 #include <mysql.h>
 #include <date/date.h>
 
+#include "statement_metrics.h"
+
 namespace meteodata {
 
 /**
@@ -128,6 +130,7 @@ private:
 				" s2.latitude < s1.latitude + 2 "
 			" ORDER BY distance LIMIT ?";
 	std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)> _getStationsWithNormalsNearbyStmt;
+	StatementMetrics::Series* _getStationsWithNormalsNearbyMetrics = nullptr;
 
 	static constexpr char GET_NORMALS[] =
 		"SELECT "
@@ -161,6 +164,7 @@ private:
 		" FROM monthly_normals "
 		" WHERE station_id = ? AND month = ?";
 	std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)> _getNormalsStmt;
+	StatementMetrics::Series* _getNormalsMetrics = nullptr;
 
 	void prepareStatements();
 	void panic(const std::string& msg);
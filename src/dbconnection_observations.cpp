@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <exception>
@@ -31,6 +32,11 @@
 #include <map>
 #include <optional>
 #include <mutex>
+#include <future>
+#include <deque>
+#include <algorithm>
+#include <type_traits>
+#include <tuple>
 
 #include <cassandra.h>
 #include <syslog.h>
@@ -41,9 +47,12 @@
 #include "dbconnection_observations.h"
 #include "observation.h"
 #include "map_observation.h"
+#include "daily_aggregator.h"
+#include "map_aggregator.h"
 #include "cassandra_stmt_ptr.h"
 #include "virtual_station.h"
 #include "download.h"
+#include "query_observer.h"
 
 namespace meteodata {
 	const std::string DbConnectionObservations::UPSERT_OBSERVATION = "upsert_observation";
@@ -81,58 +90,99 @@ namespace meteodata {
 	const std::string DbConnectionObservations::INSERT_DOWNLOAD = "insert_download";
 	const std::string DbConnectionObservations::UPDATE_DOWNLOAD_STATUS = "update_download_status";
 	const std::string DbConnectionObservations::SELECT_DOWNLOADS_BY_STATION = "select_downloads_by_station";
+	const std::string DbConnectionObservations::COPY_OBSERVATIONS = "copy_observations";
+	const std::string DbConnectionObservations::MERGE_OBSERVATIONS = "merge_observations";
+	const std::string DbConnectionObservations::OBSERVATIONS_STAGING_TABLE = "observations_staging";
+	const std::vector<std::string> DbConnectionObservations::OBSERVATIONS_COLUMNS = {
+		"station",
+		"datetime",
+		"barometer",
+		"dewpoint",
+		"extrahum1", "extrahum2",
+		"extratemp1", "extratemp2", "extratemp3",
+		"heatindex",
+		"insidehum", "insidetemp",
+		"leaftemp1", "leaftemp2",
+		"leafwetnesses1", "leafwetnesses2",
+		"outsidehum", "outsidetemp",
+		"rainrate", "rainfall",
+		"et",
+		"soilmoistures1", "soilmoistures2", "soilmoistures3", "soilmoistures4",
+		"soiltemp1", "soiltemp2", "soiltemp3", "soiltemp4",
+		"solarrad",
+		"thswindex",
+		"uv",
+		"windchill",
+		"winddir", "windgust", "min_windspeed", "windspeed",
+		"insolation_time",
+		"min_outside_temperature", "max_outside_temperature",
+		"leafwetnesses_timeratio1",
+		"soilmoistures10cm", "soilmoistures20cm", "soilmoistures30cm",
+		"soilmoistures40cm", "soilmoistures50cm", "soilmoistures60cm",
+		"soiltemp10cm", "soiltemp20cm", "soiltemp30cm",
+		"soiltemp40cm", "soiltemp50cm", "soiltemp60cm",
+		"leaf_wetness_percent1",
+		"soil_conductivity1",
+		"voltage_battery", "voltage_solar_panel", "voltage_backup"
+	};
 
 	DbConnectionObservations::DbConnectionObservations(
 			const std::string& address, const std::string& user, const std::string& password,
-			const std::string& pqaddress, const std::string& pquser, const std::string& pqpassword) :
-		DbConnectionCommon(address, user, password),
-		_pqConnection{"host=" + pqaddress + " user=" + pquser + " password=" + pqpassword + " dbname=meteodata"}
+			const std::string& pqaddress, const std::string& pquser, const std::string& pqpassword,
+			const ConnectionOptions& options) :
+		DbConnectionCommon(address, user, password, options),
+		_pqConnections{"host=" + pqaddress + " user=" + pquser + " password=" + pqpassword + " dbname=meteodata", options.pgPoolSize},
+		_cachedValues{[this](const std::vector<StationValueCache::Write>& writes) { return writeCachedValues(writes); }},
+		_rainfallRollups{[this](const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end) {
+			return updateRainfallRollup(station, begin, end);
+		}}
 	{
 		DbConnectionObservations::prepareStatements();
+		waitForPreparedStatements();
 	}
 
 	void DbConnectionObservations::prepareStatements()
 	{
-		prepareOneStatement(_selectStationByCoords,
+		prepareOneStatement(_selectStationByCoords, "select_station_by_coords",
 			"SELECT station FROM meteodata.coordinates "
 			"WHERE elevation = ? AND latitude = ? AND longitude = ?"
 		);
 
-		_pqConnection.prepare(SELECT_STATION_BY_COORDS,
+		_pqConnections.prepare(SELECT_STATION_BY_COORDS,
 			"SELECT c.station FROM meteodata.connectors c "
 			"WHERE c.connector='coords' AND c.param @> jsonb_build_object('latitude',$1,'longitude',$2,'elevation',$3)"
 		);
 
-		prepareOneStatement(_selectStationCoordinates,
+		prepareOneStatement(_selectStationCoordinates, "select_station_coordinates",
 			"SELECT latitude,longitude,elevation,name,polling_period FROM meteodata.stations "
 			"WHERE id = ?"
 		);
 
-		_pqConnection.prepare(SELECT_STATION_COORDINATES,
+		_pqConnections.prepare(SELECT_STATION_COORDINATES,
 			"SELECT s.latitude,s.longitude,s.elevation,s.name,sp.value AS polling_period "
 			"FROM meteodata.stations s, meteodata.station_properties sp "
 			"WHERE s.id = $1 AND sp.station_id = s.id AND sp.property_type_name = 'polling_period' AND sp.enabled = 1"
 		);
 
-		prepareOneStatement(_selectAllIcaos,
+		prepareOneStatement(_selectAllIcaos, "select_all_icaos",
 			"SELECT id,icao,active FROM meteodata.stationsfr"
 		);
 
-		_pqConnection.prepare(SELECT_ALL_ICAOS,
+		_pqConnections.prepare(SELECT_ALL_ICAOS,
 			"SELECT station AS id, (param #>> '{icao}') AS icao, active "
 			"FROM meteodata.connectors WHERE connector = 'meteofrance'"
 		);
 
-		prepareOneStatement(_selectDeferredSynops,
+		prepareOneStatement(_selectDeferredSynops, "select_deferred_synops",
 			"SELECT uuid,icao FROM meteodata.deferred_synops"
 		);
 
-		_pqConnection.prepare(SELECT_DEFERRED_SYNOPS,
+		_pqConnections.prepare(SELECT_DEFERRED_SYNOPS,
 			"SELECT station AS uuid, (param #>> '{icao}') AS icao, active "
 			"FROM meteodata.connectors WHERE connector = 'deferred_synop' AND active = true"
 		);
 
-		prepareOneStatement(_selectLastDataBefore,
+		prepareOneStatement(_selectLastDataBefore, "select_last_data_before",
 			"SELECT "
 			"station,"
 			"day, time,"
@@ -169,7 +219,7 @@ namespace meteodata {
 			" AND day = ? AND time <= ? ORDER BY time DESC LIMIT 1"
 		);
 
-		prepareOneStatement(_selectMapValues,
+		prepareOneStatement(_selectMapValues, "select_map_values",
 			"SELECT "
 			"time,"
 			"outsidetemp, max_outside_temperature, min_outside_temperature, "
@@ -181,7 +231,7 @@ namespace meteodata {
 			" AND day = ? ORDER BY time DESC"
 		);
 
-		prepareOneStatement(_insertV2RawDataPoint,
+		prepareOneStatement(_insertV2RawDataPoint, "insert_v2_raw_data_point",
 			"INSERT INTO meteodata_v2.raw_meteo ("
 			"station,"
 			"day, time,"
@@ -252,7 +302,7 @@ namespace meteodata {
 			")"
 		);
 
-		prepareOneStatement(_insertV2FilteredDataPoint,
+		prepareOneStatement(_insertV2FilteredDataPoint, "insert_v2_filtered_data_point",
 			"INSERT INTO meteodata_v2.meteo ("
 			"station,"
 			"day, time,"
@@ -323,7 +373,7 @@ namespace meteodata {
 			")"
 		);
 
-		prepareOneStatement(_insertV2MapDataPoint,
+		prepareOneStatement(_insertV2MapDataPoint, "insert_v2_map_data_point",
 			"INSERT INTO meteodata_v2.observations_map ("
 			"time,"
 			"station,"
@@ -410,7 +460,7 @@ namespace meteodata {
 			")"
 		);
 
-		prepareOneStatement(_insertEntireDayValues,
+		prepareOneStatement(_insertEntireDayValues, "insert_entire_day_values",
 			"INSERT INTO meteodata_v2.meteo ("
 			"station,"
 			"day, time,"
@@ -421,7 +471,7 @@ namespace meteodata {
 			"?, ?)"		// "rainfall24, insolation_time24)"
 		);
 
-		_pqConnection.prepare(UPSERT_ENTIRE_DAY_VALUES,
+		_pqConnections.prepare(UPSERT_ENTIRE_DAY_VALUES,
 			"INSERT INTO meteodata.day_values "
 			"(station, day, rainfall24, insolation_time24) "
 			"VALUES ($1, $2, $3, $4) "
@@ -429,7 +479,7 @@ namespace meteodata {
 			"SET rainfall24=$3, insolation_time24=$4"
 		);
 
-		prepareOneStatement(_insertTx,
+		prepareOneStatement(_insertTx, "insert_tx",
 			"INSERT INTO meteodata_v2.meteo ("
 			"station,"
 			"day, time,"
@@ -440,7 +490,7 @@ namespace meteodata {
 			"?)"		// "tx"
 		);
 
-		_pqConnection.prepare(UPSERT_TX,
+		_pqConnections.prepare(UPSERT_TX,
 			"INSERT INTO meteodata.day_values "
 			"(station, day, tx) "
 			"VALUES ($1, $2, $3) "
@@ -448,7 +498,7 @@ namespace meteodata {
 			"SET tx=$3"
 		);
 
-		prepareOneStatement(_insertTn,
+		prepareOneStatement(_insertTn, "insert_tn",
 			"INSERT INTO meteodata_v2.meteo ("
 			"station,"
 			"day, time,"
@@ -459,7 +509,7 @@ namespace meteodata {
 			"?)"		// "tn"
 		);
 
-		_pqConnection.prepare(UPSERT_TN,
+		_pqConnections.prepare(UPSERT_TN,
 			"INSERT INTO meteodata.day_values "
 			"(station, day, tn) "
 			"VALUES ($1, $2, $3) "
@@ -467,7 +517,7 @@ namespace meteodata {
 			"SET tn=$3"
 		);
 
-		prepareOneStatement(_insertDataPointInMonitoringDB,
+		prepareOneStatement(_insertDataPointInMonitoringDB, "insert_data_point_in_monitoring_db",
 			"INSERT INTO meteodata_v2.monitoring_observations ("
 			"station,"
 			"day, time,"
@@ -516,268 +566,288 @@ namespace meteodata {
 			"?)"
 		);
 
-		prepareOneStatement(_updateLastArchiveDownloadTime,
+		prepareOneStatement(_updateLastArchiveDownloadTime, "update_last_archive_download_time",
 			"UPDATE meteodata.stations SET last_archive_download = ? WHERE id = ?"
 		);
 
-		_pqConnection.prepare(UPSERT_LAST_ARCHIVE_DOWNLOAD_TIME,
+		_pqConnections.prepare(UPSERT_LAST_ARCHIVE_DOWNLOAD_TIME,
 			"UPDATE meteodata.last_archive_download "
 			"SET last_archive_download = $1 WHERE station = $2"
 		);
 
-		prepareOneStatement(_selectWeatherlinkStations,
+		prepareOneStatement(_selectWeatherlinkStations, "select_weatherlink_stations",
 			"SELECT station, active, auth, api_token, tz FROM meteodata.weatherlink"
 		);
 
-		_pqConnection.prepare(SELECT_WEATHERLINK_V1,
+		_pqConnections.prepare(SELECT_WEATHERLINK_V1,
 			"SELECT WLv1.station,P.* "
 			"FROM meteodata.connectors WLv1 "
 			"CROSS JOIN LATERAL jsonb_to_record(WLv1.param) AS P(auth varchar, api_token varchar, tz int) "
 			"WHERE connector = 'weatherlink_v1' AND active = true"
 		);
 
-		prepareOneStatement(_selectWeatherlinkAPIv2Stations,
+		prepareOneStatement(_selectWeatherlinkAPIv2Stations, "select_weatherlink_apiv2_stations",
 			"SELECT station, active, archived, substations, weatherlink_id, parsers FROM meteodata.weatherlink_apiv2"
 		);
 
-		_pqConnection.prepare(SELECT_WEATHERLINK_V2,
+		_pqConnections.prepare(SELECT_WEATHERLINK_V2,
 			"SELECT WLv2.station,P.* "
 			"FROM meteodata.connectors WLv2 "
 			"CROSS JOIN LATERAL jsonb_to_record(WLv2.param) AS P(archived bool, substations text, weatherlink_id varchar, parsers text) "
 			"WHERE connector = 'weatherlink_v2' AND active = true"
 		);
 
-		prepareOneStatement(_selectMqttStations,
+		prepareOneStatement(_selectMqttStations, "select_mqtt_stations",
 			"SELECT station, active, host, port, user, password, topic, tz FROM meteodata.mqtt"
 		);
 
-		_pqConnection.prepare(SELECT_MQTT,
+		_pqConnections.prepare(SELECT_MQTT,
 			"SELECT mqtt.station,P.* "
 			"FROM meteodata.connectors mqtt "
 			"CROSS JOIN LATERAL jsonb_to_record(mqtt.param) AS P(host varchar, port int, \"user\" varchar, \"password\" varchar, topic varchar, tz int) "
 			"WHERE connector = 'mqtt' AND active = true"
 		);
 
-		prepareOneStatement(_selectFieldClimateApiStations,
+		prepareOneStatement(_selectFieldClimateApiStations, "select_field_climate_api_stations",
 			"SELECT station, active, fieldclimate_id, sensors, tz FROM meteodata.fieldclimate"
 		);
 
-		_pqConnection.prepare(SELECT_FIELDCLIMATE,
+		_pqConnections.prepare(SELECT_FIELDCLIMATE,
 			"SELECT fieldclimate.station,P.* "
 			"FROM meteodata.connectors fieldclimate "
 			"CROSS JOIN LATERAL jsonb_to_record(fieldclimate.param) AS P(fieldclimate_id varchar, sensors text, tz int) "
 			"WHERE connector = 'fieldclimate' AND active = true"
 		);
 
-		prepareOneStatement(_selectObjeniousApiStations,
+		prepareOneStatement(_selectObjeniousApiStations, "select_objenious_api_stations",
 			"SELECT station, active, objenious_id, variables FROM meteodata.objenious"
 		);
 
-		_pqConnection.prepare(SELECT_OBJENIOUS,
+		_pqConnections.prepare(SELECT_OBJENIOUS,
 			"SELECT objenious.station,P.* "
 			"FROM meteodata.connectors objenious "
 			"CROSS JOIN LATERAL jsonb_to_record(objenious.param) AS P(objenious_id varchar, variables text) "
 			"WHERE connector = 'objenious' AND active = true"
 		);
 
-		prepareOneStatement(_selectLiveobjectsStations,
+		prepareOneStatement(_selectLiveobjectsStations, "select_liveobjects_stations",
 			"SELECT station, active, stream_id, topic_prefix FROM meteodata.liveobjects"
 		);
 
-		_pqConnection.prepare(SELECT_LIVEOBJECTS,
+		_pqConnections.prepare(SELECT_LIVEOBJECTS,
 			"SELECT liveobjects.station,P.* "
 			"FROM meteodata.connectors liveobjects "
 			"CROSS JOIN LATERAL jsonb_to_record(liveobjects.param) AS P(stream_id varchar, topic_prefix varchar) "
 			"WHERE connector = 'liveobjects' AND active = true"
 		);
 
-		prepareOneStatement(_selectCimelStations,
+		prepareOneStatement(_selectCimelStations, "select_cimel_stations",
 			"SELECT station, active, cimelid, tz FROM meteodata.cimel"
 		);
 
-		_pqConnection.prepare(SELECT_CIMEL,
+		_pqConnections.prepare(SELECT_CIMEL,
 			"SELECT cimel.station,P.* "
 			"FROM meteodata.connectors cimel "
 			"CROSS JOIN LATERAL jsonb_to_record(cimel.param) AS P(cimelid varchar, tz int) "
 			"WHERE connector = 'cimel' AND active = true"
 		);
 
-		prepareOneStatement(_selectStatICTxtStations,
+		prepareOneStatement(_selectStatICTxtStations, "select_stat_ic_txt_stations",
 			"SELECT station, active, host, url, https, tz, sensors FROM meteodata.statictxt"
 		);
 
-		_pqConnection.prepare(SELECT_STATICTXT,
+		_pqConnections.prepare(SELECT_STATICTXT,
 			"SELECT static.station,P.* "
 			"FROM meteodata.connectors static "
 			"CROSS JOIN LATERAL jsonb_to_record(static.param) AS P(host varchar, url varchar, https bool, tz int, sensors text) "
 			"WHERE connector = 'static' AND active = true"
 		);
 
-		prepareOneStatement(_selectMBDataTxtStations,
+		prepareOneStatement(_selectMBDataTxtStations, "select_mb_data_txt_stations",
 			"SELECT station, active, host, url, https, tz, type FROM meteodata.mbdatatxt"
 		);
 
-		_pqConnection.prepare(SELECT_MBDATATXT,
+		_pqConnections.prepare(SELECT_MBDATATXT,
 			"SELECT mbdata.station,P.* "
 			"FROM meteodata.connectors mbdata "
 			"CROSS JOIN LATERAL jsonb_to_record(mbdata.param) AS P(host varchar, url varchar, https bool, tz int, type varchar) "
 			"WHERE connector = 'mbdata' AND active = true"
 		);
 
-		prepareOneStatement(_selectMeteoFranceStations,
+		prepareOneStatement(_selectMeteoFranceStations, "select_meteo_france_stations",
 			"SELECT id, active, icao, idstation, date_creation, latitude, longitude, elevation, type FROM meteodata.stationsfr"
 		);
 
-		_pqConnection.prepare(SELECT_METEOFRANCE,
+		_pqConnections.prepare(SELECT_METEOFRANCE,
 			"SELECT mbdata.meteofrance,P.* "
 			"FROM meteodata.connectors meteofrance "
 			"CROSS JOIN LATERAL jsonb_to_record(meteofrance.param) AS P(icao varchar, idstation varchar, latitude float, longitude float, elevation int, type varchar) "
 			"WHERE connector = 'meteofrance' AND active = true"
 		);
 
-		prepareOneStatement(_selectVirtualStations,
+		prepareOneStatement(_selectVirtualStations, "select_virtual_stations",
 			"SELECT station, active, period, sources FROM meteodata.virtual_stations"
 		);
 
-		_pqConnection.prepare(SELECT_VIRTUAL_STATIONS,
+		_pqConnections.prepare(SELECT_VIRTUAL_STATIONS,
 			"SELECT mbdata.virtual,P.* "
 			"FROM meteodata.connectors virtual "
 			"CROSS JOIN LATERAL jsonb_to_record(virtual.param) AS P(period int, sources text) "
 			"WHERE connector = 'virtual' AND active = true"
 		);
 
-		prepareOneStatement(_selectNbiotStations,
+		prepareOneStatement(_selectNbiotStations, "select_nbiot_stations",
 			"SELECT station, active, imei, imsi, hmac_key, sensor_type FROM meteodata.nbiot"
 		);
 
-		_pqConnection.prepare(SELECT_NBIOT,
+		_pqConnections.prepare(SELECT_NBIOT,
 			"SELECT mbdata.nbiot,P.* "
 			"FROM meteodata.connectors nbiot "
 			"CROSS JOIN LATERAL jsonb_to_record(nbiot.param) AS P(imei varchar, imsi varchar, hmac_key varchar, sensor_type varchar) "
 			"WHERE connector = 'nbiot' AND active = true"
 		);
 
-		prepareOneStatement(_getRainfall,
+		prepareOneStatement(_getRainfall, "get_rainfall",
 			"SELECT SUM(rainfall) FROM meteodata_v2.meteo "
 			"WHERE station = ? AND day = ? AND time > ? AND time <= ?"
 		);
 
-		_pqConnection.prepare(SELECT_RAINFALL,
+		prepareOptionalStatement(_insertRainfallHourly, "insert_rainfall_hourly",
+			"INSERT INTO meteodata_v2.rainfall_hourly (station, day, hour, rainfall) "
+			"VALUES (?, ?, ?, ?)"
+		);
+
+		prepareOptionalStatement(_selectRainfallHourly, "select_rainfall_hourly",
+			"SELECT hour, rainfall FROM meteodata_v2.rainfall_hourly "
+			"WHERE station = ? AND day = ? AND hour >= ? AND hour < ?"
+		);
+
+		prepareOptionalStatement(_insertRainfallDaily, "insert_rainfall_daily",
+			"INSERT INTO meteodata_v2.rainfall_daily (station, day, rainfall) "
+			"VALUES (?, ?, ?)"
+		);
+
+		prepareOptionalStatement(_selectRainfallDaily, "select_rainfall_daily",
+			"SELECT day, rainfall FROM meteodata_v2.rainfall_daily "
+			"WHERE station = ? AND day >= ? AND day < ?"
+		);
+
+		_pqConnections.prepare(SELECT_RAINFALL,
 			"SELECT SUM(rainfall) FROM meteodata.observations "
 			"WHERE station = $1 AND datetime >= $2 AND datetime < $3"
 		);
 
-		prepareOneStatement(_deleteDataPoints,
+		prepareOneStatement(_deleteDataPoints, "delete_data_points",
 			"DELETE FROM meteodata_v2.meteo WHERE station=? AND day=? AND time>? AND time<=?"
 		);
 
-		_pqConnection.prepare(DELETE_DATA_POINTS,
+		_pqConnections.prepare(DELETE_DATA_POINTS,
 			"DELETE FROM meteodata.observations "
 			"WHERE station = $1 AND datetime >= $2 AND datetime < $3"
 		);
 
-		prepareOneStatement(_selectTx,
+		prepareOneStatement(_selectTx, "select_tx",
 			"SELECT tx FROM meteodata_v2.meteo WHERE station=? AND day=? LIMIT 1"
 		);
 
-		prepareOneStatement(_selectTn,
+		prepareOneStatement(_selectTn, "select_tn",
 			"SELECT tn FROM meteodata_v2.meteo WHERE station=? AND day=? LIMIT 1"
 		);
 
-		_pqConnection.prepare(SELECT_ENTIRE_DAY_VALUES,
+		_pqConnections.prepare(SELECT_ENTIRE_DAY_VALUES,
 			"SELECT * FROM meteodata.day_values "
 			"WHERE station = $1 AND day = $2"
 		);
 
-		prepareOneStatement(_selectCached,
+		prepareOneStatement(_selectCached, "select_cached",
 			"SELECT time, value_int, value_float FROM meteodata_v2.cache WHERE station=? AND cache_key=?"
 		);
 
-		_pqConnection.prepare(SELECT_CACHED_VALUE,
+		_pqConnections.prepare(SELECT_CACHED_VALUE,
 			"SELECT * FROM meteodata.station_status "
 			"WHERE station = $1 AND cache_key = $2"
 		);
 
-		prepareOneStatement(_insertIntoCache,
+		prepareOneStatement(_insertIntoCache, "insert_into_cache",
 			"INSERT INTO meteodata_v2.cache (station, cache_key, time, value_int, value_float) VALUES (?, ?, ?, ?, ?)"
 		);
 
-		_pqConnection.prepare(UPSERT_CACHED_VALUE,
+		_pqConnections.prepare(UPSERT_CACHED_VALUE,
 			"INSERT INTO meteodata.station_status (station, cache_key, datetime, value) "
 			"VALUES ($1, $2, $3, $4) "
 			"ON CONFLICT (station, cache_key) DO UPDATE "
 			"SET datetime=$3, value=$4"
 		);
 
-		prepareOneStatement(_selectLastSchedulerDownloadTime,
+		prepareOneStatement(_selectLastSchedulerDownloadTime, "select_last_scheduler_download_time",
 			"SELECT last_download FROM meteodata.scheduling_status WHERE scheduler=?"
 		);
 
-		_pqConnection.prepare(SELECT_LAST_SCHEDULER_DOWNLOAD_TIME,
+		_pqConnections.prepare(SELECT_LAST_SCHEDULER_DOWNLOAD_TIME,
 			"SELECT last_download FROM meteodata.scheduling_status "
 			"WHERE scheduler = $1"
 		);
 
-		prepareOneStatement(_insertLastSchedulerDownloadTime,
+		prepareOneStatement(_insertLastSchedulerDownloadTime, "insert_last_scheduler_download_time",
 			"INSERT INTO meteodata.scheduling_status (scheduler,last_download) VALUES (?,?)"
 		);
 
-		_pqConnection.prepare(UPSERT_LAST_SCHEDULER_DOWNLOAD_TIME,
+		_pqConnections.prepare(UPSERT_LAST_SCHEDULER_DOWNLOAD_TIME,
 			"INSERT INTO meteodata.scheduling_status (scheduler,last_download) "
 			"VALUES ($1,$2) "
 			"ON CONFLICT (scheduler) DO UPDATE SET last_download=$2"
 		);
 
-		prepareOneStatement(_selectOldestConfiguration,
+		prepareOneStatement(_selectOldestConfiguration, "select_oldest_configuration",
 			"SELECT station, active, id, config, added_on FROM meteodata.pending_configurations WHERE station=? ORDER BY id ASC"
 		);
 
-		_pqConnection.prepare(SELECT_OLDEST_CONFIGURATION,
+		_pqConnections.prepare(SELECT_OLDEST_CONFIGURATION,
 			"SELECT station, id, config, added_on FROM meteodata.pending_configuration "
 			"WHERE station = $1 AND active = true "
 			"ORDER BY added_on ASC LIMIT 1"
 		);
 
-		prepareOneStatement(_selectLastConfiguration,
+		prepareOneStatement(_selectLastConfiguration, "select_last_configuration",
 			"SELECT station, active, id, config, added_on FROM meteodata.pending_configurations WHERE station=? ORDER BY id DESC"
 		);
 
-		_pqConnection.prepare(SELECT_LATEST_CONFIGURATION,
+		_pqConnections.prepare(SELECT_LATEST_CONFIGURATION,
 			"SELECT station, id, config, added_on FROM meteodata.pending_configuration "
 			"WHERE station = $1 AND active = true "
 			"ORDER BY added_on DESC LIMIT 1"
 		);
 
-		prepareOneStatement(_selectOneConfiguration,
+		prepareOneStatement(_selectOneConfiguration, "select_one_configuration",
 			"SELECT station, active, id, config, added_on FROM meteodata.pending_configurations WHERE station=? AND id=?"
 		);
 
-		_pqConnection.prepare(SELECT_ONE_CONFIGURATION,
+		_pqConnections.prepare(SELECT_ONE_CONFIGURATION,
 			"SELECT station, active, id, config, added_on FROM meteodata.pending_configuration "
 			"WHERE station = $1 AND id = $2"
 		);
 
-		prepareOneStatement(_updateConfigurationStatus,
+		prepareOneStatement(_updateConfigurationStatus, "update_configuration_status",
 			"UPDATE meteodata.pending_configurations SET active=? WHERE station=? AND id=?"
 		);
 
-		_pqConnection.prepare(UPDATE_CONFIGURATION_STATUS,
+		_pqConnections.prepare(UPDATE_CONFIGURATION_STATUS,
 			"UPDATE meteodata.pending_configuration "
 			"SET active = $1 WHERE station = $2 AND id = $3"
 		);
 
-		_pqConnection.prepare(INSERT_DOWNLOAD,
+		_pqConnections.prepare(INSERT_DOWNLOAD,
 			"INSERT INTO downloads (station, datetime, connector, content, inserted, job_state) "
 			" VALUES ($1, $2, $3, $4, $5, $6) "
 			" ON CONFLICT (station, datetime) DO UPDATE "
 			" SET connector=$3, content=$4, inserted=$5, job_state=$6"
 		);
 
-		_pqConnection.prepare(UPDATE_DOWNLOAD_STATUS,
+		_pqConnections.prepare(UPDATE_DOWNLOAD_STATUS,
 			"UPDATE downloads SET inserted=$3, job_state=$4 WHERE station=$1 AND datetime=$2"
 		);
 
-		_pqConnection.prepare(SELECT_DOWNLOADS_BY_STATION,
+		_pqConnections.prepare(SELECT_DOWNLOADS_BY_STATION,
 			"SELECT station, datetime, connector, content, inserted, job_state "
 			" FROM downloads "
 			" WHERE station=$1 AND connector=$2 AND job_state='new' "
@@ -785,7 +855,7 @@ namespace meteodata {
 			" FOR UPDATE SKIP LOCKED"
 		);
 
-		_pqConnection.prepare(UPSERT_OBSERVATION,
+		_pqConnections.prepare(UPSERT_OBSERVATION,
 			"INSERT INTO meteodata.observations ("
 			"station,"
 			"datetime,"
@@ -913,20 +983,26 @@ namespace meteodata {
 			"voltage_backup=COALESCE($58, meteodata.observations.voltage_backup) "
 		);
 
+		// The COPY path of insertV2DataPointsInTimescaleDB() is made
+		// of unprepared statements, traced like the others
+		_copyObservationsMetrics = &StatementMetrics::series(StatementMetrics::Backend::POSTGRESQL, COPY_OBSERVATIONS);
+		_mergeObservationsMetrics = &StatementMetrics::series(StatementMetrics::Backend::POSTGRESQL, MERGE_OBSERVATIONS);
 	}
 
 	bool DbConnectionObservations::getLastDataBefore(const CassUuid& station, time_t boundary, Observation& obs)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectLastDataBefore.get()),
+			_selectLastDataBefore.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_set_is_idempotent(statement.get(), cass_true);
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		cass_statement_bind_uint32(statement.get(), 1, cass_date_from_epoch(boundary));
 		cass_statement_bind_int64(statement.get(), 2, boundary * 1000);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_selectLastDataBefore, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -994,16 +1070,23 @@ namespace meteodata {
 	bool DbConnectionObservations::getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station,
 		std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements)
 	{
+		if (_stationCache.getStationByCoords(elevation, latitude, longitude, station))
+			return getStationDetails(station, name, pollPeriod, lastArchiveDownloadTime, storeInsideMeasurements);
+
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectStationByCoords.get()),
+			_selectStationByCoords.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_set_is_idempotent(statement.get(), cass_true);
 		cass_statement_bind_int32(statement.get(), 0, elevation);
 		cass_statement_bind_int32(statement.get(), 1, latitude);
 		cass_statement_bind_int32(statement.get(), 2, longitude);
+		// The station is what is looked for, there is none to
+		// report to the QueryObserver
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_selectStationByCoords, statement.get(), nullptr),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1016,6 +1099,7 @@ namespace meteodata {
 			const CassRow* row = cass_result_first_row(result.get());
 			if (row) {
 				cass_value_get_uuid(cass_row_get_column(row,0), &station);
+				_stationCache.putStationByCoords(elevation, latitude, longitude, station);
 				ret = getStationDetails(station, name, pollPeriod, lastArchiveDownloadTime, storeInsideMeasurements);
 			}
 		}
@@ -1025,14 +1109,27 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getStationCoordinates(CassUuid station, float& latitude, float& longitude, int& elevation, std::string& name, int& pollPeriod)
 	{
+		StationCache::Coordinates coordinates{latitude, longitude, elevation, {false, {}}, pollPeriod};
+		if (_stationCache.getCoordinates(station, coordinates)) {
+			latitude = coordinates.latitude;
+			longitude = coordinates.longitude;
+			elevation = coordinates.elevation;
+			if (coordinates.name.first)
+				name = std::move(coordinates.name.second);
+			pollPeriod = coordinates.pollPeriod;
+			return true;
+		}
+
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectStationCoordinates.get()),
+			_selectStationCoordinates.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_set_is_idempotent(statement.get(), cass_true);
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_selectStationCoordinates, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1044,17 +1141,25 @@ namespace meteodata {
 		if (result) {
 			const CassRow* row = cass_result_first_row(result.get());
 			if (row) {
-				cass_value_get_float(cass_row_get_column(row,0), &latitude);
-				cass_value_get_float(cass_row_get_column(row,1), &longitude);
-				cass_value_get_int32(cass_row_get_column(row,2), &elevation);
+				cass_value_get_float(cass_row_get_column(row,0), &coordinates.latitude);
+				cass_value_get_float(cass_row_get_column(row,1), &coordinates.longitude);
+				cass_value_get_int32(cass_row_get_column(row,2), &coordinates.elevation);
 				const char *nameStr;
 				size_t sizeName;
 				const CassValue* v = cass_row_get_column(row, 3);
 				if (!cass_value_is_null(v)) {
 					cass_value_get_string(cass_row_get_column(row, 3), &nameStr, &sizeName);
-					name.assign(nameStr, sizeName);
+					coordinates.name = {true, std::string{nameStr, sizeName}};
+					name = coordinates.name.second;
 				}
-				cass_value_get_int32(cass_row_get_column(row,4), &pollPeriod);
+				cass_value_get_int32(cass_row_get_column(row,4), &coordinates.pollPeriod);
+
+				latitude = coordinates.latitude;
+				longitude = coordinates.longitude;
+				elevation = coordinates.elevation;
+				pollPeriod = coordinates.pollPeriod;
+				_stationCache.putCoordinates(station, std::move(coordinates));
+				ret = true;
 			}
 		}
 
@@ -1064,12 +1169,19 @@ namespace meteodata {
 	bool DbConnectionObservations::insertV2DataPoint(const CassUuid station, const Message& msg)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertV2FilteredDataPoint.get()),
+			_insertV2FilteredDataPoint.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		msg.populateV2DataPoint(station, statement.get());
+		_mapAggregator.invalidate(station);
+		if (_dailyAggregator)
+			_dailyAggregator->invalidate(station);
+		// The time of the message is not known here, the rainfall
+		// rollup is left to rebuildRainfallRollup()
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertV2FilteredDataPoint, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1373,14 +1485,19 @@ namespace meteodata {
 
 	bool DbConnectionObservations::insertV2DataPoint(const Observation& obs)
 	{
+		// The statements are not available if their lazy preparation
+		// has failed
+		if (!_insertV2RawDataPoint.get() || !_insertV2FilteredDataPoint.get() || !_insertV2MapDataPoint.get())
+			return false;
+
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertV2RawDataPoint.get()),
+			_insertV2RawDataPoint.bind(),
 			cass_statement_free
 		};
 
 		populateV2InsertionQuery(statement.get(), obs);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertV2RawDataPoint, statement.get(), &obs.station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1397,31 +1514,39 @@ namespace meteodata {
 
 
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement2{
-			cass_prepared_bind(_insertV2FilteredDataPoint.get()),
+			_insertV2FilteredDataPoint.bind(),
 			cass_statement_free
 		};
 		Observation copy{obs};
 		copy.filterOutImpossibleValues();
 		populateV2InsertionQuery(statement2.get(), copy);
-		query.reset(cass_session_execute(_session.get(), statement2.get()));
+		query.reset(execute(_insertV2FilteredDataPoint, statement2.get(), &obs.station));
 		result.reset(cass_future_get_result(query.get()));
 
 		if (!result) {
 			const char* error_message;
 			size_t error_message_length;
 			cass_future_error_message(query.get(), &error_message, &error_message_length);
+			if (_dailyAggregator)
+				_dailyAggregator->invalidate(obs.station);
 			return false;
 		}
 
+		if (_dailyAggregator)
+			_dailyAggregator->accumulate(copy);
+
+		if (copy.rainfall.first)
+			_rainfallRollups.push(obs.station, obs.time - chrono::seconds(1), obs.time);
+
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement3{
-			cass_prepared_bind(_insertV2MapDataPoint.get()),
+			_insertV2MapDataPoint.bind(),
 			cass_statement_free
 		};
 		MapObservation map;
-		getMapValues(obs.station, chrono::system_clock::to_time_t(obs.time), map);
+		computeMapValues(copy, map);
 		chrono::seconds truncatedTime = obs.time.time_since_epoch() - obs.time.time_since_epoch() % OBSERVATIONS_MAP_TIME_RESOLUTION;
 		populateV2MapInsertionQuery(statement3.get(), copy, map, truncatedTime);
-		query.reset(cass_session_execute(_session.get(), statement3.get()));
+		query.reset(execute(_insertV2MapDataPoint, statement3.get(), &obs.station));
 		result.reset(cass_future_get_result(query.get()));
 
 		if (!result) {
@@ -1433,10 +1558,10 @@ namespace meteodata {
 
 		// Insert the same observation at the following increment, as a
 		// temporary measurement
-		statement3.reset(cass_prepared_bind(_insertV2MapDataPoint.get()));
+		statement3.reset(_insertV2MapDataPoint.bind());
 		truncatedTime += OBSERVATIONS_MAP_TIME_RESOLUTION;
 		populateV2MapInsertionQuery(statement3.get(), copy, map, truncatedTime);
-		query.reset(cass_session_execute(_session.get(), statement3.get()));
+		query.reset(execute(_insertV2MapDataPoint, statement3.get(), &obs.station));
 		result.reset(cass_future_get_result(query.get()));
 
 		if (!result) {
@@ -1448,10 +1573,223 @@ namespace meteodata {
 		return true;
 	}
 
+	std::future<bool> DbConnectionObservations::insertV2DataPointAsync(const Observation& obs)
+	{
+		// The state shared by the completion callbacks of the four
+		// insertions, the last one to complete fulfills the promise
+		struct Insertion
+		{
+			std::promise<bool> promise;
+			std::atomic<int> pending{4};
+			std::atomic<bool> success{true};
+		};
+		auto insertion = std::make_shared<Insertion>();
+		std::future<bool> ret = insertion->promise.get_future();
+
+		if (!_insertV2RawDataPoint.get() || !_insertV2FilteredDataPoint.get() || !_insertV2MapDataPoint.get()) {
+			insertion->promise.set_value(false);
+			return ret;
+		}
+
+		auto complete = [insertion](bool inserted) {
+			if (!inserted)
+				insertion->success = false;
+			if (--insertion->pending == 0)
+				insertion->promise.set_value(insertion->success);
+		};
+		auto onCompletion = [complete](CassFuture* future) {
+			complete(cass_future_error_code(future) == CASS_OK);
+		};
+
+		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
+			_insertV2RawDataPoint.bind(),
+			cass_statement_free
+		};
+		populateV2InsertionQuery(statement.get(), obs);
+		execute(_insertV2RawDataPoint, statement.get(), &obs.station, onCompletion);
+
+		Observation copy{obs};
+		copy.filterOutImpossibleValues();
+		statement.reset(_insertV2FilteredDataPoint.bind());
+		populateV2InsertionQuery(statement.get(), copy);
+		// Like in the synchronous method, the aggregators and the
+		// rainfall rollups only follow the filtered observations
+		// actually inserted
+		execute(_insertV2FilteredDataPoint, statement.get(), &obs.station, [this, complete, copy](CassFuture* future) {
+			bool inserted = cass_future_error_code(future) == CASS_OK;
+			if (inserted) {
+				if (_dailyAggregator)
+					_dailyAggregator->accumulate(copy);
+				if (copy.rainfall.first)
+					_rainfallRollups.push(copy.station, copy.time - chrono::seconds(1), copy.time);
+			} else {
+				// The map aggregator has already counted the
+				// observation
+				_mapAggregator.invalidate(copy.station);
+				if (_dailyAggregator)
+					_dailyAggregator->invalidate(copy.station);
+			}
+			complete(inserted);
+		});
+
+		// The map values are computed while the first two
+		// insertions are in flight, in the calling thread so that the
+		// map aggregator gets the observations in the order of the calls
+		MapObservation map;
+		computeMapValues(copy, map);
+		chrono::seconds truncatedTime = obs.time.time_since_epoch() - obs.time.time_since_epoch() % OBSERVATIONS_MAP_TIME_RESOLUTION;
+
+		statement.reset(_insertV2MapDataPoint.bind());
+		populateV2MapInsertionQuery(statement.get(), copy, map, truncatedTime);
+		execute(_insertV2MapDataPoint, statement.get(), &obs.station, onCompletion);
+
+		// Insert the same observation at the following increment, as a
+		// temporary measurement
+		statement.reset(_insertV2MapDataPoint.bind());
+		truncatedTime += OBSERVATIONS_MAP_TIME_RESOLUTION;
+		populateV2MapInsertionQuery(statement.get(), copy, map, truncatedTime);
+		execute(_insertV2MapDataPoint, statement.get(), &obs.station, onCompletion);
+
+		return ret;
+	}
+
+	bool DbConnectionObservations::doInsertV2DataPoints(const std::vector<const Observation*>& observations, std::vector<std::size_t>* failures)
+	{
+		if (!_insertV2RawDataPoint.get() || !_insertV2FilteredDataPoint.get()) {
+			if (failures) {
+				failures->resize(observations.size());
+				for (std::size_t i = 0 ; i < failures->size() ; i++)
+					(*failures)[i] = i;
+			}
+			return false;
+		}
+
+		// Sort the observations by partition, keeping them in
+		// chronological order inside each partition
+		std::vector<std::size_t> order(observations.size());
+		for (std::size_t i = 0 ; i < order.size() ; i++)
+			order[i] = i;
+		auto partitionOf = [&](std::size_t i) {
+			const Observation* obs = observations[i];
+			return std::make_tuple(
+				obs->station.time_and_version,
+				obs->station.clock_seq_and_node,
+				date::floor<date::days>(obs->time)
+			);
+		};
+		std::stable_sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+			return partitionOf(i) < partitionOf(j);
+		});
+
+		struct InFlightBatch {
+			std::unique_ptr<CassFuture, void(&)(CassFuture*)> query;
+			std::vector<std::size_t> items;
+		};
+		std::deque<InFlightBatch> inFlight;
+		std::vector<std::size_t> failed;
+		// The periods (begin, end] of the partitions whose rainfall
+		// rollup must be updated
+		std::vector<std::tuple<CassUuid, date::sys_seconds, date::sys_seconds>> rainfallPeriods;
+
+		auto waitForOldestBatch = [&]() {
+			InFlightBatch& batch = inFlight.front();
+			std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
+				cass_future_get_result(batch.query.get()),
+				cass_result_free
+			};
+
+			if (!result) {
+				const char* error_message;
+				size_t error_message_length;
+				cass_future_error_message(batch.query.get(), &error_message, &error_message_length);
+				failed.insert(failed.end(), batch.items.begin(), batch.items.end());
+			}
+			inFlight.pop_front();
+		};
+
+		auto sendBatch = [&](const CassandraStmtPtr& prepared, auto first, auto last, bool filter) {
+			std::unique_ptr<CassBatch, void(&)(CassBatch*)> batch{
+				cass_batch_new(CASS_BATCH_TYPE_UNLOGGED),
+				cass_batch_free
+			};
+			cass_batch_set_is_idempotent(batch.get(), cass_true);
+			std::vector<std::size_t> items;
+			for (auto it = first ; it != last ; ++it) {
+				std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
+					prepared.bind(),
+					cass_statement_free
+				};
+				if (filter) {
+					Observation copy{*observations[*it]};
+					copy.filterOutImpossibleValues();
+					populateV2InsertionQuery(statement.get(), copy);
+				} else {
+					populateV2InsertionQuery(statement.get(), *observations[*it]);
+				}
+				cass_batch_add_statement(batch.get(), statement.get());
+				items.push_back(*it);
+			}
+
+			if (inFlight.size() >= MAX_BATCHES_IN_FLIGHT)
+				waitForOldestBatch();
+			inFlight.push_back(InFlightBatch{
+				{ execute(prepared, batch.get(), &observations[*first]->station), cass_future_free },
+				std::move(items)
+			});
+		};
+
+		auto partitionBegin = order.begin();
+		while (partitionBegin != order.end()) {
+			auto partition = partitionOf(*partitionBegin);
+			auto partitionEnd = std::find_if(partitionBegin, order.end(), [&](std::size_t i) {
+				return partitionOf(i) != partition;
+			});
+			// The rolling window of the map values would miss these
+			// observations
+			_mapAggregator.invalidate(observations[*partitionBegin]->station);
+			if (_dailyAggregator)
+				_dailyAggregator->invalidate(observations[*partitionBegin]->station);
+
+			auto withRainfall = std::find_if(partitionBegin, partitionEnd, [&](std::size_t i) {
+				return observations[i]->rainfall.first;
+			});
+			if (withRainfall != partitionEnd) {
+				auto [earliest, latest] = std::minmax_element(partitionBegin, partitionEnd, [&](std::size_t i, std::size_t j) {
+					return observations[i]->time < observations[j]->time;
+				});
+				rainfallPeriods.emplace_back(observations[*partitionBegin]->station,
+					observations[*earliest]->time - chrono::seconds(1),
+					observations[*latest]->time);
+			}
+
+			for (auto first = partitionBegin ; first != partitionEnd ; ) {
+				auto last = first + std::min<std::ptrdiff_t>(INSERTION_BATCH_SIZE, partitionEnd - first);
+				sendBatch(_insertV2RawDataPoint, first, last, false);
+				sendBatch(_insertV2FilteredDataPoint, first, last, true);
+				first = last;
+			}
+			partitionBegin = partitionEnd;
+		}
+
+		while (!inFlight.empty())
+			waitForOldestBatch();
+
+		for (const auto& [station, begin, end] : rainfallPeriods)
+			_rainfallRollups.push(station, begin, end);
+
+		if (failures) {
+			std::sort(failed.begin(), failed.end());
+			failed.erase(std::unique(failed.begin(), failed.end()), failed.end());
+			*failures = std::move(failed);
+			return failures->empty();
+		}
+		return failed.empty();
+	}
+
 	bool DbConnectionObservations::insertV2DataPointInTimescaleDB(const Observation& obs)
 	{
-		std::lock_guard locked{_pqTransactionMutex};
-		pqxx::work tx{_pqConnection};
+		auto connection = _pqConnections.checkout();
+		pqxx::work tx{*connection};
 		try {
 			doInsertV2DataPointInTimescaleDB(obs, tx);
 			tx.commit();
@@ -1468,6 +1806,7 @@ namespace meteodata {
 
 		char uuid[CASS_UUID_STRING_LENGTH];
 		cass_uuid_string(obs.station, uuid);
+		QueryTrace trace{_pqConnections.metrics(UPSERT_OBSERVATION), &obs.station};
 		tx.exec_prepared0(UPSERT_OBSERVATION,
 			uuid,
 			date::format("%F %T%z", obs.time),
@@ -1525,17 +1864,144 @@ namespace meteodata {
 			obs.leafwetness_percent1.first ? &obs.leafwetness_percent1.second : nullptr,
 			obs.soil_conductivity1.first ? &obs.soil_conductivity1.second : nullptr,
 			obs.voltage_battery.first ? &obs.voltage_battery.second : nullptr,
-			obs.voltage_backup.first ? &obs.voltage_backup.second : nullptr,
-			obs.voltage_solar_panel.first ? &obs.voltage_solar_panel.second : nullptr
+			obs.voltage_solar_panel.first ? &obs.voltage_solar_panel.second : nullptr,
+			obs.voltage_backup.first ? &obs.voltage_backup.second : nullptr
+		);
+		trace.stop();
+	}
+
+	void DbConnectionObservations::doStreamV2DataPointToTimescaleDB(const Observation& orig, pqxx::stream_to& stream)
+	{
+		Observation obs{orig};
+		obs.filterOutImpossibleValues();
+
+		auto nullable = [](const auto& value) {
+			using T = std::decay_t<decltype(value.second)>;
+			return value.first ? std::optional<T>{value.second} : std::optional<T>{};
+		};
+
+		char uuid[CASS_UUID_STRING_LENGTH];
+		cass_uuid_string(obs.station, uuid);
+		stream << std::make_tuple(
+			std::string{uuid},
+			date::format("%F %T%z", obs.time),
+			nullable(obs.barometer),
+			nullable(obs.dewpoint),
+			nullable(obs.extrahum[0]),
+			nullable(obs.extrahum[1]),
+			nullable(obs.extratemp[0]),
+			nullable(obs.extratemp[1]),
+			nullable(obs.extratemp[2]),
+			nullable(obs.heatindex),
+			nullable(obs.insidehum),
+			nullable(obs.insidetemp),
+			nullable(obs.leaftemp[0]),
+			nullable(obs.leaftemp[1]),
+			nullable(obs.leafwetnesses[0]),
+			nullable(obs.leafwetnesses[1]),
+			nullable(obs.outsidehum),
+			nullable(obs.outsidetemp),
+			nullable(obs.rainrate),
+			nullable(obs.rainfall),
+			nullable(obs.et),
+			nullable(obs.soilmoistures[0]),
+			nullable(obs.soilmoistures[1]),
+			nullable(obs.soilmoistures[2]),
+			nullable(obs.soilmoistures[3]),
+			nullable(obs.soiltemp[0]),
+			nullable(obs.soiltemp[1]),
+			nullable(obs.soiltemp[2]),
+			nullable(obs.soiltemp[3]),
+			nullable(obs.solarrad),
+			nullable(obs.thswindex),
+			nullable(obs.uv),
+			nullable(obs.windchill),
+			nullable(obs.winddir),
+			nullable(obs.windgust),
+			nullable(obs.min_windspeed),
+			nullable(obs.windspeed),
+			nullable(obs.insolation_time),
+			nullable(obs.min_outside_temperature),
+			nullable(obs.max_outside_temperature),
+			nullable(obs.leafwetness_timeratio1),
+			nullable(obs.soilmoistures10cm),
+			nullable(obs.soilmoistures20cm),
+			nullable(obs.soilmoistures30cm),
+			nullable(obs.soilmoistures40cm),
+			nullable(obs.soilmoistures50cm),
+			nullable(obs.soilmoistures60cm),
+			nullable(obs.soiltemp10cm),
+			nullable(obs.soiltemp20cm),
+			nullable(obs.soiltemp30cm),
+			nullable(obs.soiltemp40cm),
+			nullable(obs.soiltemp50cm),
+			nullable(obs.soiltemp60cm),
+			nullable(obs.leafwetness_percent1),
+			nullable(obs.soil_conductivity1),
+			nullable(obs.voltage_battery),
+			nullable(obs.voltage_solar_panel),
+			nullable(obs.voltage_backup)
 		);
 	}
 
+	void DbConnectionObservations::createObservationsStagingTable(pqxx::transaction_base& tx)
+	{
+		// The table lives as long as the connection and is emptied at
+		// the end of each transaction, the rows are numbered in the
+		// order they are copied
+		tx.exec(
+			"CREATE TEMPORARY TABLE IF NOT EXISTS " + OBSERVATIONS_STAGING_TABLE +
+			" (LIKE meteodata.observations INCLUDING DEFAULTS, rank BIGSERIAL) ON COMMIT DELETE ROWS"
+		);
+	}
+
+	void DbConnectionObservations::mergeObservationsStagingTable(pqxx::transaction_base& tx)
+	{
+		static const std::string query = []() {
+			std::string columns;
+			std::string values;
+			std::string updates;
+			for (const std::string& column : OBSERVATIONS_COLUMNS) {
+				if (!columns.empty()) {
+					columns += ",";
+					values += ",";
+				}
+				columns += column;
+				if (column == "station" || column == "datetime") {
+					values += column;
+					continue;
+				}
+				// The last non-null value copied, as if the
+				// observations had been upserted one by one
+				values += "(array_agg(" + column + " ORDER BY rank DESC) FILTER (WHERE " + column + " IS NOT NULL))[1]";
+				if (!updates.empty())
+					updates += ",";
+				updates += column + "=COALESCE(EXCLUDED." + column + ", meteodata.observations." + column + ")";
+			}
+
+			// A single INSERT cannot update the same row twice, the
+			// observations sharing the same (station, datetime) are
+			// folded column by column first
+			return "INSERT INTO meteodata.observations (" + columns + ") "
+				" SELECT " + values +
+				" FROM " + OBSERVATIONS_STAGING_TABLE +
+				" GROUP BY station, datetime "
+				" ON CONFLICT (station, datetime) DO UPDATE SET " + updates;
+		}();
+
+		QueryTrace trace{*_mergeObservationsMetrics};
+		tx.exec(query);
+		trace.stop();
+	}
+
 	bool DbConnectionObservations::insertV2EntireDayValues(const CassUuid station, const time_t& time, std::pair<bool, float> rainfall24, std::pair<bool, int> insolationTime24)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertEntireDayValues.get()),
+			_insertEntireDayValues.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		cass_statement_bind_uint32(statement.get(), 1, cass_date_from_epoch(time));
 		cass_statement_bind_int64(statement.get(), 2, time * 1000);
@@ -1544,7 +2010,7 @@ namespace meteodata {
 		if (insolationTime24.first)
 			cass_statement_bind_int32(statement.get(), 4, insolationTime24.second);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertEntireDayValues, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1566,9 +2032,11 @@ namespace meteodata {
 	bool DbConnectionObservations::insertV2Tx(const CassUuid station, const time_t& time, float tx)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertTx.get()),
+			_insertTx.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 
 		std::chrono::system_clock::time_point tp{std::chrono::seconds{time}};
 		auto daypoint = date::floor<date::days>(tp);
@@ -1589,7 +2057,7 @@ namespace meteodata {
 		cass_statement_bind_int64(statement.get(), 2, correctedTime * 1000);
 		cass_statement_bind_float(statement.get(), 3, tx);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertTx, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1611,9 +2079,11 @@ namespace meteodata {
 	bool DbConnectionObservations::insertV2Tn(const CassUuid station, const time_t& time, float tn)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertTn.get()),
+			_insertTn.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 
 		std::chrono::system_clock::time_point tp{std::chrono::seconds{time}};
 		auto daypoint = date::floor<date::days>(tp);
@@ -1634,7 +2104,7 @@ namespace meteodata {
 		cass_statement_bind_int64(statement.get(), 2, correctedTime * 1000);
 		cass_statement_bind_float(statement.get(), 3, tn);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertTn, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1656,12 +2126,14 @@ namespace meteodata {
 	bool DbConnectionObservations::insertMonitoringDataPoint(const CassUuid station, const Message& msg)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertDataPointInMonitoringDB.get()),
+			_insertDataPointInMonitoringDB.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		msg.populateV2DataPoint(station, statement.get());
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertDataPointInMonitoringDB, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1683,14 +2155,16 @@ namespace meteodata {
 	bool DbConnectionObservations::updateLastArchiveDownloadTime(const CassUuid station, const time_t& time)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_updateLastArchiveDownloadTime.get()),
+			_updateLastArchiveDownloadTime.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_bind_int64(statement.get(), 0, time * 1000);
 		cass_statement_bind_uuid(statement.get(), 1, station);
 
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_updateLastArchiveDownloadTime, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -1704,6 +2178,8 @@ namespace meteodata {
 			size_t error_message_length;
 			cass_future_error_message(query.get(), &error_message, &error_message_length);
 			ret = false;
+		} else {
+			_stationCache.updateLastArchiveDownloadTime(station, time);
 		}
 
 		return ret;
@@ -1711,7 +2187,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllWeatherlinkStations(std::vector<std::tuple<CassUuid, std::string, std::string, int>>& stations)
 	{
-		return performSelect(_selectWeatherlinkStations.get(),
+		return performSelect(_selectWeatherlinkStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -1756,7 +2232,7 @@ namespace meteodata {
 	bool DbConnectionObservations::getAllWeatherlinkAPIv2Stations(std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string,
 			std::map<int, std::map<std::string, std::string>> >>& stations)
 	{
-		return performSelect(_selectWeatherlinkAPIv2Stations.get(),
+		return performSelect(_selectWeatherlinkAPIv2Stations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -1840,7 +2316,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getMqttStations(std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>>& stations)
 	{
-		return performSelect(_selectMqttStations.get(),
+		return performSelect(_selectMqttStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -1904,7 +2380,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getStatICTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>>& stations)
 	{
-		return performSelect(_selectStatICTxtStations.get(),
+		return performSelect(_selectStatICTxtStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -1974,7 +2450,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getMBDataTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>>& stations)
 	{
-		return performSelect(_selectMBDataTxtStations.get(),
+		return performSelect(_selectMBDataTxtStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -2028,36 +2504,17 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllIcaos(std::vector<std::tuple<CassUuid, std::string>>& stations)
 	{
-		return performSelect(_selectAllIcaos.get(),
-			[&stations](const CassRow* row) {
-				const CassValue* v = cass_row_get_column(row, 0);
-				if (cass_value_is_null(v))
-					return;
-				CassUuid station;
-				cass_value_get_uuid(v, &station);
-
-				v = cass_row_get_column(row, 1);
-				if (cass_value_is_null(v))
-					return;
-				const char *icaoStr;
-				size_t icaoLength;
-				cass_value_get_string(v, &icaoStr, &icaoLength);
-
-				v = cass_row_get_column(row, 2);
-				if (cass_value_is_null(v))
-					return;
-				cass_bool_t active;
-				cass_value_get_bool(v, &active);
-
-				if (icaoLength != 0 && active == cass_true)
-					stations.emplace_back(station, std::string{icaoStr, icaoLength});
+		return performTypedSelect<CassUuid, std::string_view, bool>(_selectAllIcaos,
+			[&stations](const std::pair<bool, CassUuid>& station, const std::pair<bool, std::string_view>& icao, const std::pair<bool, bool>& active) {
+				if (station.first && icao.first && active.first && !icao.second.empty() && active.second)
+					stations.emplace_back(station.second, std::string{icao.second});
 			}
 		);
 	}
 
 	bool DbConnectionObservations::getDeferredSynops(std::vector<std::tuple<CassUuid, std::string>>& stations)
 	{
-		return performSelect(_selectDeferredSynops.get(),
+		return performSelect(_selectDeferredSynops,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -2078,7 +2535,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllFieldClimateApiStations(std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>>& stations)
 	{
-		return performSelect(_selectFieldClimateApiStations.get(),
+		return performSelect(_selectFieldClimateApiStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -2133,7 +2590,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllObjeniousApiStations(std::vector<std::tuple<CassUuid, std::string, std::map<std::string, std::string>>>& stations)
 	{
-		return performSelect(_selectObjeniousApiStations.get(),
+		return performSelect(_selectObjeniousApiStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -2181,36 +2638,11 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllLiveobjectsStations(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations)
 	{
-		return performSelect(_selectLiveobjectsStations.get(),
-			[&stations](const CassRow* row) {
-				 const CassValue* v = cass_row_get_column(row, 0);
-				 if (cass_value_is_null(v))
-					 return;
-				 CassUuid station;
-				 cass_value_get_uuid(v, &station);
-
-				 v = cass_row_get_column(row, 1);
-				 if (cass_value_is_null(v))
-					 return;
-				 cass_bool_t active;
-				 cass_value_get_bool(v, &active);
-
-				 v = cass_row_get_column(row, 2);
-				 if (cass_value_is_null(v))
-					 return;
-				 const char *streamId;
-				 size_t sizeStreamId;
-				 cass_value_get_string(v, &streamId, &sizeStreamId);
-
-				 v = cass_row_get_column(row, 3);
-				 if (cass_value_is_null(v))
-					 return;
-				 const char *topicId;
-				 size_t sizeTopicId;
-				 cass_value_get_string(v, &topicId, &sizeTopicId);
-
-				 if (active == cass_true)
-					 stations.emplace_back(station, std::string{streamId, sizeStreamId}, std::string{topicId, sizeTopicId});
+		return performTypedSelect<CassUuid, bool, std::string_view, std::string_view>(_selectLiveobjectsStations,
+			[&stations](const std::pair<bool, CassUuid>& station, const std::pair<bool, bool>& active,
+			            const std::pair<bool, std::string_view>& streamId, const std::pair<bool, std::string_view>& topicId) {
+				if (station.first && active.first && streamId.first && topicId.first && active.second)
+					stations.emplace_back(station.second, std::string{streamId.second}, std::string{topicId.second});
 			}
 		);
 	}
@@ -2218,43 +2650,18 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllCimelStations(std::vector<std::tuple<CassUuid, std::string, int>>& stations)
 	{
-		return performSelect(_selectCimelStations.get(),
-				[&stations](const CassRow* row) {
-					const CassValue* v = cass_row_get_column(row, 0);
-					if (cass_value_is_null(v))
-						return;
-					CassUuid station;
-					cass_value_get_uuid(v, &station);
-
-					v = cass_row_get_column(row, 1);
-					if (cass_value_is_null(v))
-						return;
-					cass_bool_t active;
-					cass_value_get_bool(v, &active);
-
-					v = cass_row_get_column(row, 2);
-					if (cass_value_is_null(v))
-						return;
-					const char *cimelId;
-					size_t sizeCimelId;
-					cass_value_get_string(v, &cimelId, &sizeCimelId);
-
-					int timezone;
-					v = cass_row_get_column(row, 3);
-					if (cass_value_is_null(v))
-						timezone = 0;
-					else
-						cass_value_get_int32(cass_row_get_column(row,3), &timezone);
-
-					if (active == cass_true)
-						stations.emplace_back(station, std::string{cimelId, sizeCimelId}, timezone);
-				}
+		return performTypedSelect<CassUuid, bool, std::string_view, int>(_selectCimelStations,
+			[&stations](const std::pair<bool, CassUuid>& station, const std::pair<bool, bool>& active,
+			            const std::pair<bool, std::string_view>& cimelId, const std::pair<bool, int>& timezone) {
+				if (station.first && active.first && cimelId.first && active.second)
+					stations.emplace_back(station.second, std::string{cimelId.second}, timezone.first ? timezone.second : 0);
+			}
 		);
 	}
 
 	bool DbConnectionObservations::getMeteoFranceStations(std::vector<std::tuple<CassUuid, std::string, std::string, int, float, float, int, int>>& stations)
 	{
-		return performSelect(_selectMeteoFranceStations.get(),
+		return performSelect(_selectMeteoFranceStations,
 				[&stations](const CassRow* row) {
 					const CassValue* v = cass_row_get_column(row, 0);
 					if (cass_value_is_null(v))
@@ -2327,7 +2734,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllNbiotStations(std::vector<NbiotStation>& stations)
 	{
-		return performSelect(_selectNbiotStations.get(),
+		return performSelect(_selectNbiotStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -2379,7 +2786,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getAllVirtualStations(std::vector<VirtualStation>& stations)
 	{
-		return performSelect(_selectVirtualStations.get(),
+		return performSelect(_selectVirtualStations,
 			[&stations](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -2438,25 +2845,70 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall)
 	{
-		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_getRainfall.get()),
-			cass_statement_free
-		};
-		cass_statement_set_is_idempotent(statement.get(), cass_true);
+		date::sys_seconds b{chrono::seconds(begin)};
+		date::sys_seconds e{chrono::seconds(end)};
+		rainfall = 0;
+		if (e <= b)
+			return true;
 
-		date::sys_seconds day(date::floor<date::days>(chrono::system_clock::from_time_t(begin)));
-		date::sys_seconds final{chrono::seconds(end)};
-		bool ret = true;
+		// The rollups cover whole hours and days, only the edges of the
+		// period are read from the observations
+		date::sys_seconds firstHour = date::ceil<chrono::hours>(b);
+		date::sys_seconds lastHour = date::floor<chrono::hours>(e);
+		if (firstHour >= lastHour || !hasRainfallRollups())
+			return getRawRainfall(station, b, e, rainfall);
+
+		float head, tail;
+		if (!getRawRainfall(station, b, firstHour, head) || !getRawRainfall(station, lastHour, e, tail))
+			return false;
+
+		date::sys_days firstDay = date::ceil<date::days>(firstHour);
+		date::sys_days lastDay = date::floor<date::days>(lastHour);
+		float middle = 0;
+		if (firstDay >= lastDay) {
+			if (!getHourlyRainfall(station, firstHour, lastHour, middle))
+				return false;
+		} else {
+			float before, days, after;
+			if (!getHourlyRainfall(station, firstHour, firstDay, before) ||
+			    !getDailyRainfall(station, firstDay, lastDay, days) ||
+			    !getHourlyRainfall(station, lastDay, lastHour, after))
+				return false;
+			middle = before + days + after;
+		}
+
+		rainfall = head + middle + tail;
+		return true;
+	}
+
+	bool DbConnectionObservations::getRawRainfall(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end, float& rainfall)
+	{
 		rainfall = 0;
-		while (day < final && ret) {
-			cass_statement_bind_uuid(statement.get(), 0, station);
-			cass_statement_bind_uint32(statement.get(), 1, cass_date_from_epoch(chrono::system_clock::to_time_t(day)));
-			cass_statement_bind_int64(statement.get(), 2, begin * 1000);
-			cass_statement_bind_int64(statement.get(), 3, end * 1000);
-			std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-				cass_session_execute(_session.get(), statement.get()),
-				cass_future_free
+		if (end <= begin)
+			return true;
+		if (!_getRainfall.get())
+			return false;
+
+		// The observations in (begin, end] are in the partitions of the
+		// days of begin to end, they are all queried at once
+		std::vector<std::unique_ptr<CassFuture, void(&)(CassFuture*)>> queries;
+		// An observation at midnight is in the partition of the day it
+		// starts
+		for (date::sys_days day = date::floor<date::days>(begin) ; day <= date::floor<date::days>(end) ; day += date::days(1)) {
+			std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
+				_getRainfall.bind(),
+				cass_statement_free
 			};
+			cass_statement_set_is_idempotent(statement.get(), cass_true);
+			cass_statement_bind_uuid(statement.get(), 0, station);
+			cass_statement_bind_uint32(statement.get(), 1, from_sysdays_to_CassandraDate(day));
+			cass_statement_bind_int64(statement.get(), 2, from_systime_to_CassandraDateTime(begin));
+			cass_statement_bind_int64(statement.get(), 3, from_systime_to_CassandraDateTime(end));
+			queries.emplace_back(execute(_getRainfall, statement.get(), &station), cass_future_free);
+		}
+
+		bool ret = true;
+		for (auto& query : queries) {
 			std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
 				cass_future_get_result(query.get()),
 				cass_result_free
@@ -2475,26 +2927,202 @@ namespace meteodata {
 			} else {
 				ret = false;
 			}
+		}
 
-			day += date::days(1);
+		return ret;
+	}
+
+	bool DbConnectionObservations::getHourlyRainfall(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end, float& rainfall)
+	{
+		rainfall = 0;
+		bool ret = true;
+		for (date::sys_days day = date::floor<date::days>(begin) ; ret && day < end ; day += date::days(1)) {
+			date::sys_seconds from = std::max<date::sys_seconds>(begin, day);
+			date::sys_seconds to = std::min<date::sys_seconds>(end, day + date::days(1));
+
+			std::vector<date::sys_seconds> found;
+			ret = performTypedSelect<date::sys_seconds, float>(_selectRainfallHourly,
+				[&](const std::pair<bool, date::sys_seconds>& hour, const std::pair<bool, float>& value) {
+					found.push_back(hour.second);
+					if (value.first)
+						rainfall += value.second;
+				},
+				[&](CassStatement* stmt) {
+					cass_statement_bind_uuid(stmt, 0, station);
+					cass_statement_bind_uint32(stmt, 1, from_sysdays_to_CassandraDate(day));
+					cass_statement_bind_int64(stmt, 2, from_systime_to_CassandraDateTime(from));
+					cass_statement_bind_int64(stmt, 3, from_systime_to_CassandraDateTime(to));
+				},
+				&station
+			);
+
+			// Read the observations of the hours not rolled up yet,
+			// or waiting to be recomputed, one query per run of
+			// consecutive missing hours
+			std::vector<date::sys_seconds> pending = _rainfallRollups.pendingHours(station, from, to);
+			auto isRolledUp = [&](const date::sys_seconds& hour) {
+				return std::binary_search(found.begin(), found.end(), hour) &&
+					!std::binary_search(pending.begin(), pending.end(), hour);
+			};
+			date::sys_seconds hour = from;
+			while (ret && hour < to) {
+				if (isRolledUp(hour)) {
+					hour += chrono::hours(1);
+					continue;
+				}
+				date::sys_seconds gapEnd = hour + chrono::hours(1);
+				while (gapEnd < to && !isRolledUp(gapEnd))
+					gapEnd += chrono::hours(1);
+				float raw;
+				ret = getRawRainfall(station, hour, gapEnd, raw);
+				rainfall += raw;
+				hour = gapEnd;
+			}
 		}
 
 		return ret;
 	}
 
+	bool DbConnectionObservations::getDailyRainfall(const CassUuid& station, const date::sys_days& begin, const date::sys_days& end, float& rainfall)
+	{
+		rainfall = 0;
+		std::vector<date::sys_days> found;
+		bool ret = performTypedSelect<date::sys_days, float>(_selectRainfallDaily,
+			[&](const std::pair<bool, date::sys_days>& day, const std::pair<bool, float>& value) {
+				found.push_back(day.second);
+				if (value.first)
+					rainfall += value.second;
+			},
+			[&](CassStatement* stmt) {
+				cass_statement_bind_uuid(stmt, 0, station);
+				cass_statement_bind_uint32(stmt, 1, from_sysdays_to_CassandraDate(begin));
+				cass_statement_bind_uint32(stmt, 2, from_sysdays_to_CassandraDate(end));
+			},
+			&station
+		);
+
+		// Read the observations of the days not rolled up yet, or with
+		// hours waiting to be recomputed, one query per run of
+		// consecutive missing days
+		std::vector<date::sys_seconds> pending = _rainfallRollups.pendingHours(station, begin, end);
+		auto isRolledUp = [&](const date::sys_days& day) {
+			auto firstPending = std::lower_bound(pending.begin(), pending.end(), date::sys_seconds{day});
+			return std::binary_search(found.begin(), found.end(), day) &&
+				(firstPending == pending.end() || *firstPending >= day + date::days(1));
+		};
+		date::sys_days day = begin;
+		while (ret && day < end) {
+			if (isRolledUp(day)) {
+				day += date::days(1);
+				continue;
+			}
+			date::sys_days gapEnd = day + date::days(1);
+			while (gapEnd < end && !isRolledUp(gapEnd))
+				gapEnd += date::days(1);
+			float raw;
+			ret = getRawRainfall(station, day, gapEnd, raw);
+			rainfall += raw;
+			day = gapEnd;
+		}
+
+		return ret;
+	}
+
+	bool DbConnectionObservations::hasRainfallRollups() const
+	{
+		return _insertRainfallHourly.get() && _selectRainfallHourly.get() &&
+			_insertRainfallDaily.get() && _selectRainfallDaily.get();
+	}
+
+	bool DbConnectionObservations::updateRainfallRollup(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end)
+	{
+		// Without the rollup tables, getRainfall() reads the
+		// observations and there is nothing to update
+		if (end <= begin || !hasRainfallRollups())
+			return true;
+
+		auto run = [this, &station](const CassandraStmtPtr& stmt, CassStatement* statement) {
+			cass_statement_set_is_idempotent(statement, cass_true);
+			std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
+				execute(stmt, statement, &station),
+				cass_future_free
+			};
+			std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
+				cass_future_get_result(query.get()),
+				cass_result_free
+			};
+
+			return bool(result);
+		};
+
+		// The bucket of hour H covers (H, H+1h]
+		date::sys_seconds firstHour = date::floor<chrono::hours>(begin);
+		date::sys_seconds lastHour = date::floor<chrono::hours>(end - chrono::seconds(1));
+
+		bool ret = true;
+		for (date::sys_seconds hour = firstHour ; ret && hour <= lastHour ; hour += chrono::hours(1)) {
+			float rainfall;
+			ret = getRawRainfall(station, hour, hour + chrono::hours(1), rainfall);
+			if (!ret)
+				break;
+
+			std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
+				_insertRainfallHourly.bind(),
+				cass_statement_free
+			};
+			cass_statement_bind_uuid(statement.get(), 0, station);
+			cass_statement_bind_uint32(statement.get(), 1, from_sysdays_to_CassandraDate(date::floor<date::days>(hour)));
+			cass_statement_bind_int64(statement.get(), 2, from_systime_to_CassandraDateTime(hour));
+			cass_statement_bind_float(statement.get(), 3, rainfall);
+			ret = run(_insertRainfallHourly, statement.get());
+		}
+
+		for (date::sys_days day = date::floor<date::days>(firstHour) ; ret && day <= date::floor<date::days>(lastHour) ; day += date::days(1)) {
+			// The hours of the day which have not been rolled up are
+			// read from the observations
+			float rainfall;
+			ret = getHourlyRainfall(station, day, day + date::days(1), rainfall);
+			if (!ret)
+				break;
+
+			std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
+				_insertRainfallDaily.bind(),
+				cass_statement_free
+			};
+			cass_statement_bind_uuid(statement.get(), 0, station);
+			cass_statement_bind_uint32(statement.get(), 1, from_sysdays_to_CassandraDate(day));
+			cass_statement_bind_float(statement.get(), 2, rainfall);
+			ret = run(_insertRainfallDaily, statement.get());
+		}
+
+		return ret;
+	}
+
+	bool DbConnectionObservations::rebuildRainfallRollup(const CassUuid& station, time_t begin, time_t end)
+	{
+		// Go through the queue so that the buckets are not recomputed
+		// concurrently by the background thread
+		_rainfallRollups.push(station,
+			date::sys_seconds{chrono::seconds(begin)},
+			date::sys_seconds{chrono::seconds(end)});
+		return _rainfallRollups.flush();
+	}
+
 	bool DbConnectionObservations::deleteDataPoints(const CassUuid& station, const date::sys_days& day, const date::sys_seconds& start, const date::sys_seconds& end)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_deleteDataPoints.get()),
+			_deleteDataPoints.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		cass_statement_bind_uint32(statement.get(), 1, from_sysdays_to_CassandraDate(day));
 		cass_statement_bind_int64(statement.get(), 2, from_systime_to_CassandraDateTime(start));
 		cass_statement_bind_int64(statement.get(), 3, from_systime_to_CassandraDateTime(end));
 
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_deleteDataPoints, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -2509,20 +3137,29 @@ namespace meteodata {
 			cass_future_error_message(query.get(), &error_message, &error_message_length);
 			ret = false;
 		}
-
-		std::lock_guard locked{_pqTransactionMutex};
-		pqxx::work tx{_pqConnection};
+		_mapAggregator.invalidate(station);
+		if (_dailyAggregator)
+			_dailyAggregator->invalidate(station);
+		// The observations of the partition are in [day, day+1d)
+		_rainfallRollups.push(station,
+			std::max<date::sys_seconds>(start, day - chrono::seconds(1)),
+			std::min<date::sys_seconds>(end, day + date::days(1)));
+
+		auto connection = _pqConnections.checkout();
+		pqxx::work tx{*connection};
 		auto realStart = start < day ? day : start;
 		auto endOfDay = day + date::days{1};
 		auto realEnd = end > endOfDay ? endOfDay : end;
 		try {
 			char uuid[CASS_UUID_STRING_LENGTH];
 			cass_uuid_string(station, uuid);
+			QueryTrace trace{_pqConnections.metrics(DELETE_DATA_POINTS), &station};
 			tx.exec_prepared0(DELETE_DATA_POINTS,
 				uuid,
 				date::format("%F %TZ", realStart),
 				date::format("%F %TZ", realEnd)
 			);
+			trace.stop();
 			tx.commit();
 		} catch (const pqxx::pqxx_exception& e) {
 			ret = false;
@@ -2534,16 +3171,18 @@ namespace meteodata {
 	bool DbConnectionObservations::getTx(const CassUuid& station, time_t boundary, std::pair<bool, float>& value)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectTx.get()),
+			_selectTx.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 
 		cass_statement_set_is_idempotent(statement.get(), cass_true);
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		cass_statement_bind_uint32(statement.get(), 1, cass_date_from_epoch(boundary));
 		cass_statement_bind_int64(statement.get(), 2, boundary * 1000);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_selectTx, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -2573,16 +3212,18 @@ namespace meteodata {
 	bool DbConnectionObservations::getTn(const CassUuid& station, time_t boundary, std::pair<bool, float>& value)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectTn.get()),
+			_selectTn.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 
 		cass_statement_set_is_idempotent(statement.get(), cass_true);
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		cass_statement_bind_uint32(statement.get(), 1, cass_date_from_epoch(boundary));
 		cass_statement_bind_int64(statement.get(), 2, boundary * 1000);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_selectTn, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -2609,18 +3250,23 @@ namespace meteodata {
 		return ret;
 	}
 
-	bool DbConnectionObservations::getCachedInt(const CassUuid& station, const std::string& key, time_t& lastUpdate, int& value)
+	bool DbConnectionObservations::getCachedValue(const CassUuid& station, const std::string& key, std::optional<StationValueCache::Value>& value)
 	{
+		if (_cachedValues.lookup(station, key, value))
+			return true;
+
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectCached.get()),
+			_selectCached.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 
 		cass_statement_set_is_idempotent(statement.get(), cass_true);
 		cass_statement_bind_uuid(statement.get(), 0, station);
 		cass_statement_bind_string_n(statement.get(), 1, key.data(), key.length());
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_selectCached, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -2628,164 +3274,108 @@ namespace meteodata {
 			cass_result_free
 		};
 
-		bool ret = false;
-		if (result) {
-			const CassRow* row = cass_result_first_row(result.get());
-			if (row) {
-				ret = true;
-				const CassValue* v = cass_row_get_column(row, 0);
-				if (!cass_value_is_null(v)) {
-					cass_int64_t cassTimestamp;
-					cass_value_get_int64(v, &cassTimestamp);
-					lastUpdate = cassTimestamp / 1000;
-				} else {
-					ret = false;
-				}
+		if (!result)
+			return false;
 
-				v = cass_row_get_column(row, 1);
-				if (ret && !cass_value_is_null(v)) {
-					int i;
-					cass_value_get_int32(v, &i);
-					value = i;
-				} else {
-					ret = false;
-				}
-				// column 2 is not parsed
-			}
+		value.reset();
+		const CassRow* row = cass_result_first_row(result.get());
+		// values without a time are considered absent
+		if (row && !cass_value_is_null(cass_row_get_column(row, 0))) {
+			cass_int64_t cassTimestamp;
+			cass_value_get_int64(cass_row_get_column(row, 0), &cassTimestamp);
+			value = StationValueCache::Value{cassTimestamp / 1000};
+			storeCassandraInt(row, 1, value->intValue);
+			storeCassandraFloat(row, 2, value->floatValue);
 		}
 
-		return ret;
+		_cachedValues.load(station, key, value);
+		// another thread may have updated the value in the meantime
+		_cachedValues.lookup(station, key, value);
+		return true;
 	}
 
-	bool DbConnectionObservations::getCachedFloat(const CassUuid& station, const std::string& key, time_t& lastUpdate, float& value)
+	bool DbConnectionObservations::getCachedInt(const CassUuid& station, const std::string& key, time_t& lastUpdate, int& value)
 	{
-		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_selectCached.get()),
-			cass_statement_free
-		};
-
-		cass_statement_set_is_idempotent(statement.get(), cass_true);
-		cass_statement_bind_uuid(statement.get(), 0, station);
-		cass_statement_bind_string_n(statement.get(), 1, key.data(), key.length());
-		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
-			cass_future_free
-		};
-		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
-			cass_future_get_result(query.get()),
-			cass_result_free
-		};
+		std::optional<StationValueCache::Value> cached;
+		if (!getCachedValue(station, key, cached) || !cached || !cached->intValue.first)
+			return false;
 
-		bool ret = false;
-		if (result) {
-			const CassRow* row = cass_result_first_row(result.get());
-			if (row) {
-				ret = true;
-				const CassValue* v = cass_row_get_column(row, 0);
-				if (!cass_value_is_null(v)) {
-					cass_int64_t cassTimestamp;
-					cass_value_get_int64(v, &cassTimestamp);
-					lastUpdate = cassTimestamp / 1000;
-				} else {
-					ret = false;
-				}
+		lastUpdate = cached->time;
+		value = cached->intValue.second;
+		return true;
+	}
 
-				// column 1 is not parsed
-				v = cass_row_get_column(row, 2);
-				if (ret && !cass_value_is_null(v)) {
-					float f;
-					cass_value_get_float(v, &f);
-					value = f;
-				} else {
-					ret = false;
-				}
-			}
-		}
+	bool DbConnectionObservations::getCachedFloat(const CassUuid& station, const std::string& key, time_t& lastUpdate, float& value)
+	{
+		std::optional<StationValueCache::Value> cached;
+		if (!getCachedValue(station, key, cached) || !cached || !cached->floatValue.first)
+			return false;
 
-		return ret;
+		lastUpdate = cached->time;
+		value = cached->floatValue.second;
+		return true;
 	}
 
 	bool DbConnectionObservations::cacheInt(const CassUuid& station, const std::string& key, const time_t& update, int value)
 	{
-		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertIntoCache.get()),
-			cass_statement_free
-		};
-
-
-		time_t previousTime;
-		int previousValue;
-		bool alreadyPresent = getCachedInt(station, key, previousTime, previousValue);
-		if (alreadyPresent && previousTime > update) {
-			// there's already a value and it's more recent, don't
-			// insert the new one
+		std::optional<StationValueCache::Value> previous;
+		if (!getCachedValue(station, key, previous))
 			return false;
-		}
-
-
-		cass_statement_bind_uuid(statement.get(), 0, station);
-		cass_statement_bind_string_n(statement.get(), 1, key.data(), key.length());
-		cass_statement_bind_int64(statement.get(), 2, update * 1000);
-		cass_statement_bind_int32(statement.get(), 3, value);
-		// field 4 intentionally not filled in
-		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
-			cass_future_free
-		};
-		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
-			cass_future_get_result(query.get()),
-			cass_result_free
-		};
 
-		bool ret = true;
-		if (!result) {
-			const char* error_message;
-			size_t error_message_length;
-			cass_future_error_message(query.get(), &error_message, &error_message_length);
-			ret = false;
-		}
-
-		return ret;
+		StationValueCache::Write write{station, key, {update}};
+		write.value.intValue = { true, value };
+		return _cachedValues.update(write);
 	}
 
 	bool DbConnectionObservations::cacheFloat(const CassUuid& station, const std::string& key, const time_t& update, float value)
 	{
-		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertIntoCache.get()),
-			cass_statement_free
-		};
+		std::optional<StationValueCache::Value> previous;
+		if (!getCachedValue(station, key, previous))
+			return false;
 
+		StationValueCache::Write write{station, key, {update}};
+		write.value.floatValue = { true, value };
+		return _cachedValues.update(write);
+	}
 
-		time_t previousTime;
-		float previousValue;
-		bool alreadyPresent = getCachedFloat(station, key, previousTime, previousValue);
-		if (alreadyPresent && previousTime > update) {
-			// there's already a value and it's more recent, don't
-			// insert the new one
+	bool DbConnectionObservations::writeCachedValues(const std::vector<StationValueCache::Write>& writes)
+	{
+		// The cache keeps the writes for the next flush if the
+		// statement is not available
+		if (!_insertIntoCache.get())
 			return false;
-		}
-
 
-		cass_statement_bind_uuid(statement.get(), 0, station);
-		cass_statement_bind_string_n(statement.get(), 1, key.data(), key.length());
-		cass_statement_bind_int64(statement.get(), 2, update * 1000);
-		// field 3 intentionally not filled in
-		cass_statement_bind_float(statement.get(), 4, value);
-		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
-			cass_future_free
-		};
-		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
-			cass_future_get_result(query.get()),
-			cass_result_free
-		};
+		// The rows are in different partitions, they are inserted
+		// concurrently rather than in a batch
+		std::vector<std::unique_ptr<CassFuture, void(&)(CassFuture*)>> queries;
+		for (const StationValueCache::Write& write : writes) {
+			std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
+				_insertIntoCache.bind(),
+				cass_statement_free
+			};
+			cass_statement_set_is_idempotent(statement.get(), cass_true);
+			cass_statement_bind_uuid(statement.get(), 0, write.station);
+			cass_statement_bind_string_n(statement.get(), 1, write.key.data(), write.key.length());
+			cass_statement_bind_int64(statement.get(), 2, write.value.time * 1000);
+			// the values not updated are left unset
+			bindCassandraInt(statement.get(), 3, write.value.intValue);
+			bindCassandraFloat(statement.get(), 4, write.value.floatValue);
+			queries.emplace_back(execute(_insertIntoCache, statement.get(), &write.station), cass_future_free);
+		}
 
 		bool ret = true;
-		if (!result) {
-			const char* error_message;
-			size_t error_message_length;
-			cass_future_error_message(query.get(), &error_message, &error_message_length);
-			ret = false;
+		for (auto& query : queries) {
+			std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
+				cass_future_get_result(query.get()),
+				cass_result_free
+			};
+
+			if (!result) {
+				const char* error_message;
+				size_t error_message_length;
+				cass_future_error_message(query.get(), &error_message, &error_message_length);
+				ret = false;
+			}
 		}
 
 		return ret;
@@ -2966,40 +3556,124 @@ namespace meteodata {
 			}
 		};
 
-		bool r = performSelect(_selectMapValues.get(),
+		bool r = performSelect(_selectMapValues,
 			handleResponse,
 			[&](CassStatement* stmt) {
 				cass_statement_bind_uuid(stmt, 0, uuid);
 				cass_statement_bind_uint32(stmt, 1, cass_date_from_epoch(time));
-			}
+			},
+			&uuid
 		);
 
 		if (r) {
-			r = performSelect(_selectMapValues.get(),
+			r = performSelect(_selectMapValues,
 				handleResponse,
 				[&](CassStatement* stmt) {
 					cass_statement_bind_uuid(stmt, 0, uuid);
 					cass_statement_bind_uint32(stmt, 1, cass_date_from_epoch(time - 24 * 3600));
-				}
+				},
+				&uuid
 			);
 		}
 
 		if (r) {
-			r = performSelect(_selectMapValues.get(),
+			r = performSelect(_selectMapValues,
 				handleResponse,
 				[&](CassStatement* stmt) {
 					cass_statement_bind_uuid(stmt, 0, uuid);
 					cass_statement_bind_uint32(stmt, 1, cass_date_from_epoch(time - 48 * 3600));
-				}
+				},
+				&uuid
+			);
+		}
+
+		return r;
+	}
+
+	bool DbConnectionObservations::computeMapValues(const Observation& obs, MapObservation& map)
+	{
+		MapAggregator::Sample sample{obs};
+		if (_mapAggregator.accumulate(obs.station, sample, map))
+			return true;
+
+		// Cold start, or the observation is older than the last one
+		// accumulated
+		std::vector<MapAggregator::Sample> history;
+		bool newerDataFound = false;
+		if (!getMapHistory(obs.station, chrono::system_clock::to_time_t(obs.time), history, newerDataFound))
+			return false;
+
+		_mapAggregator.reset(obs.station, history);
+		bool ret = _mapAggregator.accumulate(obs.station, sample, map);
+		// An old observation is being inserted, the window cannot be
+		// kept because it would miss the newer observations
+		if (newerDataFound)
+			_mapAggregator.invalidate(obs.station);
+		return ret;
+	}
+
+	bool DbConnectionObservations::getMapHistory(const CassUuid& uuid, time_t time, std::vector<MapAggregator::Sample>& history, bool& newerDataFound)
+	{
+		auto ref = chrono::system_clock::from_time_t(time);
+		auto t48h = ref - chrono::hours{48};
+
+		newerDataFound = false;
+		auto handleResponse = [&](const CassRow* row) {
+			const CassValue* v = cass_row_get_column(row, 0);
+			if (cass_value_is_null(v))
+				return;
+			cass_int64_t timeMillisec;
+			cass_value_get_int64(v, &timeMillisec);
+			auto t = chrono::system_clock::from_time_t(timeMillisec / 1000);
+
+			if (t > ref)
+				newerDataFound = true;
+			if (t <= t48h || t >= ref)
+				return;
+
+			MapAggregator::Sample sample;
+			sample.time = date::floor<chrono::seconds>(t);
+			storeCassandraFloat(row, 1, sample.outsideTemperature);
+			storeCassandraFloat(row, 2, sample.maxOutsideTemperature);
+			storeCassandraFloat(row, 3, sample.minOutsideTemperature);
+			storeCassandraFloat(row, 4, sample.rainfall);
+			storeCassandraFloat(row, 5, sample.et);
+			storeCassandraFloat(row, 6, sample.windgust);
+			history.push_back(sample);
+		};
+
+		bool r = true;
+		for (time_t day : { time, time - 24 * 3600, time - 48 * 3600 }) {
+			if (!r)
+				break;
+			r = performSelect(_selectMapValues,
+				handleResponse,
+				[&](CassStatement* stmt) {
+					cass_statement_bind_uuid(stmt, 0, uuid);
+					cass_statement_bind_uint32(stmt, 1, cass_date_from_epoch(day));
+				},
+				&uuid
 			);
 		}
 
 		return r;
 	}
 
+	void DbConnectionObservations::setDailyAggregator(DailyAggregator* aggregator)
+	{
+		_dailyAggregator = aggregator;
+	}
+
+	void DbConnectionObservations::invalidateMapValues(const CassUuid& station)
+	{
+		_mapAggregator.invalidate(station);
+		if (_dailyAggregator)
+			_dailyAggregator->invalidate(station);
+	}
+
 	bool DbConnectionObservations::getLastSchedulerDownloadTime(const std::string& station, time_t& lastArchiveDownloadTime)
 	{
-		return performSelect(_selectLastSchedulerDownloadTime.get(),
+		return performSelect(_selectLastSchedulerDownloadTime,
 			[&](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -3017,14 +3691,18 @@ namespace meteodata {
 	bool DbConnectionObservations::insertLastSchedulerDownloadTime(const std::string& scheduler, const time_t& time)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_insertLastSchedulerDownloadTime.get()),
+			_insertLastSchedulerDownloadTime.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_bind_string_n(statement.get(), 0, scheduler.c_str(), scheduler.length());
 		cass_statement_bind_int64(statement.get(), 1, time * 1000);
 
+		// The schedulers are not stations, there is none to report to
+		// the QueryObserver
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_insertLastSchedulerDownloadTime, statement.get(), nullptr),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -3045,7 +3723,7 @@ namespace meteodata {
 
 	bool DbConnectionObservations::getLastConfiguration(const CassUuid& station, ModemStationConfiguration& config)
 	{
-		return performSelect(_selectLastConfiguration.get(),
+		return performSelect(_selectLastConfiguration,
 			[&config](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -3082,13 +3760,14 @@ namespace meteodata {
 			},
 			[&](CassStatement* stmt) {
 				cass_statement_bind_uuid(stmt, 0, station);
-			}
+			},
+			&station
 		);
 	}
 
 	bool DbConnectionObservations::getOneConfiguration(const CassUuid& station, int id, ModemStationConfiguration& config)
 	{
-		return performSelect(_selectOneConfiguration.get(),
+		return performSelect(_selectOneConfiguration,
 			[&config](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -3126,13 +3805,14 @@ namespace meteodata {
 			[&](CassStatement* stmt) {
 				cass_statement_bind_uuid(stmt, 0, station);
 				cass_statement_bind_int32(stmt, 1, id);
-			}
+			},
+			&station
 		);
 	}
 
 	bool DbConnectionObservations::getOldestConfiguration(const CassUuid& station, ModemStationConfiguration& config)
 	{
-		return performSelect(_selectOldestConfiguration.get(),
+		return performSelect(_selectOldestConfiguration,
 			[&config](const CassRow* row) {
 				const CassValue* v = cass_row_get_column(row, 0);
 				if (cass_value_is_null(v))
@@ -3169,21 +3849,24 @@ namespace meteodata {
 			},
 			[&](CassStatement* stmt) {
 				cass_statement_bind_uuid(stmt, 0, station);
-			}
+			},
+			&station
 		);
 	}
 
 	bool DbConnectionObservations::updateConfigurationStatus(const CassUuid& station, int id, bool active)
 	{
 		std::unique_ptr<CassStatement, void(&)(CassStatement*)> statement{
-			cass_prepared_bind(_updateConfigurationStatus.get()),
+			_updateConfigurationStatus.bind(),
 			cass_statement_free
 		};
+		if (!statement)
+			return false;
 		cass_statement_bind_bool(statement.get(), 0, active ? cass_true : cass_false);
 		cass_statement_bind_uuid(statement.get(), 1, station);
 		cass_statement_bind_int32(statement.get(), 2, id);
 		std::unique_ptr<CassFuture, void(&)(CassFuture*)> query{
-			cass_session_execute(_session.get(), statement.get()),
+			execute(_updateConfigurationStatus, statement.get(), &station),
 			cass_future_free
 		};
 		std::unique_ptr<const CassResult, void(&)(const CassResult*)> result{
@@ -3206,11 +3889,12 @@ namespace meteodata {
 		const std::string& connector, const std::string& download,
 		bool inserted, const std::string& jobState)
 	{
-		std::lock_guard locked{_pqTransactionMutex};
-		pqxx::work tx{_pqConnection};
+		auto connection = _pqConnections.checkout();
+		pqxx::work tx{*connection};
 		try {
 			char uuid[CASS_UUID_STRING_LENGTH];
 			cass_uuid_string(station, uuid);
+			QueryTrace trace{_pqConnections.metrics(INSERT_DOWNLOAD), &station};
 			tx.exec_prepared0(INSERT_DOWNLOAD,
 				uuid,
 				date::format("%F %T%z", chrono::system_clock::from_time_t(datetime)),
@@ -3219,6 +3903,7 @@ namespace meteodata {
 				inserted,
 				jobState
 			);
+			trace.stop();
 			tx.commit();
 		} catch (const pqxx::pqxx_exception& e) {
 			return false;
@@ -3229,17 +3914,19 @@ namespace meteodata {
 	bool DbConnectionObservations::updateDownloadStatus(const CassUuid& station,
 		time_t datetime, bool inserted, const std::string& jobState)
 	{
-		std::lock_guard locked{_pqTransactionMutex};
-		pqxx::work tx{_pqConnection};
+		auto connection = _pqConnections.checkout();
+		pqxx::work tx{*connection};
 		try {
 			char uuid[CASS_UUID_STRING_LENGTH];
 			cass_uuid_string(station, uuid);
+			QueryTrace trace{_pqConnections.metrics(UPDATE_DOWNLOAD_STATUS), &station};
 			tx.exec_prepared0(UPDATE_DOWNLOAD_STATUS,
 				uuid,
 				date::format("%F %T%z", chrono::system_clock::from_time_t(datetime)),
 				inserted,
 				jobState
 			);
+			trace.stop();
 			tx.commit();
 		} catch (const pqxx::pqxx_exception& e) {
 			return false;
@@ -3250,15 +3937,18 @@ namespace meteodata {
 	bool DbConnectionObservations::selectDownloadsByStation(const CassUuid& station,
 		const std::string& connector, std::vector<Download>& downloads)
 	{
-		std::lock_guard locked{_pqTransactionMutex};
-		pqxx::work tx{_pqConnection};
+		auto connection = _pqConnections.checkout();
+		pqxx::work tx{*connection};
 		try {
 			char uuid[CASS_UUID_STRING_LENGTH];
 			cass_uuid_string(station, uuid);
+			QueryTrace trace{_pqConnections.metrics(SELECT_DOWNLOADS_BY_STATION), &station};
 			auto result = tx.exec_prepared(SELECT_DOWNLOADS_BY_STATION,
 				uuid,
 				connector
 			);
+			trace.addResult(result);
+			trace.stop();
 			for (const pqxx::row& r : result) {
 				Download d;
 				d.station = station;
@@ -3272,12 +3962,14 @@ namespace meteodata {
 				d.inserted = r[4].as<bool>(false);
 				d.jobState = r[5].as<std::string>("new");
 
+				QueryTrace updateTrace{_pqConnections.metrics(UPDATE_DOWNLOAD_STATUS), &station};
 				tx.exec_prepared0(UPDATE_DOWNLOAD_STATUS,
 					uuid,
 					date,
 					false,
 					"running"
 				);
+				updateTrace.stop();
 
 				downloads.push_back(std::move(d));
 			}
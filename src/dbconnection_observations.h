@@ -34,6 +34,9 @@
 #include <string>
 #include <map>
 #include <mutex>
+#include <future>
+#include <iostream>
+#include <optional>
 
 #include <cassandra.h>
 #include <date/date.h>
@@ -42,8 +45,16 @@
 #include "message.h"
 #include "dbconnection_common.h"
 #include "observation.h"
+#include "observation_storage.h"
 #include "map_observation.h"
+#include "daily_aggregator.h"
+#include "map_aggregator.h"
 #include "cassandra_stmt_ptr.h"
+#include "pq_connection_pool.h"
+#include "query_observer.h"
+#include "statement_metrics.h"
+#include "station_value_cache.h"
+#include "rainfall_rollup_queue.h"
 #include "virtual_station.h"
 #include "nbiot_station.h"
 #include "modem_station_configuration.h"
@@ -57,14 +68,35 @@ namespace meteodata {
 	 * connector to query details about the station and insert measures in
 	 * the database periodically.
 	 */
-	class DbConnectionObservations : public DbConnectionCommon
+	class DbConnectionObservations : public DbConnectionCommon, public ObservationStorage
 	{
 		public:
+			/**
+			 * @brief The ways observations can be inserted in
+			 * TimescaleDB
+			 */
+			enum class TimescaleDBInsertionMethod {
+				/**
+				 * @brief One prepared upsert statement per observation
+				 */
+				UPSERT,
+				/**
+				 * @brief A COPY into a staging table, merged into
+				 * the observations table by a single upsert
+				 */
+				COPY
+			};
+
 			/**
 			 * @brief Construct a connection to the database
 			 *
 			 * @param user the username to use
 			 * @param password the password corresponding to the username
+			 * @param options the tuning of the Cassandra session,
+			 * when to prepare the Cassandra statements (the
+			 * PostgreSQL statements are always prepared on their
+			 * first use on each connection) and the maximum number
+			 * of connections to the PostgreSQL database
 			 */
 			DbConnectionObservations(
 				const std::string& address = "127.0.0.1",
@@ -72,7 +104,8 @@ namespace meteodata {
 				const std::string& password = "",
 				const std::string& pgaddress = "127.0.0.1",
 				const std::string& pguser = "",
-				const std::string& pgpassword = ""
+				const std::string& pgpassword = "",
+				const ConnectionOptions& options = ConnectionOptions{}
 			);
 			/**
 			 * @brief Close the connection and destroy the database handle
@@ -190,21 +223,105 @@ namespace meteodata {
 			 * @return True is the measure data point could be succesfully
 			 * inserted, false otherwise
 			 */
-			bool insertV2DataPoint(const Observation& obs);
+			bool insertV2DataPoint(const Observation& obs) override;
+
+			/**
+			 * @brief Insert a new data point in the V2 database,
+			 * asynchronously
+			 *
+			 * This method does the same as \a insertV2DataPoint(const Observation& obs)
+			 * but does not wait for the insertions to complete. The raw
+			 * and filtered data points are sent right away, the map
+			 * values are computed while they are in flight, and both
+			 * map data points are sent as soon as the map values are
+			 * known. No thread is started: the completion of the
+			 * insertions is handled in callbacks of the driver.
+			 * Contrary to the synchronous method, all insertions are
+			 * attempted even if one of them fails. The connection must
+			 * not be destroyed before the returned future is ready.
+			 *
+			 * @param obs An observation from a meteo station connector
+			 * containing the measurements to insert in the database
+			 *
+			 * @return A future that becomes ready once all insertions
+			 * have completed and holds true if they all succeeded,
+			 * false otherwise
+			 */
+			std::future<bool> insertV2DataPointAsync(const Observation& obs);
+
+			/**
+			 * @brief Insert a range of data points in the V2 database
+			 *
+			 * The observations are grouped by partition (station and
+			 * day) and sent as unlogged batches to the raw and
+			 * filtered observations tables, with a bounded number of
+			 * batches in flight at the same time. This is much faster
+			 * than calling \a insertV2DataPoint(const Observation& obs)
+			 * for each observation when backfilling archives. The
+			 * observations map is not updated.
+			 *
+			 * @param begin An iterator to the first observation
+			 * @param end An iterator past the last observation
+			 * @param[out] failures If not null, the positions in the
+			 * range of the observations that could not be inserted, in
+			 * increasing order
+			 *
+			 * @return True if all the observations could be succesfully
+			 * inserted, false otherwise
+			 */
+			template<typename I>
+			bool insertV2DataPoints(I begin, I end, std::vector<std::size_t>* failures = nullptr)
+			{
+				std::vector<const Observation*> observations;
+				for (I it = begin ; it != end ; ++it)
+					observations.push_back(&*it);
+				return doInsertV2DataPoints(observations, failures);
+			}
 
 			bool insertV2DataPointInTimescaleDB(const Observation& obs);
 
+			/**
+			 * @brief Insert a range of data points in TimescaleDB, in a
+			 * single transaction
+			 *
+			 * The COPY method is much faster for large ranges, such as
+			 * history migrations. Both methods give the same rows: the
+			 * observations of the range sharing the same station and
+			 * datetime are merged in order, each non-null value
+			 * replacing the previous one.
+			 *
+			 * @param begin An iterator to the first observation
+			 * @param end An iterator past the last observation
+			 * @param method How to insert the observations
+			 *
+			 * @return True if all the observations could be succesfully
+			 * inserted, false otherwise (in which case none is)
+			 */
 			template<typename I>
-			bool insertV2DataPointsInTimescaleDB(I begin, I end)
+			bool insertV2DataPointsInTimescaleDB(I begin, I end, TimescaleDBInsertionMethod method = TimescaleDBInsertionMethod::UPSERT)
 			{
-				std::lock_guard<std::mutex> mutexed{_pqTransactionMutex};
+				auto connection = _pqConnections.checkout();
 				try {
-					pqxx::work tx{_pqConnection};
-					for (I it = begin ; it != end ; ++it) {
-						doInsertV2DataPointInTimescaleDB(*it, tx);
+					pqxx::work tx{*connection};
+					if (method == TimescaleDBInsertionMethod::COPY) {
+						createObservationsStagingTable(tx);
+						QueryTrace trace{*_copyObservationsMetrics};
+						pqxx::stream_to stream{tx, OBSERVATIONS_STAGING_TABLE, OBSERVATIONS_COLUMNS};
+						for (I it = begin ; it != end ; ++it) {
+							doStreamV2DataPointToTimescaleDB(*it, stream);
+							trace.addRows(1);
+						}
+						stream.complete();
+						trace.stop();
+						mergeObservationsStagingTable(tx);
+					} else {
+						for (I it = begin ; it != end ; ++it) {
+							doInsertV2DataPointInTimescaleDB(*it, tx);
+						}
 					}
 					tx.commit();
 				} catch (const pqxx::pqxx_exception& e) {
+					std::cerr << e.base().what() << std::endl;
 					return false;
 				}
 				return true;
@@ -306,7 +423,7 @@ namespace meteodata {
 			 *
 			 * @return True if everything went well, false if the query failed
 			 */
-			bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& values);
+			bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& values) override;
 
 			/**
 			 * @brief Get Weatherlink connection information for all the stations that send their
@@ -496,7 +613,28 @@ namespace meteodata {
 			 *
 			 * @return True if everything went well, false if an error occurred.
 			 */
-			bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall);
+			bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall) override;
+
+			/**
+			 * @brief Recompute the hourly and daily rainfall rollups of a
+			 * station over a period
+			 *
+			 * The rollups are recomputed in the background after the
+			 * insertion and deletion of data points, this method is
+			 * meant to backfill them for the observations inserted
+			 * before they existed, or modified by another process. It
+			 * also recomputes the rollups still waiting in the
+			 * background. getRainfall() reads the raw observations
+			 * where the rollups are missing or waiting so it is correct
+			 * in any case, only slower.
+			 *
+			 * @param[in] station The station UUID
+			 * @param[in] begin The start of the period
+			 * @param[in] end The end of the period
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool rebuildRainfallRollup(const CassUuid& station, time_t begin, time_t end);
 
 			/**
 			 * @brief Remove all data points for a given station and time range
@@ -511,7 +649,7 @@ namespace meteodata {
 			 *
 			 * @return True if everything went well, false otherwise
 			 */
-			bool deleteDataPoints(const CassUuid& station, const date::sys_days& day, const date::sys_seconds& start, const date::sys_seconds& end);
+			bool deleteDataPoints(const CassUuid& station, const date::sys_days& day, const date::sys_seconds& start, const date::sys_seconds& end) override;
 
 			/**
 			 * @brief Retrieve the last integer value stored for a given
@@ -563,6 +701,37 @@ namespace meteodata {
 			 */
 			bool cacheFloat(const CassUuid& station, const std::string& key, const time_t& update, float value);
 
+			/**
+			 * @brief Write the values cached by cacheInt() and
+			 * cacheFloat() which have not been written to the
+			 * database yet
+			 *
+			 * @return True if, and only if, all the values have been
+			 * written
+			 */
+			bool flushCachedValues() { return _cachedValues.flush(); }
+
+			/**
+			 * @brief Choose how the values cached by cacheInt() and
+			 * cacheFloat() are written to the database
+			 *
+			 * By default, they are written periodically in the
+			 * background and when the connection is destroyed. The
+			 * write-through mode writes them immediately instead, so
+			 * that they survive a crash of the process.
+			 *
+			 * @param mode The new mode, switching to write-through
+			 * writes the pending values
+			 * @param flushInterval The interval between two writes in
+			 * write-behind mode
+			 */
+			void setCachedValuesWriteMode(StationValueCache::Mode mode,
+				chrono::milliseconds flushInterval = StationValueCache::DEFAULT_FLUSH_INTERVAL)
+			{
+				_cachedValues.setFlushInterval(flushInterval);
+				_cachedValues.setMode(mode);
+			}
+
 			/**
 			 * @brief Get all values required to compute the cumulative values for an insertion query
 			 *
@@ -572,6 +741,40 @@ namespace meteodata {
 			 */
 			bool getMapValues(const CassUuid& station, time_t time, MapObservation& obs);
 
+			/**
+			 * @brief Forget the observations map values kept in memory
+			 * for a station
+			 *
+			 * The map values are computed incrementally on each
+			 * insertion from a rolling window of the last 48 hours of
+			 * observations. This method must be called when the
+			 * station's data is modified by another process, the window
+			 * will be reloaded from the database on the next insertion.
+			 * The station is also forgotten by the daily aggregator, if
+			 * any.
+			 *
+			 * @param station The station's UUID
+			 */
+			void invalidateMapValues(const CassUuid& station);
+
+			/**
+			 * @brief Attach a daily aggregator to the insertions
+			 *
+			 * Every observation successfully inserted with
+			 * \a insertV2DataPoint(const Observation& obs) or
+			 * \a insertV2DataPointAsync() is added to the aggregator,
+			 * after filtering. The other insertions and deletions make
+			 * the aggregator forget the station. The minmax values of
+			 * the current day can then be obtained or stored with
+			 * DailyAggregator::getValues() and DailyAggregator::flush()
+			 * without reading the observations back.
+			 *
+			 * @param aggregator The aggregator, not owned by the
+			 * connection, or nullptr to detach it, it must be set before
+			 * inserting observations
+			 */
+			void setDailyAggregator(DailyAggregator* aggregator);
+
 			/**
 			 * @brief Get the last time a scheduler has downloaded * data for
 			 *
@@ -797,6 +1000,39 @@ namespace meteodata {
 			 * @brief The prepared statement for the getRainfall() method
 			 */
 			CassandraStmtPtr _getRainfall;
+			/**
+			 * @brief The prepared statement to insert an hourly rainfall
+			 * bucket
+			 *
+			 * The bucket of hour H holds the total rainfall of the
+			 * observations in (H, H+1h], in table
+			 * meteodata_v2.rainfall_hourly:
+			 * (station uuid, day date, hour timestamp, rainfall float,
+			 * PRIMARY KEY ((station, day), hour)),
+			 * day being the day of H.
+			 */
+			CassandraStmtPtr _insertRainfallHourly;
+			/**
+			 * @brief The prepared statement to get the hourly rainfall
+			 * buckets of a day
+			 */
+			CassandraStmtPtr _selectRainfallHourly;
+			/**
+			 * @brief The prepared statement to insert a daily rainfall
+			 * bucket
+			 *
+			 * The bucket of day D holds the total rainfall of the
+			 * observations in (D, D+1d], in table
+			 * meteodata_v2.rainfall_daily:
+			 * (station uuid, day date, rainfall float,
+			 * PRIMARY KEY (station, day)).
+			 */
+			CassandraStmtPtr _insertRainfallDaily;
+			/**
+			 * @brief The prepared statement to get the daily rainfall
+			 * buckets of a period
+			 */
+			CassandraStmtPtr _selectRainfallDaily;
 			/**
 			 * @brief The prepared statement for the deleteDataPoints()
 			 * method
@@ -846,9 +1082,10 @@ namespace meteodata {
 			 */
 			void prepareStatements();
 
-			pqxx::connection _pqConnection;
-
-			std::mutex _pqTransactionMutex;
+			/**
+			 * @brief The pool of connections to the PostgreSQL database
+			 */
+			PqConnectionPool _pqConnections;
 
 			const static std::string UPSERT_OBSERVATION;
 			const static std::string SELECT_STATION_BY_COORDS;
@@ -886,6 +1123,26 @@ namespace meteodata {
 			const static std::string UPDATE_DOWNLOAD_STATUS;
 			const static std::string SELECT_DOWNLOADS_BY_STATION;
 
+			/**
+			 * @brief The names under which the COPY of the
+			 * observations into the staging table and their merge
+			 * into meteodata.observations are traced
+			 */
+			const static std::string COPY_OBSERVATIONS;
+			const static std::string MERGE_OBSERVATIONS;
+			StatementMetrics::Series* _copyObservationsMetrics = nullptr;
+			StatementMetrics::Series* _mergeObservationsMetrics = nullptr;
+			/**
+			 * @brief The temporary table used to COPY observations
+			 * before merging them into meteodata.observations
+			 */
+			const static std::string OBSERVATIONS_STAGING_TABLE;
+			/**
+			 * @brief The columns of meteodata.observations, in the
+			 * order of the UPSERT_OBSERVATION statement
+			 */
+			const static std::vector<std::string> OBSERVATIONS_COLUMNS;
+
 			/**
 			 * @brief Get the max temperature of a day, if recorded in the observations database
 			 *
@@ -908,6 +1165,119 @@ namespace meteodata {
 			void populateV2MapInsertionQuery(CassStatement* statement, const Observation& obs, const MapObservation& map, const std::chrono::seconds& insertionTime);
 
 			void doInsertV2DataPointInTimescaleDB(const Observation& obs, pqxx::transaction_base& tx);
+			void doStreamV2DataPointToTimescaleDB(const Observation& obs, pqxx::stream_to& stream);
+			void createObservationsStagingTable(pqxx::transaction_base& tx);
+			void mergeObservationsStagingTable(pqxx::transaction_base& tx);
+
+			bool doInsertV2DataPoints(const std::vector<const Observation*>& observations, std::vector<std::size_t>* failures);
+
+			/**
+			 * @brief Compute the map values for a new observation from
+			 * the rolling window, loading the station's history from
+			 * the database on cold start
+			 *
+			 * @param obs The new observation, already filtered
+			 * @param[out] map The map values at the time of \a obs
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool computeMapValues(const Observation& obs, MapObservation& map);
+
+			/**
+			 * @brief Get the observations of a station relevant to the
+			 * map values over the 48 hours before a given time
+			 *
+			 * @param station The station's UUID
+			 * @param time The end of the period, excluded
+			 * @param[out] history The observations of the period
+			 * @param[out] newerDataFound Whether observations more
+			 * recent than \a time exist in the database
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool getMapHistory(const CassUuid& station, time_t time, std::vector<MapAggregator::Sample>& history, bool& newerDataFound);
+
+			/**
+			 * @brief Get the cached values of a station and key,
+			 * reading them from the database the first time
+			 *
+			 * @param[out] value The values, empty if there are none
+			 *
+			 * @return True if, and only if, all went well
+			 */
+			bool getCachedValue(const CassUuid& station, const std::string& key, std::optional<StationValueCache::Value>& value);
+
+			/**
+			 * @brief Write values to the meteodata_v2.cache table,
+			 * this is the writer of _cachedValues
+			 */
+			bool writeCachedValues(const std::vector<StationValueCache::Write>& writes);
+
+			/**
+			 * @brief Sum the rainfall of the filtered observations of a
+			 * station in (begin, end]
+			 *
+			 * @param station The station's UUID
+			 * @param begin The start of the period, excluded
+			 * @param end The end of the period, included
+			 * @param[out] rainfall The total rainfall
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool getRawRainfall(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end, float& rainfall);
+
+			/**
+			 * @brief Sum the hourly rainfall buckets of a station for the
+			 * hours in [begin, end), reading the raw observations for
+			 * the missing and pending buckets
+			 *
+			 * @param station The station's UUID
+			 * @param begin The first hour
+			 * @param end The hour after the last one
+			 * @param[out] rainfall The total rainfall
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool getHourlyRainfall(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end, float& rainfall);
+
+			/**
+			 * @brief Sum the daily rainfall buckets of a station for the
+			 * days in [begin, end), reading the raw observations for the
+			 * missing days and the days with pending hourly buckets
+			 *
+			 * @param station The station's UUID
+			 * @param begin The first day
+			 * @param end The day after the last one
+			 * @param[out] rainfall The total rainfall
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool getDailyRainfall(const CassUuid& station, const date::sys_days& begin, const date::sys_days& end, float& rainfall);
+
+			/**
+			 * @brief Check whether the rainfall rollup tables exist
+			 *
+			 * The statements on meteodata_v2.rainfall_hourly and
+			 * meteodata_v2.rainfall_daily are optional, on a cluster
+			 * without these tables, the rainfall is always computed
+			 * from the observations.
+			 *
+			 * @return True if all the rollup statements are prepared
+			 */
+			bool hasRainfallRollups() const;
+
+			/**
+			 * @brief Recompute the rainfall buckets covering the
+			 * observations in (begin, end], this is the updater of
+			 * _rainfallRollups
+			 *
+			 * @param station The station's UUID
+			 * @param begin The start of the period, excluded
+			 * @param end The end of the period, included
+			 *
+			 * @return True if everything went well, false if an error occurred.
+			 */
+			bool updateRainfallRollup(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end);
 
 			/**
 			 * @brief The prepared statement for the getTx() method
@@ -922,11 +1292,58 @@ namespace meteodata {
 			 */
 			CassandraStmtPtr _selectMapValues;
 
+			/**
+			 * @brief The rolling window used to compute the map values
+			 * of new observations
+			 */
+			MapAggregator _mapAggregator;
+
+			/**
+			 * @brief The optional aggregator of the daily values of
+			 * new observations
+			 */
+			DailyAggregator* _dailyAggregator = nullptr;
+
+			/**
+			 * @brief The in-memory layer in front of the
+			 * meteodata_v2.cache table
+			 *
+			 * It must be declared after the prepared statements
+			 * since it writes the pending values when destroyed.
+			 */
+			StationValueCache _cachedValues;
+
+			/**
+			 * @brief The rainfall buckets waiting to be recomputed
+			 *
+			 * The insertions and deletions only queue the hours they
+			 * modify so that they neither wait for the rollups nor
+			 * fail because of them. It must be declared after the
+			 * prepared statements since it recomputes the pending
+			 * buckets when destroyed.
+			 */
+			RainfallRollupQueue _rainfallRollups;
+
 			/**
 			 * @brief The interval of time at which observations are
 			 * rounded on the observations map
 			 */
 			constexpr static chrono::minutes OBSERVATIONS_MAP_TIME_RESOLUTION{5};
+
+			/**
+			 * @brief The maximum number of observations in a batch sent
+			 * by insertV2DataPoints()
+			 *
+			 * Batches are per partition but Cassandra still warns when
+			 * they grow beyond a few kilobytes.
+			 */
+			constexpr static std::size_t INSERTION_BATCH_SIZE = 16;
+
+			/**
+			 * @brief The maximum number of batches insertV2DataPoints()
+			 * keeps in flight at the same time
+			 */
+			constexpr static std::size_t MAX_BATCHES_IN_FLIGHT = 8;
 	};
 }
 
@@ -51,17 +51,19 @@ constexpr char DbConnectionRecords::SELECT_CURRENT_RECORDS_STMT[];
 
 namespace chrono = std::chrono;
 
-DbConnectionRecords::DbConnectionRecords(const std::string& address, const std::string& user, const std::string& password) :
-	DbConnectionCommon(address, user, password)
+DbConnectionRecords::DbConnectionRecords(const std::string& address, const std::string& user, const std::string& password,
+		const ConnectionOptions& options) :
+	DbConnectionCommon(address, user, password, options)
 {
 	DbConnectionRecords::prepareStatements();
+	waitForPreparedStatements();
 }
 
 void DbConnectionRecords::prepareStatements()
 {
-	prepareOneStatement(_selectValuesForAllDaysInMonth, SELECT_VALUES_FOR_ALL_DAYS_IN_MONTH_STMT);
-	prepareOneStatement(_selectCurrentRecords, SELECT_CURRENT_RECORDS_STMT);
-	prepareOneStatement(_insertDataPoint, INSERT_DATAPOINT_STMT);
+	prepareOneStatement(_selectValuesForAllDaysInMonth, "records_select_values_for_all_days_in_month", SELECT_VALUES_FOR_ALL_DAYS_IN_MONTH_STMT);
+	prepareOneStatement(_selectCurrentRecords, "records_select_current_records", SELECT_CURRENT_RECORDS_STMT);
+	prepareOneStatement(_insertDataPoint, "records_insert_data_point", INSERT_DATAPOINT_STMT);
 }
 
 void storeCassandraFloatAndListOfDays(const CassRow* row, int column, float& value, std::set<date::sys_days>& dates)
@@ -136,12 +138,14 @@ bool DbConnectionRecords::getCurrentRecords(const CassUuid& station, date::month
 	using namespace date;
 
 	CassFuture* query;
-	CassStatement* statement = cass_prepared_bind(_selectCurrentRecords.get());
+	CassStatement* statement = _selectCurrentRecords.bind();
+	if (!statement)
+		return false;
 
 	cass_statement_bind_uuid(statement, 0, station);
 	unsigned int m = unsigned(month);
 	cass_statement_bind_int32(statement, 1, m);
-	query = cass_session_execute(_session.get(), statement);
+	query = execute(_selectCurrentRecords, statement, &station);
 	cass_statement_free(statement);
 
 	values.setMonth(month);
@@ -263,11 +267,13 @@ bool DbConnectionRecords::getCurrentRecords(const CassUuid& station, date::month
 bool DbConnectionRecords::getValuesForAllDaysInMonth(const CassUuid& uuid, int year, int month, MonthlyRecords& values)
 {
 	CassFuture* query;
-	CassStatement* statement = cass_prepared_bind(_selectValuesForAllDaysInMonth.get());
+	CassStatement* statement = _selectValuesForAllDaysInMonth.bind();
+	if (!statement)
+		return false;
 
 	cass_statement_bind_uuid(statement, 0, uuid);
 	cass_statement_bind_int32(statement, 1, year * 100 + month);
-	query = cass_session_execute(_session.get(), statement);
+	query = execute(_selectValuesForAllDaysInMonth, statement, &uuid);
 	cass_statement_free(statement);
 
 	const CassResult* result = cass_future_get_result(query);
@@ -303,9 +309,11 @@ bool DbConnectionRecords::getValuesForAllDaysInMonth(const CassUuid& uuid, int y
 bool DbConnectionRecords::insertDataPoint(const CassUuid& station, MonthlyRecords& values)
 {
 	CassFuture* query;
-	CassStatement* statement = cass_prepared_bind(_insertDataPoint.get());
+	CassStatement* statement = _insertDataPoint.bind();
+	if (!statement)
+		return false;
 	values.populateRecordInsertionQuery(statement, station);
-	query = cass_session_execute(_session.get(), statement);
+	query = execute(_insertDataPoint, statement, &station);
 	cass_statement_free(statement);
 
 	const CassResult* result = cass_future_get_result(query);
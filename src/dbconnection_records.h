@@ -57,8 +57,11 @@ public:
 	 * @param address the host of the database
 	 * @param user the username to use
 	 * @param password the password corresponding to the username
+	 * @param options the tuning of the Cassandra session and when to
+	 * prepare the statements
 	 */
-	DbConnectionRecords(const std::string& address = "127.0.0.1", const std::string& user = "", const std::string& password = "");
+	DbConnectionRecords(const std::string& address = "127.0.0.1", const std::string& user = "", const std::string& password = "",
+		const ConnectionOptions& options = ConnectionOptions{});
 	/**
 	 * @brief Close the connection and destroy the database handle
 	 */
@@ -0,0 +1,314 @@
+/**
+ * @file in_memory_storage.cpp
+ * @brief Implementation of the in-memory storage backends
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "daily_aggregator.h"
+#include "in_memory_storage.h"
+#include "observation.h"
+
+namespace meteodata {
+
+namespace chrono = std::chrono;
+
+InMemoryObservationStorage::PartitionKey InMemoryObservationStorage::keyOf(const CassUuid& station, const date::sys_days& day)
+{
+	return { station.time_and_version, station.clock_seq_and_node, day };
+}
+
+bool InMemoryObservationStorage::insertV2DataPoint(const Observation& obs)
+{
+	Observation copy{obs};
+	copy.filterOutImpossibleValues();
+
+	std::lock_guard locked{_mutex};
+	_meteo[keyOf(obs.station, date::floor<date::days>(obs.time))][obs.time] = copy;
+	return true;
+}
+
+bool InMemoryObservationStorage::getLastDataBefore(const CassUuid& station, time_t boundary, Observation& obs)
+{
+	date::sys_seconds b{chrono::seconds(boundary)};
+
+	std::lock_guard locked{_mutex};
+	auto partition = _meteo.find(keyOf(station, date::floor<date::days>(b)));
+	if (partition == _meteo.end())
+		return false;
+
+	auto it = partition->second.upper_bound(b);
+	if (it == partition->second.begin())
+		return false;
+	obs = std::prev(it)->second;
+	return true;
+}
+
+bool InMemoryObservationStorage::getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall)
+{
+	date::sys_seconds b{chrono::seconds(begin)};
+	date::sys_seconds e{chrono::seconds(end)};
+	rainfall = 0;
+	if (e <= b)
+		return true;
+
+	std::lock_guard locked{_mutex};
+	for (date::sys_days day = date::floor<date::days>(b) ; day <= date::floor<date::days>(e) ; day += date::days{1}) {
+		auto partition = _meteo.find(keyOf(station, day));
+		if (partition == _meteo.end())
+			continue;
+
+		auto last = partition->second.upper_bound(e);
+		for (auto it = partition->second.upper_bound(b) ; it != last ; ++it) {
+			if (it->second.rainfall.first)
+				rainfall += it->second.rainfall.second;
+		}
+	}
+	return true;
+}
+
+bool InMemoryObservationStorage::deleteDataPoints(const CassUuid& station, const date::sys_days& day, const date::sys_seconds& start, const date::sys_seconds& end)
+{
+	std::lock_guard locked{_mutex};
+	auto partition = _meteo.find(keyOf(station, day));
+	if (partition == _meteo.end() || end <= start)
+		return true;
+
+	partition->second.erase(partition->second.upper_bound(start), partition->second.upper_bound(end));
+	if (partition->second.empty())
+		_meteo.erase(partition);
+	return true;
+}
+
+void InMemoryObservationStorage::forEach(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end, const std::function<void(const Observation&)>& f) const
+{
+	if (end <= begin)
+		return;
+
+	std::lock_guard locked{_mutex};
+	date::sys_days lastDay = date::floor<date::days>(end - chrono::seconds{1});
+	for (date::sys_days day = date::floor<date::days>(begin) ; day <= lastDay ; day += date::days{1}) {
+		auto partition = _meteo.find(keyOf(station, day));
+		if (partition == _meteo.end())
+			continue;
+
+		auto last = partition->second.lower_bound(end);
+		for (auto it = partition->second.lower_bound(begin) ; it != last ; ++it)
+			f(it->second);
+	}
+}
+
+std::size_t InMemoryObservationStorage::size() const
+{
+	std::lock_guard locked{_mutex};
+	std::size_t total = 0;
+	for (const auto& partition : _meteo)
+		total += partition.second.size();
+	return total;
+}
+
+void InMemoryObservationStorage::clear()
+{
+	std::lock_guard locked{_mutex};
+	_meteo.clear();
+}
+
+
+InMemoryMinmaxStorage::InMemoryMinmaxStorage(const InMemoryObservationStorage& observations) :
+	_observations{observations}
+{}
+
+InMemoryMinmaxStorage::PartitionKey InMemoryMinmaxStorage::keyOf(const CassUuid& station, const date::sys_days& date)
+{
+	date::year_month_day ymd{date};
+	return { station.time_and_version, station.clock_seq_and_node, int(ymd.year()) * 100 + int(unsigned(ymd.month())) };
+}
+
+bool InMemoryMinmaxStorage::insertDataPoint(const CassUuid& station, const date::sys_days& date, const Values& values)
+{
+	std::lock_guard locked{_mutex};
+	_minmax[keyOf(station, date)][date] = values;
+	return true;
+}
+
+bool InMemoryMinmaxStorage::insertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values)
+{
+	// There's only one copy of the values in memory
+	return insertDataPoint(station, date, values);
+}
+
+bool InMemoryMinmaxStorage::getValues6hTo6h(const CassUuid& station, const date::sys_days& date, Values& values)
+{
+	DailyAggregator::Window6hTo6h window;
+	_observations.forEach(station, date + chrono::hours{6}, date + chrono::hours{30}, [&](const Observation& obs) { window.add(obs); });
+	window.get(values);
+	return true;
+}
+
+bool InMemoryMinmaxStorage::getValues18hTo18h(const CassUuid& station, const date::sys_days& date, Values& values)
+{
+	DailyAggregator::Window18hTo18h window;
+	_observations.forEach(station, date - chrono::hours{6}, date + chrono::hours{18}, [&](const Observation& obs) { window.add(obs); });
+	window.get(values);
+	return true;
+}
+
+bool InMemoryMinmaxStorage::getValues0hTo0h(const CassUuid& station, const date::sys_days& date, Values& values)
+{
+	DailyAggregator::Window0hTo0h window;
+	_observations.forEach(station, date, date + chrono::hours{24}, [&](const Observation& obs) { window.add(obs); });
+	window.get(values);
+	return true;
+}
+
+bool InMemoryMinmaxStorage::getYearlyValues(const CassUuid& station, const date::sys_days& date, std::pair<bool, float>& rain, std::pair<bool, float>& et)
+{
+	Values values;
+	if (!getStoredValues(station, date, values))
+		return false;
+
+	rain = values.yearRain;
+	et = values.yearEt;
+	return true;
+}
+
+bool InMemoryMinmaxStorage::getCumulativeValues(const CassUuid& station, const date::sys_days& date, Values& values)
+{
+	Values stored;
+	if (!getStoredValues(station, date, stored))
+		return false;
+
+	values.monthRain = stored.monthRain;
+	values.monthEt = stored.monthEt;
+	values.yearRain = stored.yearRain;
+	values.yearEt = stored.yearEt;
+	return true;
+}
+
+bool InMemoryMinmaxStorage::getStoredValues(const CassUuid& station, const date::sys_days& date, Values& values) const
+{
+	std::lock_guard locked{_mutex};
+	auto partition = _minmax.find(keyOf(station, date));
+	if (partition == _minmax.end())
+		return false;
+
+	auto it = partition->second.find(date);
+	if (it == partition->second.end())
+		return false;
+
+	values = it->second;
+	return true;
+}
+
+
+bool InMemoryJobStorage::publishStationJob(const char* jobType, const CassUuid& station, time_t begin, time_t end)
+{
+	std::lock_guard locked{_mutex};
+	long id = _nextId++;
+	Job& job = _jobs[id];
+	job.job = StationJob{
+		id,
+		jobType,
+		station,
+		date::floor<chrono::seconds>(chrono::system_clock::now()),
+		date::sys_seconds{chrono::seconds{begin}},
+		date::sys_seconds{chrono::seconds{end}}
+	};
+	return true;
+}
+
+std::optional<InMemoryJobStorage::StationJob> InMemoryJobStorage::retrieveStationJob(const char* jobType)
+{
+	std::lock_guard locked{_mutex};
+	// The identifiers are increasing so the jobs are ordered by submission
+	// date, like in RETRIEVE_JOB
+	for (auto& [id, job] : _jobs) {
+		if (!job.started && job.job.job == jobType) {
+			job.started = true;
+			return job.job;
+		}
+	}
+	return std::nullopt;
+}
+
+bool InMemoryJobStorage::publishMinmax(const CassUuid& station, time_t beginning, time_t end)
+{
+	return publishStationJob(JobType::MINMAX, station, beginning, end);
+}
+
+std::optional<InMemoryJobStorage::StationJob> InMemoryJobStorage::retrieveMinmax()
+{
+	return retrieveStationJob(JobType::MINMAX);
+}
+
+bool InMemoryJobStorage::publishMonthMinmax(const CassUuid& station, time_t beginning, time_t end)
+{
+	return publishStationJob(JobType::MONTH_MINMAX, station, beginning, end);
+}
+
+std::optional<InMemoryJobStorage::StationJob> InMemoryJobStorage::retrieveMonthMinmax()
+{
+	return retrieveStationJob(JobType::MONTH_MINMAX);
+}
+
+bool InMemoryJobStorage::publishAnomalyMonitoring(const CassUuid& station, time_t beginning, time_t end)
+{
+	return publishStationJob(JobType::ANOMALY_MONITORING, station, beginning, end);
+}
+
+std::optional<InMemoryJobStorage::StationJob> InMemoryJobStorage::retrieveAnomalyMonitoring()
+{
+	return retrieveStationJob(JobType::ANOMALY_MONITORING);
+}
+
+bool InMemoryJobStorage::markJobAsFinished(int jobId, time_t completionDatetime, int statusCode)
+{
+	std::lock_guard locked{_mutex};
+	auto it = _jobs.find(jobId);
+	if (it == _jobs.end())
+		return false;
+
+	it->second.completion = date::sys_seconds{chrono::seconds{completionDatetime}};
+	it->second.statusCode = statusCode;
+	return true;
+}
+
+std::optional<int> InMemoryJobStorage::getStatusCode(int jobId) const
+{
+	std::lock_guard locked{_mutex};
+	auto it = _jobs.find(jobId);
+	if (it == _jobs.end() || !it->second.completion)
+		return std::nullopt;
+	return it->second.statusCode;
+}
+
+}
@@ -0,0 +1,190 @@
+/**
+ * @file in_memory_storage.h
+ * @brief Definition of the in-memory storage backends
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IN_MEMORY_STORAGE_H
+#define IN_MEMORY_STORAGE_H
+
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "observation.h"
+#include "observation_storage.h"
+#include "minmax_storage.h"
+#include "job_storage.h"
+
+namespace meteodata {
+
+/**
+ * @brief An ObservationStorage keeping the observations in memory
+ *
+ * The observations are stored in ordered maps, one per station and per day,
+ * like the partitions of the meteodata_v2.meteo table, and filtered like in
+ * the Cassandra table. All the methods are thread-safe.
+ */
+class InMemoryObservationStorage : public ObservationStorage
+{
+public:
+	bool insertV2DataPoint(const Observation& obs) override;
+	bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& obs) override;
+	bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall) override;
+	bool deleteDataPoints(const CassUuid& station, const date::sys_days& day, const date::sys_seconds& start, const date::sys_seconds& end) override;
+
+	/**
+	 * @brief Call a function on each observation of a station in the time
+	 * range [\a begin, \a end), in chronological order
+	 *
+	 * The storage is locked while \a f runs, \a f must not call the
+	 * storage back.
+	 */
+	void forEach(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end, const std::function<void(const Observation&)>& f) const;
+
+	/**
+	 * @brief Get the number of observations stored, for all the stations
+	 */
+	std::size_t size() const;
+
+	/**
+	 * @brief Remove all the observations
+	 */
+	void clear();
+
+private:
+	/**
+	 * @brief The partition key of the meteodata_v2.meteo table: the
+	 * station and the day
+	 */
+	using PartitionKey = std::tuple<cass_uint64_t, cass_uint64_t, date::sys_days>;
+	using Partition = std::map<date::sys_seconds, Observation>;
+
+	static PartitionKey keyOf(const CassUuid& station, const date::sys_days& day);
+
+	std::map<PartitionKey, Partition> _meteo;
+	mutable std::mutex _mutex;
+};
+
+/**
+ * @brief A MinmaxStorage keeping the daily values in memory and computing
+ * them from an InMemoryObservationStorage
+ *
+ * The windows are the same as the ones of DbConnectionMinmax. The values
+ * derived from the cumulative columns of the observations not stored in an
+ * Observation (rainfall24, insolation_time24, tx and tn) are not
+ * available. The daily values are stored in ordered maps, one per station
+ * and per month, like the partitions of the meteodata_v2.minmax table.
+ */
+class InMemoryMinmaxStorage : public MinmaxStorage
+{
+public:
+	/**
+	 * @brief Construct the storage
+	 *
+	 * @param observations The observations the values are computed from,
+	 * it must outlive the storage
+	 */
+	explicit InMemoryMinmaxStorage(const InMemoryObservationStorage& observations);
+
+	bool insertDataPoint(const CassUuid& station, const date::sys_days& date, const Values& values) override;
+	bool insertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values) override;
+	bool getValues6hTo6h(const CassUuid& station, const date::sys_days& date, Values& values) override;
+	bool getValues18hTo18h(const CassUuid& station, const date::sys_days& date, Values& values) override;
+	bool getValues0hTo0h(const CassUuid& station, const date::sys_days& date, Values& values) override;
+	bool getYearlyValues(const CassUuid& station, const date::sys_days& date, std::pair<bool, float>& rain, std::pair<bool, float>& et) override;
+	bool getCumulativeValues(const CassUuid& station, const date::sys_days& date, Values& values) override;
+
+	/**
+	 * @brief Get the values stored for a day
+	 *
+	 * @return True if values have been stored for the day, false otherwise
+	 */
+	bool getStoredValues(const CassUuid& station, const date::sys_days& date, Values& values) const;
+
+private:
+	/**
+	 * @brief The partition key of the meteodata_v2.minmax table: the
+	 * station and the month, as year * 100 + month
+	 */
+	using PartitionKey = std::tuple<cass_uint64_t, cass_uint64_t, int>;
+	using Partition = std::map<date::sys_days, Values>;
+
+	static PartitionKey keyOf(const CassUuid& station, const date::sys_days& date);
+
+	const InMemoryObservationStorage& _observations;
+	std::map<PartitionKey, Partition> _minmax;
+	mutable std::mutex _mutex;
+};
+
+/**
+ * @brief A JobStorage keeping the queue of jobs in memory
+ *
+ * Like in the jobs table, each job gets an increasing identifier and jobs
+ * are retrieved in the order they were published, each one only once.
+ */
+class InMemoryJobStorage : public JobStorage
+{
+public:
+	bool publishMinmax(const CassUuid& station, time_t beginning, time_t end) override;
+	std::optional<StationJob> retrieveMinmax() override;
+	bool publishMonthMinmax(const CassUuid& station, time_t beginning, time_t end) override;
+	std::optional<StationJob> retrieveMonthMinmax() override;
+	bool publishAnomalyMonitoring(const CassUuid& station, time_t beginning, time_t end) override;
+	std::optional<StationJob> retrieveAnomalyMonitoring() override;
+	bool markJobAsFinished(int jobId, time_t completionDatetime, int statusCode) override;
+
+	/**
+	 * @brief Get the status code of a finished job
+	 *
+	 * @return The status code given to \a markJobAsFinished() or an empty
+	 * value if the job is unknown or not finished
+	 */
+	std::optional<int> getStatusCode(int jobId) const;
+
+private:
+	struct Job
+	{
+		StationJob job;
+		bool started = false;
+		std::optional<date::sys_seconds> completion;
+		int statusCode = 0;
+	};
+
+	std::map<long, Job> _jobs;
+	long _nextId = 1;
+	mutable std::mutex _mutex;
+
+	bool publishStationJob(const char* jobType, const CassUuid& station, time_t begin, time_t end);
+	std::optional<StationJob> retrieveStationJob(const char* jobType);
+};
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file job_storage.h
+ * @brief Definition of the JobStorage interface
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOB_STORAGE_H
+#define JOB_STORAGE_H
+
+#include <ctime>
+#include <optional>
+#include <string>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+namespace meteodata {
+
+/**
+ * @brief The queue of the jobs to run on the stations' data
+ *
+ * DbConnectionJobs implements it on top of MySQL, the InMemoryJobStorage
+ * implements it without any database, for the benchmarks and the tests.
+ */
+class JobStorage
+{
+public:
+	virtual ~JobStorage() = default;
+
+	struct JobType {
+		static constexpr char MINMAX[] = "minmax";
+		static constexpr char MONTH_MINMAX[] = "month_minmax";
+		static constexpr char ANOMALY_MONITORING[] = "anomaly_monitoring";
+	};
+
+	struct StationJob
+	{
+		long id;
+		std::string job;
+		CassUuid station;
+		date::sys_seconds submissionDatetime;
+		date::sys_seconds begin;
+		date::sys_seconds end;
+	};
+
+	/**
+	 * @brief Publish a minmax job
+	 *
+	 * @param station The station's UUID
+	 * @param begin The beginning of the period to (re)compute
+	 * @param end The end of the period to (re)compute
+	 *
+	 * @return The boolean value true if everything went well, false if an error occurred
+	 */
+	virtual bool publishMinmax(const CassUuid& station, time_t beginning, time_t end) = 0;
+	/**
+	 * @brief Retrieve the next available minmax job
+	 *
+	 * @return A station job if one could be found or an empty value
+	 */
+	virtual std::optional<StationJob> retrieveMinmax() = 0;
+
+	/**
+	 * @brief Publish a monthly minmax job
+	 *
+	 * @param station The station's UUID
+	 * @param begin The beginning of the period to (re)compute
+	 * @param end The end of the period to (re)compute
+	 *
+	 * @return The boolean value true if everything went well, false if an error occurred
+	 */
+	virtual bool publishMonthMinmax(const CassUuid& station, time_t beginning, time_t end) = 0;
+	/**
+	 * @brief Retrieve the next available monthly minmax job
+	 *
+	 * @return A station job if one could be found or an empty value
+	 */
+	virtual std::optional<StationJob> retrieveMonthMinmax() = 0;
+
+	/**
+	 * @brief Publish an anomaly monitoring job
+	 *
+	 * @param station The station's UUID
+	 * @param begin The beginning of the period to (re)compute
+	 * @param end The end of the period to (re)compute
+	 *
+	 * @return The boolean value true if everything went well, false if an error occurred
+	 */
+	virtual bool publishAnomalyMonitoring(const CassUuid& station, time_t beginning, time_t end) = 0;
+	/**
+	 * @brief Retrieve the next available anomaly monitoring job
+	 *
+	 * @return A station job if one could be found or an empty value
+	 */
+	virtual std::optional<StationJob> retrieveAnomalyMonitoring() = 0;
+
+	/**
+	 * @brief Register a job as finished, with a completion date and a
+	 * status code (0 if everything went well, an error code otherwise)
+	 *
+	 * @param jobId The job id, as retrieved from a "retrieve" query
+	 * @param completionTimestamp A timestamp of when the job was done (or
+	 * unsuccesfully attempted and deemed not doable)
+	 * @param statusCode The exit code of the program that did the job
+	 */
+	virtual bool markJobAsFinished(int jobId, time_t completionDatetime, int statusCode) = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file map_aggregator.cpp
+ * @brief Implementation of the MapAggregator class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "map_aggregator.h"
+#include "map_observation.h"
+#include "observation.h"
+
+namespace meteodata {
+
+namespace chrono = std::chrono;
+
+constexpr chrono::minutes MapAggregator::BUCKET_WIDTH;
+constexpr std::size_t MapAggregator::NB_BUCKETS;
+
+namespace {
+	std::int64_t bucketIndex(const date::sys_seconds& time)
+	{
+		return date::floor<chrono::minutes>(time).time_since_epoch() / MapAggregator::BUCKET_WIDTH;
+	}
+}
+
+MapAggregator::Sample::Sample(const Observation& obs) :
+	time{obs.time},
+	outsideTemperature{obs.outsidetemp},
+	maxOutsideTemperature{obs.max_outside_temperature},
+	minOutsideTemperature{obs.min_outside_temperature},
+	rainfall{obs.rainfall},
+	et{obs.et},
+	windgust{obs.windgust}
+{}
+
+MapAggregator::StationKey MapAggregator::keyOf(const CassUuid& station)
+{
+	return { station.time_and_version, station.clock_seq_and_node };
+}
+
+void MapAggregator::add(Window& window, const Sample& sample)
+{
+	std::int64_t index = bucketIndex(sample.time);
+	Bucket& bucket = window.buckets[index % NB_BUCKETS];
+	if (bucket.index != index)
+		bucket = Bucket{index};
+
+	if (sample.rainfall.first) {
+		bucket.rainfall += sample.rainfall.second;
+		bucket.present |= RAINFALL;
+	}
+
+	if (sample.et.first) {
+		bucket.et += sample.et.second;
+		bucket.present |= ET;
+	}
+
+	// Like in DbConnectionObservations::getMapValues(), the current
+	// temperature stands in for the extrema when they are not available
+	const std::pair<bool, float>& maxtemp = sample.maxOutsideTemperature.first ? sample.maxOutsideTemperature : sample.outsideTemperature;
+	if (maxtemp.first && (!(bucket.present & MAX_OUTSIDE_TEMPERATURE) || maxtemp.second > bucket.maxOutsideTemperature)) {
+		bucket.maxOutsideTemperature = maxtemp.second;
+		bucket.present |= MAX_OUTSIDE_TEMPERATURE;
+	}
+
+	const std::pair<bool, float>& mintemp = sample.minOutsideTemperature.first ? sample.minOutsideTemperature : sample.outsideTemperature;
+	if (mintemp.first && (!(bucket.present & MIN_OUTSIDE_TEMPERATURE) || mintemp.second < bucket.minOutsideTemperature)) {
+		bucket.minOutsideTemperature = mintemp.second;
+		bucket.present |= MIN_OUTSIDE_TEMPERATURE;
+	}
+
+	if (sample.windgust.first && (!(bucket.present & WINDGUST) || sample.windgust.second > bucket.windgust)) {
+		bucket.windgust = sample.windgust.second;
+		bucket.present |= WINDGUST;
+	}
+}
+
+void MapAggregator::compute(const Window& window, std::int64_t reference, MapObservation& map)
+{
+	constexpr std::int64_t W1H = chrono::hours{1} / BUCKET_WIDTH;
+	constexpr std::int64_t W3H = chrono::hours{3} / BUCKET_WIDTH;
+	constexpr std::int64_t W6H = chrono::hours{6} / BUCKET_WIDTH;
+	constexpr std::int64_t W12H = chrono::hours{12} / BUCKET_WIDTH;
+	constexpr std::int64_t W24H = chrono::hours{24} / BUCKET_WIDTH;
+	constexpr std::int64_t W48H = chrono::hours{48} / BUCKET_WIDTH;
+
+	auto sum = [](std::pair<bool, float>& total, bool inWindow, float value) {
+		total.first = true;
+		if (inWindow)
+			total.second += value;
+	};
+	auto max = [](std::pair<bool, float>& extremum, bool inWindow, float value) {
+		if (inWindow && (!extremum.first || value > extremum.second))
+			extremum = { true, value };
+	};
+	auto min = [](std::pair<bool, float>& extremum, bool inWindow, float value) {
+		if (inWindow && (!extremum.first || value < extremum.second))
+			extremum = { true, value };
+	};
+
+	map = MapObservation{};
+	for (std::int64_t age = 0 ; age < W48H ; age++) {
+		std::int64_t index = reference - age;
+		const Bucket& bucket = window.buckets[index % NB_BUCKETS];
+		if (bucket.index != index)
+			continue;
+
+		if (bucket.present & RAINFALL) {
+			sum(map.rainfall1h, age < W1H, bucket.rainfall);
+			sum(map.rainfall3h, age < W3H, bucket.rainfall);
+			sum(map.rainfall6h, age < W6H, bucket.rainfall);
+			sum(map.rainfall12h, age < W12H, bucket.rainfall);
+			sum(map.rainfall24h, age < W24H, bucket.rainfall);
+			sum(map.rainfall48h, true, bucket.rainfall);
+		}
+
+		if (bucket.present & ET) {
+			sum(map.et1h, age < W1H, bucket.et);
+			sum(map.et12h, age < W12H, bucket.et);
+			sum(map.et24h, age < W24H, bucket.et);
+			sum(map.et48h, true, bucket.et);
+		}
+
+		if (bucket.present & MAX_OUTSIDE_TEMPERATURE) {
+			max(map.max_outside_temperature1h, age < W1H, bucket.maxOutsideTemperature);
+			max(map.max_outside_temperature6h, age < W6H, bucket.maxOutsideTemperature);
+			max(map.max_outside_temperature12h, age < W12H, bucket.maxOutsideTemperature);
+			max(map.max_outside_temperature24h, age < W24H, bucket.maxOutsideTemperature);
+		}
+
+		if (bucket.present & MIN_OUTSIDE_TEMPERATURE) {
+			min(map.min_outside_temperature1h, age < W1H, bucket.minOutsideTemperature);
+			min(map.min_outside_temperature6h, age < W6H, bucket.minOutsideTemperature);
+			min(map.min_outside_temperature12h, age < W12H, bucket.minOutsideTemperature);
+			min(map.min_outside_temperature24h, age < W24H, bucket.minOutsideTemperature);
+		}
+
+		if (bucket.present & WINDGUST) {
+			max(map.windgust1h, age < W1H, bucket.windgust);
+			max(map.windgust12h, age < W12H, bucket.windgust);
+			max(map.windgust24h, age < W24H, bucket.windgust);
+		}
+	}
+}
+
+bool MapAggregator::accumulate(const CassUuid& station, const Sample& sample, MapObservation& map)
+{
+	std::lock_guard locked{_mutex};
+
+	auto it = _windows.find(keyOf(station));
+	if (it == _windows.end())
+		return false;
+
+	Window& window = it->second;
+	if (sample.time <= window.latest) {
+		// Out-of-order observations cannot be handled in the window
+		// without risking counting them twice
+		_windows.erase(it);
+		return false;
+	}
+
+	add(window, sample);
+	window.latest = sample.time;
+	compute(window, bucketIndex(sample.time), map);
+	return true;
+}
+
+void MapAggregator::reset(const CassUuid& station, const std::vector<Sample>& history)
+{
+	std::lock_guard locked{_mutex};
+
+	Window& window = _windows[keyOf(station)];
+	window = Window{};
+	if (history.empty())
+		return;
+
+	for (const Sample& sample : history)
+		window.latest = std::max(window.latest, sample.time);
+
+	std::int64_t oldest = bucketIndex(window.latest) - static_cast<std::int64_t>(NB_BUCKETS);
+	for (const Sample& sample : history) {
+		if (bucketIndex(sample.time) > oldest)
+			add(window, sample);
+	}
+}
+
+void MapAggregator::invalidate(const CassUuid& station)
+{
+	std::lock_guard locked{_mutex};
+	_windows.erase(keyOf(station));
+}
+
+void MapAggregator::clear()
+{
+	std::lock_guard locked{_mutex};
+	_windows.clear();
+}
+
+}
@@ -0,0 +1,164 @@
+/**
+ * @file map_aggregator.h
+ * @brief Definition of the MapAggregator class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAP_AGGREGATOR_H
+#define MAP_AGGREGATOR_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "map_observation.h"
+#include "observation.h"
+
+namespace meteodata {
+
+/**
+ * @brief An in-memory, per-station, rolling window of the last 48 hours of
+ * observations used to compute the cumulative values of the observations map
+ *
+ * The observations are accumulated in a ring buffer of 5-minute buckets so
+ * that the map values can be updated on each insertion without reading the
+ * last three days of data back from the database. The windows are aligned on
+ * the buckets: the 1h window, for instance, covers the twelve buckets up to
+ * and including the one of the reference observation.
+ *
+ * The aggregator only knows about the observations inserted through it, a
+ * station's history must be loaded with \a reset() the first time the
+ * station is seen.
+ */
+class MapAggregator
+{
+public:
+	/**
+	 * @brief The subset of an observation relevant to the map values
+	 */
+	struct Sample
+	{
+		date::sys_seconds time;
+		std::pair<bool, float> outsideTemperature = { false, 0.0f };
+		std::pair<bool, float> maxOutsideTemperature = { false, 0.0f };
+		std::pair<bool, float> minOutsideTemperature = { false, 0.0f };
+		std::pair<bool, float> rainfall = { false, 0.0f };
+		std::pair<bool, float> et = { false, 0.0f };
+		std::pair<bool, float> windgust = { false, 0.0f };
+
+		Sample() = default;
+		explicit Sample(const Observation& obs);
+	};
+
+	/**
+	 * @brief The width of a bucket, it matches the resolution of the
+	 * observations map
+	 */
+	constexpr static std::chrono::minutes BUCKET_WIDTH{5};
+
+	/**
+	 * @brief Add a new observation to a station's window and compute the
+	 * map values at the time of the observation
+	 *
+	 * @param station The station's UUID
+	 * @param sample The new observation
+	 * @param[out] map The map values, computed over the window ending
+	 * with \a sample
+	 *
+	 * @return True if the map values could be computed, false if the
+	 * station's history is unknown or if \a sample is not more recent
+	 * than the last observation accumulated for the station, in which
+	 * case the station is forgotten and must be reset
+	 */
+	bool accumulate(const CassUuid& station, const Sample& sample, MapObservation& map);
+
+	/**
+	 * @brief Load the history of a station, discarding everything known
+	 * about it so far
+	 *
+	 * @param station The station's UUID
+	 * @param history The observations of the station over the last 48
+	 * hours, in any order
+	 */
+	void reset(const CassUuid& station, const std::vector<Sample>& history);
+
+	/**
+	 * @brief Forget about a station, its history will have to be reset
+	 * before accumulating new observations
+	 *
+	 * @param station The station's UUID
+	 */
+	void invalidate(const CassUuid& station);
+
+	/**
+	 * @brief Forget about all stations
+	 */
+	void clear();
+
+private:
+	constexpr static std::size_t NB_BUCKETS = std::chrono::hours{48} / BUCKET_WIDTH;
+
+	struct Bucket
+	{
+		std::int64_t index = -1;
+		float rainfall = 0.0f;
+		float et = 0.0f;
+		float maxOutsideTemperature = 0.0f;
+		float minOutsideTemperature = 0.0f;
+		float windgust = 0.0f;
+		std::uint8_t present = 0;
+	};
+
+	enum Presence : std::uint8_t
+	{
+		RAINFALL = 1 << 0,
+		ET = 1 << 1,
+		MAX_OUTSIDE_TEMPERATURE = 1 << 2,
+		MIN_OUTSIDE_TEMPERATURE = 1 << 3,
+		WINDGUST = 1 << 4
+	};
+
+	struct Window
+	{
+		std::array<Bucket, NB_BUCKETS> buckets;
+		date::sys_seconds latest;
+	};
+
+	using StationKey = std::pair<cass_uint64_t, cass_uint64_t>;
+
+	std::map<StationKey, Window> _windows;
+
+	std::mutex _mutex;
+
+	static StationKey keyOf(const CassUuid& station);
+	static void add(Window& window, const Sample& sample);
+	static void compute(const Window& window, std::int64_t reference, MapObservation& map);
+};
+
+}
+
+#endif
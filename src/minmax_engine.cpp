@@ -0,0 +1,91 @@
+/**
+ * @file minmax_engine.cpp
+ * @brief Implementation of the MinmaxEngine class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "minmax_engine.h"
+#include "minmax_storage.h"
+
+namespace meteodata {
+
+MinmaxEngine::MinmaxEngine(MinmaxStorage& storage, std::size_t nbThreads, std::size_t batchSize) :
+	_storage{storage},
+	_nbThreads{std::max<std::size_t>(nbThreads, 1)},
+	_batchSize{std::max<std::size_t>(batchSize, 1)}
+{}
+
+bool MinmaxEngine::computeStation(const CassUuid& station, const date::sys_days& first, const date::sys_days& last, std::size_t& stationDays)
+{
+	std::vector<MinmaxStorage::Values> values;
+	date::days batch{static_cast<int>(_batchSize)};
+	for (date::sys_days begin = first ; begin <= last ; begin += batch) {
+		date::sys_days end = std::min(last, begin + batch - date::days{1});
+		// Each batch is stored before the next one is computed since
+		// its cumulative values are read back to chain the next ones
+		if (!_storage.getValuesForRange(station, begin, end, values) ||
+		    !_storage.insertDataPointsInTimescaleDB(station, begin, values))
+			return false;
+		stationDays += values.size();
+	}
+	return true;
+}
+
+std::size_t MinmaxEngine::run(const std::vector<CassUuid>& stations, const date::sys_days& first, const date::sys_days& last, std::vector<CassUuid>* failures)
+{
+	std::atomic<std::size_t> next{0};
+	std::atomic<std::size_t> total{0};
+	std::mutex failuresMutex;
+
+	auto work = [&]() {
+		std::size_t stationDays = 0;
+		for (std::size_t i = next++ ; i < stations.size() ; i = next++) {
+			if (!computeStation(stations[i], first, last, stationDays) && failures) {
+				std::lock_guard locked{failuresMutex};
+				failures->push_back(stations[i]);
+			}
+		}
+		total += stationDays;
+	};
+
+	std::size_t nbThreads = std::min(_nbThreads, stations.size());
+	if (nbThreads <= 1) {
+		work();
+	} else {
+		std::vector<std::thread> threads;
+		for (std::size_t t = 0 ; t < nbThreads ; t++)
+			threads.emplace_back(work);
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+	return total;
+}
+
+}
@@ -0,0 +1,110 @@
+/**
+ * @file minmax_engine.h
+ * @brief Definition of the MinmaxEngine class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MINMAX_ENGINE_H
+#define MINMAX_ENGINE_H
+
+#include <cstddef>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "minmax_storage.h"
+
+namespace meteodata {
+
+/**
+ * @brief Compute and store the daily minmax values of several stations in
+ * parallel
+ *
+ * The stations are spread over a number of threads, each thread computing
+ * its stations one after the other, a batch of days at a time with
+ * MinmaxStorage::getValuesForRange(), and storing each batch with
+ * MinmaxStorage::insertDataPointsInTimescaleDB() before computing the next
+ * one, whose cumulative values are chained from it.
+ *
+ * The storage is shared by all the threads. To give each thread its own
+ * connection to PostgreSQL, a DbConnectionMinmax must be constructed with a
+ * pool of at least as many connections as threads (see
+ * ConnectionOptions::pgPoolSize).
+ */
+class MinmaxEngine
+{
+public:
+	/**
+	 * @brief Construct the engine
+	 *
+	 * @param storage Where the observations are read and the values
+	 * stored, it must outlive the engine
+	 * @param nbThreads The number of stations computed at the same time,
+	 * at least one
+	 * @param batchSize The number of days computed and stored at once for
+	 * a station, at least one
+	 */
+	explicit MinmaxEngine(MinmaxStorage& storage, std::size_t nbThreads = 1, std::size_t batchSize = 31);
+
+	/**
+	 * @brief Compute and store the values of all the days from \a first
+	 * to \a last, both included, for a list of stations
+	 *
+	 * This method blocks until all the stations are done.
+	 *
+	 * @param stations The stations to compute
+	 * @param first The first day to compute
+	 * @param last The last day to compute
+	 * @param[out] failures If not null, where to store the stations whose
+	 * values could not be computed or stored entirely
+	 *
+	 * @return The number of station-days computed and stored
+	 */
+	std::size_t run(const std::vector<CassUuid>& stations, const date::sys_days& first, const date::sys_days& last, std::vector<CassUuid>* failures = nullptr);
+
+	/**
+	 * @brief Get the number of threads of the engine
+	 */
+	std::size_t nbThreads() const { return _nbThreads; }
+
+	/**
+	 * @brief Get the number of days computed and stored at once
+	 */
+	std::size_t batchSize() const { return _batchSize; }
+
+private:
+	MinmaxStorage& _storage;
+	std::size_t _nbThreads;
+	std::size_t _batchSize;
+
+	/**
+	 * @brief Compute and store the values of one station
+	 *
+	 * @param[out] stationDays Where to add the number of days stored
+	 *
+	 * @return True if all the days have been stored, false otherwise
+	 */
+	bool computeStation(const CassUuid& station, const date::sys_days& first, const date::sys_days& last, std::size_t& stationDays);
+};
+
+}
+
+#endif
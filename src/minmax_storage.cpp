@@ -0,0 +1,94 @@
+/**
+ * @file minmax_storage.cpp
+ * @brief Implementation of the MinmaxStorage interface
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "minmax_storage.h"
+
+namespace meteodata {
+
+namespace {
+	std::pair<bool, float> sum(const std::pair<bool, float>& total, const std::pair<bool, float>& value)
+	{
+		if (total.first && value.first)
+			return { true, total.second + value.second };
+		return total.first ? total : value;
+	}
+}
+
+bool MinmaxStorage::insertDataPointsInTimescaleDB(const CassUuid& station, const date::sys_days& first, const std::vector<Values>& values)
+{
+	date::sys_days day = first;
+	for (const Values& v : values) {
+		if (!insertDataPointInTimescaleDB(station, day, v))
+			return false;
+		day += date::days{1};
+	}
+	return true;
+}
+
+bool MinmaxStorage::getValuesForRange(const CassUuid& station, const date::sys_days& first, const date::sys_days& last, std::vector<Values>& values)
+{
+	values.clear();
+	if (last < first)
+		return true;
+
+	values.resize((last - first).count() + 1);
+	date::sys_days day = first;
+	for (Values& v : values) {
+		if (!getValues6hTo6h(station, day, v) || !getValues18hTo18h(station, day, v) || !getValues0hTo0h(station, day, v))
+			return false;
+		day += date::days{1};
+	}
+
+	Values previous;
+	bool known = getCumulativeValues(station, first - date::days{1}, previous);
+	chainCumulativeValues(first, known ? &previous : nullptr, values);
+	return true;
+}
+
+void MinmaxStorage::chainCumulativeValues(const date::sys_days& first, const Values* previous, std::vector<Values>& values)
+{
+	date::sys_days day = first;
+	for (Values& v : values) {
+		date::year_month_day ymd{day};
+		bool newMonth = !previous || ymd.day() == date::day{1};
+		bool newYear = !previous || (ymd.day() == date::day{1} && ymd.month() == date::January);
+
+		v.dayRain = v.rainfall;
+		v.dayEt = v.et;
+		v.monthRain = newMonth ? v.dayRain : sum(previous->monthRain, v.dayRain);
+		v.monthEt = newMonth ? v.dayEt : sum(previous->monthEt, v.dayEt);
+		v.yearRain = newYear ? v.dayRain : sum(previous->yearRain, v.dayRain);
+		v.yearEt = newYear ? v.dayEt : sum(previous->yearEt, v.dayEt);
+
+		previous = &v;
+		day += date::days{1};
+	}
+}
+
+}
@@ -0,0 +1,228 @@
+/**
+ * @file minmax_storage.h
+ * @brief Definition of the MinmaxStorage interface
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MINMAX_STORAGE_H
+#define MINMAX_STORAGE_H
+
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "wind_histogram.h"
+
+namespace meteodata {
+
+/**
+ * @brief The storage of the daily minima and maxima of the stations, and of
+ * the observations they are computed from
+ *
+ * DbConnectionMinmax implements it on top of Cassandra and TimescaleDB, the
+ * InMemoryMinmaxStorage implements it without any database, for the
+ * benchmarks and the tests.
+ */
+class MinmaxStorage
+{
+public:
+	virtual ~MinmaxStorage() = default;
+
+	struct Values
+	{
+		// Values from 6h to 6h
+		std::pair<bool, float> insideTemp_max;
+		std::pair<bool, float> leafTemp_max[2];
+		std::pair<bool, float> outsideTemp_max;
+		std::pair<bool, float> soilTemp_max[4];
+		std::pair<bool, float> extraTemp_max[3];
+		std::pair<bool, float> rainfall;
+
+		// Values from 18h to 18h
+		std::pair<bool, float> insideTemp_min;
+		std::pair<bool, float> leafTemp_min[2];
+		std::pair<bool, float> outsideTemp_min;
+		std::pair<bool, float> soilTemp_min[4];
+		std::pair<bool, float> extraTemp_min[3];
+
+		// Values from 0h to 0h
+		std::pair<bool, float> barometer_min;
+		std::pair<bool, float> barometer_max;
+		std::pair<bool, float> barometer_avg;
+		std::pair<bool, int> leafWetnesses_min[2];
+		std::pair<bool, int> leafWetnesses_max[2];
+		std::pair<bool, int> leafWetnesses_avg[2];
+		std::pair<bool, int> soilMoistures_min[4];
+		std::pair<bool, int> soilMoistures_max[4];
+		std::pair<bool, int> soilMoistures_avg[4];
+		std::pair<bool, int> insideHum_min;
+		std::pair<bool, int> insideHum_max;
+		std::pair<bool, int> insideHum_avg;
+		std::pair<bool, int> outsideHum_min;
+		std::pair<bool, int> outsideHum_max;
+		std::pair<bool, int> outsideHum_avg;
+		std::pair<bool, int> extraHum_min[2];
+		std::pair<bool, int> extraHum_max[2];
+		std::pair<bool, int> extraHum_avg[2];
+		std::pair<bool, int> solarRad_max;
+		std::pair<bool, int> solarRad_avg;
+		std::pair<bool, int> uv_max;
+		std::pair<bool, int> uv_avg;
+		std::pair<bool, std::vector<int>> winddir;
+		/**
+		 * @brief The distribution of the wind behind winddir, with the
+		 * speed classes, it's not stored in the database
+		 */
+		std::pair<bool, WindHistogram> windHistogram;
+		std::pair<bool, float> windgust_max;
+		std::pair<bool, float> windgust_avg;
+		std::pair<bool, float> windspeed_max;
+		std::pair<bool, float> windspeed_avg;
+		std::pair<bool, float> rainrate_max;
+		std::pair<bool, float> dewpoint_min;
+		std::pair<bool, float> dewpoint_max;
+		std::pair<bool, float> dewpoint_avg;
+		std::pair<bool, float> et;
+		std::pair<bool, int> insolation_time;
+
+		// Computed values
+		std::pair<bool, float> dayRain;
+		std::pair<bool, float> monthRain;
+		std::pair<bool, float> yearRain;
+		std::pair<bool, float> dayEt;
+		std::pair<bool, float> monthEt;
+		std::pair<bool, float> yearEt;
+		std::pair<bool, float> insideTemp_avg;
+		std::pair<bool, float> leafTemp_avg[4];
+		std::pair<bool, float> outsideTemp_avg;
+		std::pair<bool, float> soilTemp_avg[4];
+		std::pair<bool, float> extraTemp_avg[3];
+	};
+
+	/**
+	 * @brief Store the values computed for a day
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool insertDataPoint(const CassUuid& station, const date::sys_days& date, const Values& values) = 0;
+
+	/**
+	 * @brief Store the values computed for a day in the database read
+	 * by \a getYearlyValues()
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool insertDataPointInTimescaleDB(const CassUuid& station, const date::sys_days& date, const Values& values) = 0;
+
+	/**
+	 * @brief Store the values computed for consecutive days in the
+	 * database read by \a getYearlyValues()
+	 *
+	 * The default implementation stores the days one by one, the
+	 * implementations should store them all at once.
+	 *
+	 * @param first The day of the first element of \a values
+	 * @param values The values of consecutive days
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool insertDataPointsInTimescaleDB(const CassUuid& station, const date::sys_days& first, const std::vector<Values>& values);
+
+	/**
+	 * @brief Compute the maxima of the temperatures and the rainfall from
+	 * \a date at 6h to the day after at 6h
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool getValues6hTo6h(const CassUuid& station, const date::sys_days& date, Values& values) = 0;
+
+	/**
+	 * @brief Compute the minima of the temperatures from the day before
+	 * \a date at 18h to \a date at 18h
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool getValues18hTo18h(const CassUuid& station, const date::sys_days& date, Values& values) = 0;
+
+	/**
+	 * @brief Compute the other values over the civil day \a date
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool getValues0hTo0h(const CassUuid& station, const date::sys_days& date, Values& values) = 0;
+
+	/**
+	 * @brief Get the cumulative rainfall and evapotranspiration since the
+	 * beginning of the year, as stored for \a date
+	 *
+	 * @return True if the values could be read, false otherwise
+	 */
+	virtual bool getYearlyValues(const CassUuid& station, const date::sys_days& date, std::pair<bool, float>& rain, std::pair<bool, float>& et) = 0;
+
+	/**
+	 * @brief Get the cumulative rainfall and evapotranspiration since the
+	 * beginning of the month and of the year, as stored for \a date
+	 *
+	 * Only the monthRain, monthEt, yearRain and yearEt members of \a
+	 * values are set.
+	 *
+	 * @return True if values are stored for \a date, false otherwise
+	 */
+	virtual bool getCumulativeValues(const CassUuid& station, const date::sys_days& date, Values& values) = 0;
+
+	/**
+	 * @brief Compute the values of all the days from \a first to \a last,
+	 * both included
+	 *
+	 * The windows are the same as the ones of getValues6hTo6h(),
+	 * getValues18hTo18h() and getValues0hTo0h(), and the daily, monthly
+	 * and yearly sums of rainfall and evapotranspiration are chained from
+	 * the cumulative values stored for the day before \a first. The
+	 * default implementation computes the days one by one, the
+	 * implementations should read the observations of the whole range at
+	 * once.
+	 *
+	 * @param[out] values The values, one per day, the first one being the
+	 * values of \a first
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool getValuesForRange(const CassUuid& station, const date::sys_days& first, const date::sys_days& last, std::vector<Values>& values);
+
+	/**
+	 * @brief Compute the daily, monthly and yearly sums of rainfall and
+	 * evapotranspiration of consecutive days
+	 *
+	 * The monthly sums start over on the first day of each month, and the
+	 * yearly sums on the first of January.
+	 *
+	 * @param first The day of the first element of \a values
+	 * @param previous The values of the day before \a first, with at
+	 * least the cumulative values, or nullptr if they are unknown
+	 * @param[in,out] values The values of consecutive days
+	 */
+	static void chainCumulativeValues(const date::sys_days& first, const Values* previous, std::vector<Values>& values);
+};
+
+}
+
+#endif
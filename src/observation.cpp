@@ -21,7 +21,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <exception>
+#include <iterator>
 #include <optional>
 
 #include <cassandra.h>
@@ -43,196 +45,218 @@ void Observation::setTimestamp(date::sys_seconds timestamp)
 	time = timestamp;
 }
 
+namespace {
+	constexpr Observation::VariableType FLOAT = Observation::VariableType::FLOAT;
+	constexpr Observation::VariableType INT = Observation::VariableType::INT;
+
+	/**
+	 * @brief All the names of the variables, sorted by name
+	 *
+	 * Some variables are stored in a member whose type is not the type of
+	 * the variable (e.g. the soil moistures are integer variables stored as
+	 * floats), the value is converted when stored and read.
+	 */
+	constexpr Observation::VariableDescriptor VARIABLES[] = {
+		{ "barometer", FLOAT, [](Observation& o) { return &o.barometer; } },
+		{ "dew_point", FLOAT, [](Observation& o) { return &o.dewpoint; } },
+		{ "dewpoint", FLOAT, [](Observation& o) { return &o.dewpoint; } },
+		{ "et", FLOAT, [](Observation& o) { return &o.et; } },
+		{ "etp", FLOAT, [](Observation& o) { return &o.et; } },
+		{ "evapotranspiration", FLOAT, [](Observation& o) { return &o.et; } },
+		{ "extra_humidity1", INT, [](Observation& o) { return &o.extrahum[0]; } },
+		{ "extra_humidity2", INT, [](Observation& o) { return &o.extrahum[1]; } },
+		{ "extra_temperature1", FLOAT, [](Observation& o) { return &o.extratemp[0]; } },
+		{ "extra_temperature2", FLOAT, [](Observation& o) { return &o.extratemp[1]; } },
+		{ "extra_temperature3", FLOAT, [](Observation& o) { return &o.extratemp[2]; } },
+		{ "extrahum1", INT, [](Observation& o) { return &o.extrahum[0]; } },
+		{ "extrahum2", INT, [](Observation& o) { return &o.extrahum[1]; } },
+		{ "extratemp1", FLOAT, [](Observation& o) { return &o.extratemp[0]; } },
+		{ "extratemp2", FLOAT, [](Observation& o) { return &o.extratemp[1]; } },
+		{ "extratemp3", FLOAT, [](Observation& o) { return &o.extratemp[2]; } },
+		{ "heatindex", FLOAT, [](Observation& o) { return &o.heatindex; } },
+		{ "inside_humidity", INT, [](Observation& o) { return &o.insidehum; } },
+		{ "inside_temperature", FLOAT, [](Observation& o) { return &o.insidetemp; } },
+		{ "insidehum", INT, [](Observation& o) { return &o.insidehum; } },
+		{ "insidetemp", FLOAT, [](Observation& o) { return &o.insidetemp; } },
+		{ "insolation_time", INT, [](Observation& o) { return &o.insolation_time; } },
+		{ "leaf_temperature1", FLOAT, [](Observation& o) { return &o.leaftemp[0]; } },
+		{ "leaf_temperature2", FLOAT, [](Observation& o) { return &o.leaftemp[1]; } },
+		{ "leaf_wetness1", INT, [](Observation& o) { return &o.leafwetnesses[0]; } },
+		{ "leaf_wetness2", INT, [](Observation& o) { return &o.leafwetnesses[1]; } },
+		{ "leaf_wetness_percent1", FLOAT, [](Observation& o) { return &o.leafwetness_percent1; } },
+		{ "leaftemp1", FLOAT, [](Observation& o) { return &o.leaftemp[0]; } },
+		{ "leaftemp2", FLOAT, [](Observation& o) { return &o.leaftemp[1]; } },
+		{ "leafwetness_percent1", FLOAT, [](Observation& o) { return &o.leafwetness_percent1; } },
+		{ "leafwetness_timeratio1", INT, [](Observation& o) { return &o.leafwetness_timeratio1; } },
+		{ "leafwetnesses1", INT, [](Observation& o) { return &o.leafwetnesses[0]; } },
+		{ "leafwetnesses2", INT, [](Observation& o) { return &o.leafwetnesses[1]; } },
+		{ "max_outside_temperature", FLOAT, [](Observation& o) { return &o.max_outside_temperature; } },
+		{ "min_outside_temperature", FLOAT, [](Observation& o) { return &o.min_outside_temperature; } },
+		{ "min_wind_speed", FLOAT, [](Observation& o) { return &o.min_windspeed; } },
+		{ "min_windspeed", FLOAT, [](Observation& o) { return &o.min_windspeed; } },
+		{ "outside_humidity", INT, [](Observation& o) { return &o.outsidehum; } },
+		{ "outside_temperature", FLOAT, [](Observation& o) { return &o.outsidetemp; } },
+		{ "outsidehum", INT, [](Observation& o) { return &o.outsidehum; } },
+		{ "outsidetemp", FLOAT, [](Observation& o) { return &o.outsidetemp; } },
+		{ "pressure", FLOAT, [](Observation& o) { return &o.barometer; } },
+		{ "rain_rate", FLOAT, [](Observation& o) { return &o.rainrate; } },
+		{ "rainfall", FLOAT, [](Observation& o) { return &o.rainfall; } },
+		{ "rainrate", FLOAT, [](Observation& o) { return &o.rainrate; } },
+		{ "soil_conductivity1", FLOAT, [](Observation& o) { return &o.soil_conductivity1; } },
+		{ "soil_moisture1", INT, [](Observation& o) { return &o.soilmoistures[0]; } },
+		{ "soil_moisture2", INT, [](Observation& o) { return &o.soilmoistures[1]; } },
+		{ "soil_moisture3", INT, [](Observation& o) { return &o.soilmoistures[2]; } },
+		{ "soil_moisture4", INT, [](Observation& o) { return &o.soilmoistures[3]; } },
+		{ "soil_moisture_10cm", FLOAT, [](Observation& o) { return &o.soilmoistures10cm; } },
+		{ "soil_moisture_20cm", FLOAT, [](Observation& o) { return &o.soilmoistures20cm; } },
+		{ "soil_moisture_30cm", FLOAT, [](Observation& o) { return &o.soilmoistures30cm; } },
+		{ "soil_moisture_40cm", FLOAT, [](Observation& o) { return &o.soilmoistures40cm; } },
+		{ "soil_moisture_50cm", FLOAT, [](Observation& o) { return &o.soilmoistures50cm; } },
+		{ "soil_moisture_60cm", FLOAT, [](Observation& o) { return &o.soilmoistures60cm; } },
+		{ "soil_temp1", FLOAT, [](Observation& o) { return &o.soiltemp[0]; } },
+		{ "soil_temp2", FLOAT, [](Observation& o) { return &o.soiltemp[1]; } },
+		{ "soil_temp3", FLOAT, [](Observation& o) { return &o.soiltemp[2]; } },
+		{ "soil_temp4", FLOAT, [](Observation& o) { return &o.soiltemp[3]; } },
+		{ "soil_temp_10cm", FLOAT, [](Observation& o) { return &o.soiltemp10cm; } },
+		{ "soil_temp_20cm", FLOAT, [](Observation& o) { return &o.soiltemp20cm; } },
+		{ "soil_temp_30cm", FLOAT, [](Observation& o) { return &o.soiltemp30cm; } },
+		{ "soil_temp_40cm", FLOAT, [](Observation& o) { return &o.soiltemp40cm; } },
+		{ "soil_temp_50cm", FLOAT, [](Observation& o) { return &o.soiltemp50cm; } },
+		{ "soil_temp_60cm", FLOAT, [](Observation& o) { return &o.soiltemp60cm; } },
+		{ "soil_temperature1", FLOAT, [](Observation& o) { return &o.soiltemp[0]; } },
+		{ "soil_temperature2", FLOAT, [](Observation& o) { return &o.soiltemp[1]; } },
+		{ "soil_temperature3", FLOAT, [](Observation& o) { return &o.soiltemp[2]; } },
+		{ "soil_temperature4", FLOAT, [](Observation& o) { return &o.soiltemp[3]; } },
+		{ "soil_temperature_10cm", FLOAT, [](Observation& o) { return &o.soiltemp10cm; } },
+		{ "soil_temperature_20cm", FLOAT, [](Observation& o) { return &o.soiltemp20cm; } },
+		{ "soil_temperature_30cm", FLOAT, [](Observation& o) { return &o.soiltemp30cm; } },
+		{ "soil_temperature_40cm", FLOAT, [](Observation& o) { return &o.soiltemp40cm; } },
+		{ "soil_temperature_50cm", FLOAT, [](Observation& o) { return &o.soiltemp50cm; } },
+		{ "soil_temperature_60cm", FLOAT, [](Observation& o) { return &o.soiltemp60cm; } },
+		{ "soilmoistures1", INT, [](Observation& o) { return &o.soilmoistures[0]; } },
+		{ "soilmoistures10cm", FLOAT, [](Observation& o) { return &o.soilmoistures10cm; } },
+		{ "soilmoistures2", INT, [](Observation& o) { return &o.soilmoistures[1]; } },
+		{ "soilmoistures20cm", FLOAT, [](Observation& o) { return &o.soilmoistures20cm; } },
+		{ "soilmoistures3", INT, [](Observation& o) { return &o.soilmoistures[2]; } },
+		{ "soilmoistures30cm", FLOAT, [](Observation& o) { return &o.soilmoistures30cm; } },
+		{ "soilmoistures4", INT, [](Observation& o) { return &o.soilmoistures[3]; } },
+		{ "soilmoistures40cm", FLOAT, [](Observation& o) { return &o.soilmoistures40cm; } },
+		{ "soilmoistures50cm", FLOAT, [](Observation& o) { return &o.soilmoistures50cm; } },
+		{ "soilmoistures60cm", FLOAT, [](Observation& o) { return &o.soilmoistures60cm; } },
+		{ "soiltemp1", FLOAT, [](Observation& o) { return &o.soiltemp[0]; } },
+		{ "soiltemp10cm", FLOAT, [](Observation& o) { return &o.soiltemp10cm; } },
+		{ "soiltemp2", FLOAT, [](Observation& o) { return &o.soiltemp[1]; } },
+		{ "soiltemp20cm", FLOAT, [](Observation& o) { return &o.soiltemp20cm; } },
+		{ "soiltemp3", FLOAT, [](Observation& o) { return &o.soiltemp[2]; } },
+		{ "soiltemp30cm", FLOAT, [](Observation& o) { return &o.soiltemp30cm; } },
+		{ "soiltemp4", FLOAT, [](Observation& o) { return &o.soiltemp[3]; } },
+		{ "soiltemp40cm", FLOAT, [](Observation& o) { return &o.soiltemp40cm; } },
+		{ "soiltemp50cm", FLOAT, [](Observation& o) { return &o.soiltemp50cm; } },
+		{ "soiltemp60cm", FLOAT, [](Observation& o) { return &o.soiltemp60cm; } },
+		{ "solar_radiation", INT, [](Observation& o) { return &o.solarrad; } },
+		{ "solarrad", INT, [](Observation& o) { return &o.solarrad; } },
+		{ "thsw_index", FLOAT, [](Observation& o) { return &o.thswindex; } },
+		{ "thswindex", FLOAT, [](Observation& o) { return &o.thswindex; } },
+		{ "uv", INT, [](Observation& o) { return &o.uv; } },
+		{ "uv_index", INT, [](Observation& o) { return &o.uv; } },
+		{ "voltage_backup", FLOAT, [](Observation& o) { return &o.voltage_backup; } },
+		{ "voltage_battery", FLOAT, [](Observation& o) { return &o.voltage_battery; } },
+		{ "voltage_solar_panel", FLOAT, [](Observation& o) { return &o.voltage_solar_panel; } },
+		{ "wind_direction", INT, [](Observation& o) { return &o.winddir; } },
+		{ "wind_speed", FLOAT, [](Observation& o) { return &o.windspeed; } },
+		{ "windchill", FLOAT, [](Observation& o) { return &o.windchill; } },
+		{ "winddir", INT, [](Observation& o) { return &o.winddir; } },
+		{ "windgust", FLOAT, [](Observation& o) { return &o.windgust; } },
+		{ "windgust_speed", FLOAT, [](Observation& o) { return &o.windgust; } },
+		{ "windspeed", FLOAT, [](Observation& o) { return &o.windspeed; } },
+	};
+
+	constexpr bool isSortedByName()
+	{
+		for (std::size_t i = 1 ; i < std::size(VARIABLES) ; i++) {
+			if (!(VARIABLES[i - 1].name < VARIABLES[i].name))
+				return false;
+		}
+		return true;
+	}
+	static_assert(isSortedByName(), "The variables table must be sorted by name for resolve()");
+}
+
+Observation::VariableHandle Observation::resolve(std::string_view column)
+{
+	auto it = std::lower_bound(std::begin(VARIABLES), std::end(VARIABLES), column,
+		[](const VariableDescriptor& variable, std::string_view name) { return variable.name < name; });
+	if (it == std::end(VARIABLES) || it->name != column)
+		return nullptr;
+	return &*it;
+}
+
 bool Observation::isValidIntVariable(const std::string& variable)
 {
-	return std::find(VALID_VAR_INTS.begin(), VALID_VAR_INTS.end(), variable) != VALID_VAR_INTS.end();
+	VariableHandle v = resolve(variable);
+	return v && v->type == VariableType::INT;
 }
 
 bool Observation::isValidFloatVariable(const std::string& variable)
 {
-	return std::find(VALID_VAR_FLOATS.begin(), VALID_VAR_FLOATS.end(), variable) != VALID_VAR_FLOATS.end();
+	VariableHandle v = resolve(variable);
+	return v && v->type == VariableType::FLOAT;
 }
 
-void Observation::set(const std::string& column, float value)
+template<typename T>
+void Observation::store(VariableHandle variable, T value)
 {
-	if (column == "barometer" || column == "pressure") {
-		barometer.first = true;
-		barometer.second = value;
-	} else if (column == "dewpoint" || column == "dew_point") {
-		dewpoint.first = true;
-		dewpoint.second = value;
-	} else if (column == "extratemp1" || column == "extra_temperature1") {
-		extratemp[0].first = true;
-		extratemp[0].second = value;
-	} else if (column == "extratemp2" || column == "extra_temperature2") {
-		extratemp[1].first = true;
-		extratemp[1].second = value;
-	} else if (column == "extratemp3" || column == "extra_temperature3") {
-		extratemp[2].first = true;
-		extratemp[2].second = value;
-	} else if (column == "heatindex") {
-		heatindex.first = true;
-		heatindex.second = value;
-	} else if (column == "insidetemp" || column == "inside_temperature") {
-		insidetemp.first = true;
-		insidetemp.second = value;
-	} else if (column == "leaftemp1" || column == "leaf_temperature1") {
-		leaftemp[0].first = true;
-		leaftemp[0].second = value;
-	} else if (column == "leaftemp2" || column == "leaf_temperature2") {
-		leaftemp[1].first = true;
-		leaftemp[1].second = value;
-	} else if (column == "outsidetemp" || column == "outside_temperature") {
-		outsidetemp.first = true;
-		outsidetemp.second = value;
-	} else if (column == "rainrate" || column == "rain_rate") {
-		rainrate.first = true;
-		rainrate.second = value;
-	} else if (column == "rainfall") {
-		rainfall.first = true;
-		rainfall.second = value;
-	} else if (column == "et" || column == "etp" || column == "evapotranspiration") {
-		et.first = true;
-		et.second = value;
-	} else if (column == "soiltemp1" || column == "soil_temp1" || column == "soil_temperature1") {
-		soiltemp[0].first = true;
-		soiltemp[0].second = value;
-	} else if (column == "soiltemp2" || column == "soil_temp2" || column == "soil_temperature2") {
-		soiltemp[1].first = true;
-		soiltemp[1].second = value;
-	} else if (column == "soiltemp3" || column == "soil_temp3" || column == "soil_temperature3") {
-		soiltemp[2].first = true;
-		soiltemp[2].second = value;
-	} else if (column == "soiltemp4" || column == "soil_temp4" || column == "soil_temperature4") {
-		soiltemp[3].first = true;
-		soiltemp[3].second = value;
-	} else if (column == "thswindex" || column == "thsw_index") {
-		thswindex.first = true;
-		thswindex.second = value;
-	} else if (column == "windchill") {
-		windchill.first = true;
-		windchill.second = value;
-	} else if (column == "windgust" || column == "windgust_speed") {
-		windgust.first = true;
-		windgust.second = value;
-	} else if (column == "min_windspeed" || column == "min_wind_speed") {
-		min_windspeed.first = true;
-		min_windspeed.second = value;
-	} else if (column == "windspeed" || column == "wind_speed") {
-		windspeed.first = true;
-		windspeed.second = value;
-	} else if (column == "min_outside_temperature") {
-		min_outside_temperature.first = true;
-		min_outside_temperature.second = value;
-	} else if (column == "max_outside_temperature") {
-		max_outside_temperature.first = true;
-		max_outside_temperature.second = value;
-	} else if (column == "soilmoistures10cm" || column == "soil_moisture_10cm") {
-		soilmoistures10cm.first = true;
-		soilmoistures10cm.second = value;
-	} else if (column == "soilmoistures20cm" || column == "soil_moisture_20cm") {
-		soilmoistures20cm.first = true;
-		soilmoistures20cm.second = value;
-	} else if (column == "soilmoistures30cm" || column == "soil_moisture_30cm") {
-		soilmoistures30cm.first = true;
-		soilmoistures30cm.second = value;
-	} else if (column == "soilmoistures40cm" || column == "soil_moisture_40cm") {
-		soilmoistures40cm.first = true;
-		soilmoistures40cm.second = value;
-	} else if (column == "soilmoistures50cm" || column == "soil_moisture_50cm") {
-		soilmoistures50cm.first = true;
-		soilmoistures50cm.second = value;
-	} else if (column == "soilmoistures60cm" || column == "soil_moisture_60cm") {
-		soilmoistures60cm.first = true;
-		soilmoistures60cm.second = value;
-	} else if (column == "soiltemp10cm" || column == "soil_temp_10cm" || column == "soil_temperature_10cm") {
-		soiltemp10cm.first = true;
-		soiltemp10cm.second = value;
-	} else if (column == "soiltemp20cm" || column == "soil_temp_20cm" || column == "soil_temperature_20cm") {
-		soiltemp20cm.first = true;
-		soiltemp20cm.second = value;
-	} else if (column == "soiltemp30cm" || column == "soil_temp_30cm" || column == "soil_temperature_30cm") {
-		soiltemp30cm.first = true;
-		soiltemp30cm.second = value;
-	} else if (column == "soiltemp40cm" || column == "soil_temp_40cm" || column == "soil_temperature_40cm") {
-		soiltemp40cm.first = true;
-		soiltemp40cm.second = value;
-	} else if (column == "soiltemp50cm" || column == "soil_temp_50cm" || column == "soil_temperature_50cm") {
-		soiltemp50cm.first = true;
-		soiltemp50cm.second = value;
-	} else if (column == "soiltemp60cm" || column == "soil_temp_60cm" || column == "soil_temperature_60cm") {
-		soiltemp60cm.first = true;
-		soiltemp60cm.second = value;
-	} else if (column == "leafwetness_percent1" || column == "leaf_wetness_percent1") {
-		leafwetness_percent1.first = true;
-		leafwetness_percent1.second = value;
-	} else if (column == "soil_conductivity1") {
-		soil_conductivity1.first = true;
-		soil_conductivity1.second = value;
-	} else if (column == "voltage_battery") {
-		voltage_battery.first = true;
-		voltage_battery.second = value;
-	} else if (column == "voltage_solar_panel") {
-		voltage_solar_panel.first = true;
-		voltage_solar_panel.second = value;
-	} else if (column == "voltage_backup") {
-		voltage_backup.first = true;
-		voltage_backup.second = value;
+	if (variable->floatField) {
+		auto* field = variable->floatField(*this);
+		field->first = true;
+		field->second = value;
 	} else {
-		throw std::runtime_error("Column '" + column + "' does not exist or is not a float");
+		auto* field = variable->intField(*this);
+		field->first = true;
+		field->second = value;
 	}
 }
 
+template<typename T>
+T Observation::load(VariableHandle variable) const
+{
+	// The accessors are shared by the const and non-const methods, the
+	// field is only read here
+	Observation& self = const_cast<Observation&>(*this);
+	if (variable->floatField)
+		return variable->floatField(self)->second;
+	else
+		return variable->intField(self)->second;
+}
+
+void Observation::set(const std::string& column, float value)
+{
+	VariableHandle variable = resolve(column);
+	if (!variable || variable->type != VariableType::FLOAT)
+		throw std::runtime_error("Column '" + column + "' does not exist or is not a float");
+	store(variable, value);
+}
+
 void Observation::set(const std::string& column, int value)
 {
-	if (column == "extrahum1" || column == "extra_humidity1") {
-		extrahum[0].first = true;
-		extrahum[0].second = value;
-	} else if (column == "extrahum2" || column == "extra_humidity2") {
-		extrahum[1].first = true;
-		extrahum[1].second = value;
-	} else if (column == "insidehum" || column == "inside_humidity") {
-		insidehum.first = true;
-		insidehum.second = value;
-	} else if (column == "leafwetnesses1" || column == "leaf_wetness1") {
-		leafwetnesses[0].first = true;
-		leafwetnesses[0].second = value;
-	} else if (column == "leafwetnesses2" || column == "leaf_wetness2") {
-		leafwetnesses[1].first = true;
-		leafwetnesses[1].second = value;
-	} else if (column == "soilmoistures1" || column == "soil_moisture1") { // mind the absence of -s
-		soilmoistures[0].first = true;
-		soilmoistures[0].second = value;
-	} else if (column == "soilmoistures2" || column == "soil_moisture2") {
-		soilmoistures[1].first = true;
-		soilmoistures[1].second = value;
-	} else if (column == "soilmoistures3" || column == "soil_moisture3") {
-		soilmoistures[2].first = true;
-		soilmoistures[2].second = value;
-	} else if (column == "soilmoistures4" || column == "soil_moisture4") {
-		soilmoistures[3].first = true;
-		soilmoistures[3].second = value;
-	} else if (column == "outsidehum" || column == "outside_humidity") {
-		outsidehum.first = true;
-		outsidehum.second = value;
-	} else if (column == "uv" || column == "uv_index") {
-		uv.first = true;
-		uv.second = value;
-	} else if (column == "winddir" || column == "wind_direction") {
-		winddir.first = true;
-		winddir.second = value;
-	} else if (column == "solarrad" || column == "solar_radiation") {
-		solarrad.first = true;
-		solarrad.second = value;
-	} else if (column == "insolation_time") {
-		insolation_time.first = true;
-		insolation_time.second = value;
-	} else if (column == "leafwetness_timeratio1") {
-		leafwetness_timeratio1.first = true;
-		leafwetness_timeratio1.second = value;
-	} else {
+	VariableHandle variable = resolve(column);
+	if (!variable || variable->type != VariableType::INT)
 		throw std::runtime_error("Column '" + column + "' does not exist or is not an integer");
-	}
+	store(variable, value);
+}
+
+void Observation::set(VariableHandle variable, float value)
+{
+	if (!variable || variable->type != VariableType::FLOAT)
+		throw std::runtime_error("Variable does not exist or is not a float");
+	store(variable, value);
+}
+
+void Observation::set(VariableHandle variable, int value)
+{
+	if (!variable || variable->type != VariableType::INT)
+		throw std::runtime_error("Variable does not exist or is not an integer");
+	store(variable, value);
 }
 
 template<>
@@ -248,251 +272,55 @@ CassUuid Observation::get<CassUuid>(const std::string& column) const
 template<>
 float Observation::get<float>(const std::string& column) const
 {
-	if (column == "barometer" || column == "pressure") {
-		return barometer.second;
-	} else if (column == "dewpoint" || column == "dew_point") {
-		return dewpoint.second;
-	} else if (column == "extratemp1" || column == "extra_temperature1") {
-		return extratemp[0].second;
-	} else if (column == "extratemp2" || column == "extra_temperature2") {
-		return extratemp[1].second;
-	} else if (column == "extratemp3" || column == "extra_temperature3") {
-		return extratemp[2].second;
-	} else if (column == "heatindex") {
-		return heatindex.second;
-	} else if (column == "insidetemp" || column == "inside_temperature") {
-		return insidetemp.second;
-	} else if (column == "leaftemp1" || column == "leaf_temperature1") {
-		return leaftemp[0].second;
-	} else if (column == "leaftemp2" || column == "leaf_temperature2") {
-		return leaftemp[1].second;
-	} else if (column == "outsidetemp" || column == "outside_temperature") {
-		return outsidetemp.second;
-	} else if (column == "rainrate" || column == "rain_rate") {
-		return rainrate.second;
-	} else if (column == "rainfall") {
-		return rainfall.second;
-	} else if (column == "et" || column == "etp" || column == "evapotranspiration") {
-		return et.second;
-	} else if (column == "soiltemp1" || column == "soil_temp1" || column == "soil_temperature1") {
-		return soiltemp[0].second;
-	} else if (column == "soiltemp2" || column == "soil_temp2" || column == "soil_temperature2") {
-		return soiltemp[1].second;
-	} else if (column == "soiltemp3" || column == "soil_temp3" || column == "soil_temperature3") {
-		return soiltemp[2].second;
-	} else if (column == "soiltemp4" || column == "soil_temp4" || column == "soil_temperature4") {
-		return soiltemp[3].second;
-	} else if (column == "thswindex" || column == "thsw_index") {
-		return thswindex.second;
-	} else if (column == "windchill") {
-		return windchill.second;
-	} else if (column == "windgust" || column == "windgust_speed") {
-		return windgust.second;
-	} else if (column == "min_windspeed" || column == "min_wind_speed") {
-		return min_windspeed.second;
-	} else if (column == "windspeed" || column == "wind_speed") {
-		return windspeed.second;
-	} else if (column == "min_outside_temperature") {
-		return min_outside_temperature.second;
-	} else if (column == "max_outside_temperature") {
-		return max_outside_temperature.second;
-	} else if (column == "soilmoistures10cm" || column == "soil_moisture_10cm") {
-		return soilmoistures10cm.second;
-	} else if (column == "soilmoistures20cm" || column == "soil_moisture_20cm") {
-		return soilmoistures20cm.second;
-	} else if (column == "soilmoistures30cm" || column == "soil_moisture_30cm") {
-		return soilmoistures30cm.second;
-	} else if (column == "soilmoistures40cm" || column == "soil_moisture_40cm") {
-		return soilmoistures40cm.second;
-	} else if (column == "soilmoistures50cm" || column == "soil_moisture_50cm") {
-		return soilmoistures50cm.second;
-	} else if (column == "soilmoistures60cm" || column == "soil_moisture_60cm") {
-		return soilmoistures60cm.second;
-	} else if (column == "soiltemp10cm" || column == "soil_temp_10cm" || column == "soil_temperature_10cm") {
-		return soiltemp10cm.second;
-	} else if (column == "soiltemp20cm" || column == "soil_temp_20cm" || column == "soil_temperature_20cm") {
-		return soiltemp20cm.second;
-	} else if (column == "soiltemp30cm" || column == "soil_temp_30cm" || column == "soil_temperature_30cm") {
-		return soiltemp30cm.second;
-	} else if (column == "soiltemp40cm" || column == "soil_temp_40cm" || column == "soil_temperature_40cm") {
-		return soiltemp40cm.second;
-	} else if (column == "soiltemp50cm" || column == "soil_temp_50cm" || column == "soil_temperature_50cm") {
-		return soiltemp50cm.second;
-	} else if (column == "soiltemp60cm" || column == "soil_temp_60cm" || column == "soil_temperature_60cm") {
-		return soiltemp60cm.second;
-	} else if (column == "leafwetness_percent1" || column == "leaf_wetness_percent1") {
-		return leafwetness_percent1.second;
-	} else if (column == "soil_conductivity1") {
-		return soil_conductivity1.second;
-	} else if (column == "voltage_battery") {
-		return voltage_battery.second;
-	} else if (column == "voltage_solar_panel") {
-		return voltage_solar_panel.second;
-	} else if (column == "voltage_backup") {
-		return voltage_backup.second;
-	} else {
+	VariableHandle variable = resolve(column);
+	if (!variable || variable->type != VariableType::FLOAT)
 		throw std::runtime_error("Column '" + column + "' does not exist or is not a float");
-	}
+	return load<float>(variable);
 }
 
 template<>
 int Observation::get<int>(const std::string& column) const
 {
-	if (column == "extrahum1" || column == "extra_humidity1") {
-		return extrahum[0].second;
-	} else if (column == "extrahum2" || column == "extra_humidity2") {
-		return extrahum[1].second;
-	} else if (column == "insidehum" || column == "inside_humidity") {
-		return insidehum.second;
-	} else if (column == "leafwetnesses1" || column == "leaf_wetness1") {
-		return leafwetnesses[0].second;
-	} else if (column == "leafwetnesses2" || column == "leaf_wetness2") {
-		return leafwetnesses[1].second;
-	} else if (column == "soilmoistures1" || column == "soil_moisture1") { // mind the absence of -s
-		return soilmoistures[0].second;
-	} else if (column == "soilmoistures2" || column == "soil_moisture2") {
-		return soilmoistures[1].second;
-	} else if (column == "soilmoistures3" || column == "soil_moisture3") {
-		return soilmoistures[2].second;
-	} else if (column == "soilmoistures4" || column == "soil_moisture4") {
-		return soilmoistures[3].second;
-	} else if (column == "outsidehum" || column == "outside_humidity") {
-		return outsidehum.second;
-	} else if (column == "uv" || column == "uv_index") {
-		return uv.second;
-	} else if (column == "solarrad" || column == "solar_radiation") {
-		return solarrad.second;
-	} else if (column == "winddir" || column == "wind_direction") {
-		return winddir.second;
-	} else if (column == "insolation_time") {
-		return insolation_time.second;
-	} else if (column == "leafwetness_timeratio1") {
-		return leafwetness_timeratio1.second;
-	} else {
+	VariableHandle variable = resolve(column);
+	if (!variable || variable->type != VariableType::INT)
 		throw std::runtime_error("Column '" + column + "' does not exist or is not an integer");
-	}
+	return load<int>(variable);
+}
+
+template<>
+float Observation::get<float>(VariableHandle variable) const
+{
+	if (!variable || variable->type != VariableType::FLOAT)
+		throw std::runtime_error("Variable does not exist or is not a float");
+	return load<float>(variable);
+}
+
+template<>
+int Observation::get<int>(VariableHandle variable) const
+{
+	if (!variable || variable->type != VariableType::INT)
+		throw std::runtime_error("Variable does not exist or is not an integer");
+	return load<int>(variable);
 }
 
 bool Observation::isPresent(const std::string& column) const
 {
 	if (column == "station" || column == "uuid" || column == "time" ||
-			column == "date" || column == "day") {
+			column == "date" || column == "day")
 		return true;
-	} else if (column == "barometer" || column == "pressure") {
-		return barometer.first;
-	} else if (column == "dewpoint" || column == "dew_point") {
-		return dewpoint.first;
-	} else if (column == "extratemp1" || column == "extra_temperature1") {
-		return extratemp[0].first;
-	} else if (column == "extratemp2" || column == "extra_temperature2") {
-		return extratemp[1].first;
-	} else if (column == "extratemp3" || column == "extra_temperature3") {
-		return extratemp[2].first;
-	} else if (column == "heatindex") {
-		return heatindex.first;
-	} else if (column == "insidetemp" || column == "inside_temperature") {
-		return insidetemp.first;
-	} else if (column == "leaftemp1" || column == "leaf_temperature1") {
-		return leaftemp[0].first;
-	} else if (column == "leaftemp2" || column == "leaf_temperature2") {
-		return leaftemp[1].first;
-	} else if (column == "outsidetemp" || column == "outside_temperature") {
-		return outsidetemp.first;
-	} else if (column == "rainrate" || column == "rain_rate") {
-		return rainrate.first;
-	} else if (column == "rainfall") {
-		return rainfall.first;
-	} else if (column == "et" || column == "etp" || column == "evapotranspiration") {
-		return et.first;
-	} else if (column == "soilmoistures1" || column == "soil_moisture1") { // mind the absence of -s
-		return soilmoistures[0].first;
-	} else if (column == "soilmoistures2" || column == "soil_moisture2") {
-		return soilmoistures[1].first;
-	} else if (column == "soilmoistures3" || column == "soil_moisture3") {
-		return soilmoistures[2].first;
-	} else if (column == "soilmoistures4" || column == "soil_moisture4") {
-		return soilmoistures[3].first;
-	} else if (column == "soiltemp1" || column == "soil_temp1" || column == "soil_temperature1") {
-		return soiltemp[0].first;
-	} else if (column == "soiltemp2" || column == "soil_temp2" || column == "soil_temperature2") {
-		return soiltemp[1].first;
-	} else if (column == "soiltemp3" || column == "soil_temp3" || column == "soil_temperature3") {
-		return soiltemp[2].first;
-	} else if (column == "soiltemp4" || column == "soil_temp4" || column == "soil_temperature4") {
-		return soiltemp[3].first;
-	} else if (column == "windchill") {
-		return windchill.first;
-	} else if (column == "windgust" || column == "windgust_speed") {
-		return windgust.first;
-	} else if (column == "min_windspeed" || column == "min_wind_speed") {
-		return min_windspeed.first;
-	} else if (column == "windspeed" || column == "wind_speed") {
-		return windspeed.first;
-	} else if (column == "extrahum1" || column == "extra_humidity1") {
-		return extrahum[0].first;
-	} else if (column == "extrahum2" || column == "extra_humidity2") {
-		return extrahum[1].first;
-	} else if (column == "insidehum" || column == "inside_humidity") {
-		return insidehum.first;
-	} else if (column == "leafwetnesses1" || column == "leaf_wetness1") {
-		return leafwetnesses[0].first;
-	} else if (column == "leafwetnesses2" || column == "leaf_wetness2") {
-		return leafwetnesses[1].first;
-	} else if (column == "outsidehum" || column == "outside_humidity") {
-		return outsidehum.first;
-	} else if (column == "thswindex" || column == "thsw_index") {
-		return thswindex.first;
-	} else if (column == "solarrad" || column == "solar_radiation") {
-		return solarrad.first;
-	} else if (column == "uv" || column == "uv_index") {
-		return uv.first;
-	} else if (column == "winddir" || column == "wind_direction") {
-		return winddir.first;
-	} else if (column == "insolation_time") {
-		return insolation_time.first;
-	} else if (column == "min_outside_temperature") {
-		return min_outside_temperature.first;
-	} else if (column == "max_outside_temperature") {
-		return max_outside_temperature.first;
-	} else if (column == "leafwetness_timeratio1") {
-		return leafwetness_timeratio1.first;
-	} else if (column == "soilmoistures10cm" || column == "soil_moisture_10cm") {
-		return soilmoistures10cm.first;
-	} else if (column == "soilmoistures20cm" || column == "soil_moisture_20cm") {
-		return soilmoistures20cm.first;
-	} else if (column == "soilmoistures30cm" || column == "soil_moisture_30cm") {
-		return soilmoistures30cm.first;
-	} else if (column == "soilmoistures40cm" || column == "soil_moisture_40cm") {
-		return soilmoistures40cm.first;
-	} else if (column == "soilmoistures50cm" || column == "soil_moisture_50cm") {
-		return soilmoistures50cm.first;
-	} else if (column == "soilmoistures60cm" || column == "soil_moisture_60cm") {
-		return soilmoistures60cm.first;
-	} else if (column == "soiltemp10cm" || column == "soil_temp_10cm" || column == "soil_temperature_10cm") {
-		return soiltemp10cm.first;
-	} else if (column == "soiltemp20cm" || column == "soil_temp_20cm" || column == "soil_temperature_20cm") {
-		return soiltemp20cm.first;
-	} else if (column == "soiltemp30cm" || column == "soil_temp_30cm" || column == "soil_temperature_30cm") {
-		return soiltemp30cm.first;
-	} else if (column == "soiltemp40cm" || column == "soil_temp_40cm" || column == "soil_temperature_40cm") {
-		return soiltemp40cm.first;
-	} else if (column == "soiltemp50cm" || column == "soil_temp_50cm" || column == "soil_temperature_50cm") {
-		return soiltemp50cm.first;
-	} else if (column == "soiltemp60cm" || column == "soil_temp_60cm" || column == "soil_temperature_60cm") {
-		return soiltemp60cm.first;
-	} else if (column == "leafwetness_percent1" || column == "leaf_wetness_percent1") {
-		return leafwetness_percent1.first;
-	} else if (column == "soil_conductivity1") {
-		return soil_conductivity1.first;
-	} else if (column == "voltage_battery") {
-		return voltage_battery.first;
-	} else if (column == "voltage_solar_panel") {
-		return voltage_solar_panel.first;
-	} else if (column == "voltage_backup") {
-		return voltage_backup.first;
-	} else {
+
+	VariableHandle variable = resolve(column);
+	if (!variable)
 		throw std::runtime_error("Column '" + column + "' does not exist");
-	}
+	return isPresent(variable);
+}
+
+bool Observation::isPresent(VariableHandle variable) const
+{
+	if (!variable)
+		throw std::runtime_error("Variable does not exist");
+	Observation& self = const_cast<Observation&>(*this);
+	return variable->floatField ? variable->floatField(self)->first : variable->intField(self)->first;
 }
 
 template<>
@@ -25,8 +25,10 @@
 #define OBSERVATION_H
 
 #include <ctime>
+#include <stdexcept>
 #include <string>
-#include <array>
+#include <string_view>
+#include <utility>
 
 #include <cassandra.h>
 #include <date/date.h>
@@ -85,83 +87,111 @@ public:
 	std::pair<bool,float> voltage_solar_panel      = {false,0};
 	std::pair<bool,float> voltage_backup           = {false,0};
 
+	/**
+	 * @brief The type under which a variable is set and read
+	 */
+	enum class VariableType
+	{
+		FLOAT,
+		INT
+	};
+
+	/**
+	 * @brief The description of a variable known under a given name
+	 *
+	 * There is one descriptor for each of the names of a variable, they
+	 * all give access to the same member.
+	 */
+	struct VariableDescriptor
+	{
+		std::string_view name;
+		VariableType type;
+		std::pair<bool,float>* (*floatField)(Observation&) = nullptr;
+		std::pair<bool,int  >* (*intField)(Observation&) = nullptr;
+
+		constexpr VariableDescriptor(std::string_view n, VariableType t, std::pair<bool,float>* (*field)(Observation&)) :
+			name{n}, type{t}, floatField{field}
+		{}
+		constexpr VariableDescriptor(std::string_view n, VariableType t, std::pair<bool,int  >* (*field)(Observation&)) :
+			name{n}, type{t}, intField{field}
+		{}
+	};
+
+	/**
+	 * @brief A variable resolved from its name, this is a pointer to a
+	 * static descriptor, it is valid as long as the program runs
+	 */
+	using VariableHandle = const VariableDescriptor*;
+
 	template<typename ColumnType>
 	ColumnType get(const std::string&) const
 	{
 		throw std::runtime_error("Unsupported type requested");
 	}
 
+	/**
+	 * @brief Get the value of a variable resolved beforehand
+	 *
+	 * @param variable A variable resolved with resolve(), whose type must
+	 * match \a ColumnType
+	 */
+	template<typename ColumnType>
+	ColumnType get(VariableHandle variable) const;
+
 	void setStation(CassUuid st);
 	void setTimestamp(date::sys_seconds timestamp);
 	void set(const std::string& column, float value);
 	void set(const std::string& column, int value);
 
+	/**
+	 * @brief Set the value of a variable resolved beforehand, in constant
+	 * time
+	 *
+	 * @param variable A variable of type float, resolved with resolve()
+	 * @param value The value to store
+	 */
+	void set(VariableHandle variable, float value);
+	/**
+	 * @brief Set the value of a variable resolved beforehand, in constant
+	 * time
+	 *
+	 * @param variable A variable of type int, resolved with resolve()
+	 * @param value The value to store
+	 */
+	void set(VariableHandle variable, int value);
+
 	bool isPresent(const std::string& column) const;
+	/**
+	 * @brief Tell whether a variable resolved beforehand has a value
+	 *
+	 * @param variable A variable resolved with resolve()
+	 */
+	bool isPresent(VariableHandle variable) const;
 
 	void filterOutImpossibleValues();
 
+	/**
+	 * @brief Find a variable from one of its names
+	 *
+	 * Resolving a name is a binary search in a static table, connectors
+	 * are expected to resolve their column names once and then use the
+	 * handles for each observation.
+	 *
+	 * @param column The name of the variable
+	 *
+	 * @return The variable, or nullptr if \a column is not the name of
+	 * a float or integer variable
+	 */
+	static VariableHandle resolve(std::string_view column);
+
 	static bool isValidIntVariable(const std::string& var);
 	static bool isValidFloatVariable(const std::string& var);
 
 private:
-	static constexpr std::array<char const *, 28> VALID_VAR_INTS = {
-		"extrahum1", "extra_humidity1",
-		"extrahum2", "extra_humidity2",
-		"insidehum", "inside_humidity",
-		"leafwetnesses1", "leaf_wetness1",
-		"leafwetnesses2", "leaf_wetness2",
-		"soilmoistures1", "soil_moisture1",
-		"soilmoistures2", "soil_moisture2",
-		"soilmoistures3", "soil_moisture3",
-		"soilmoistures4", "soil_moisture4",
-		"outsidehum", "outside_humidity",
-		"uv", "uv_index",
-		"winddir", "wind_direction",
-		"solarrad", "solar_radiation",
-		"insolation_time",
-		"leafwetness_timeratio1"
-	};
-
-	static constexpr std::array<char const *, 84> VALID_VAR_FLOATS = {
-		"barometer", "pressure",
-		"dewpoint", "dew_point",
-		"extratemp1", "extra_temperature1",
-		"extratemp2", "extra_temperature2",
-		"extratemp3", "extra_temperature3",
-		"heatindex",
-		"insidetemp", "inside_temperature",
-		"leaftemp1", "leaf_temperature1",
-		"leaftemp2", "leaf_temperature2",
-		"outsidetemp", "outside_temperature",
-		"rainrate", "rain_rate",
-		"rainfall",
-		"et", "etp", "evapotranspiration",
-		"soiltemp1", "soil_temp1", "soil_temperature1",
-		"soiltemp2", "soil_temp2", "soil_temperature2",
-		"soiltemp3", "soil_temp3", "soil_temperature3",
-		"soiltemp4", "soil_temp4", "soil_temperature4",
-		"thswindex", "thsw_index",
-		"windchill",
-		"windgust", "windgust_speed",
-		"min_windspeed", "min_wind_speed", "windspeed", "wind_speed",
-		"min_outside_temperature",
-		"max_outside_temperature",
-		"soilmoistures10cm", "soil_moisture_10cm",
-		"soilmoistures20cm", "soil_moisture_20cm",
-		"soilmoistures30cm", "soil_moisture_30cm",
-		"soilmoistures40cm", "soil_moisture_40cm",
-		"soilmoistures50cm", "soil_moisture_50cm",
-		"soilmoistures60cm", "soil_moisture_60cm",
-		"soiltemp10cm", "soil_temp_10cm", "soil_temperature_10cm",
-		"soiltemp20cm", "soil_temp_20cm", "soil_temperature_20cm",
-		"soiltemp30cm", "soil_temp_30cm", "soil_temperature_30cm",
-		"soiltemp40cm", "soil_temp_40cm", "soil_temperature_40cm",
-		"soiltemp50cm", "soil_temp_50cm", "soil_temperature_50cm",
-		"soiltemp60cm", "soil_temp_60cm", "soil_temperature_60cm",
-		"leafwetness_percent1", "leaf_wetness_percent1",
-		"soil_conductivity1",
-		"voltage_battery", "voltage_solar_panel", "voltage_backup"
-	};
+	template<typename T>
+	void store(VariableHandle variable, T value);
+	template<typename T>
+	T load(VariableHandle variable) const;
 };
 
 template<>
@@ -179,6 +209,12 @@ date::sys_days Observation::get<date::sys_days>(const std::string& column) const
 template<>
 date::sys_seconds Observation::get<date::sys_seconds>(const std::string& column) const;
 
+template<>
+int Observation::get<int>(Observation::VariableHandle variable) const;
+
+template<>
+float Observation::get<float>(Observation::VariableHandle variable) const;
+
 }
 
 #endif
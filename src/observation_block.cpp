@@ -0,0 +1,175 @@
+/**
+ * @file observation_block.cpp
+ * @brief Implementation of the ObservationBlock class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "observation_block.h"
+#include "packed_observation.h"
+#include "filter.h"
+
+namespace meteodata {
+
+namespace {
+	/**
+	 * @brief The number of observations checked per iteration of the
+	 * filter loops
+	 *
+	 * GCC does not vectorize at -O2 the loops that need a scalar epilogue,
+	 * processing the observations in chunks of constant size works around
+	 * that.
+	 */
+	constexpr std::size_t LANES = 8;
+
+	/**
+	 * @brief Call a function on all indices from 0 to n, in chunks of
+	 * LANES indices
+	 *
+	 * @param n The number of indices
+	 * @param f The function to call, it must not branch for the chunks to
+	 * be vectorized
+	 */
+	template<typename Function>
+	inline void forEachIndex(std::size_t n, Function&& f)
+	{
+		std::size_t i = 0;
+		for ( ; i + LANES <= n ; i += LANES) {
+			for (std::size_t j = 0 ; j < LANES ; j++)
+				f(i + j);
+		}
+		for ( ; i < n ; i++)
+			f(i);
+	}
+}
+
+void ObservationBlock::reserve(std::size_t n)
+{
+	_stations.reserve(n);
+	_days.reserve(n);
+	_times.reserve(n);
+	_presence.reserve(n);
+	for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+		if (PackedObservation::isIntField(Field(f)))
+			_ints[f].reserve(n);
+		else
+			_floats[f].reserve(n);
+	}
+}
+
+void ObservationBlock::push_back(const PackedObservation& obs)
+{
+	_stations.push_back(obs.station);
+	_days.push_back(obs.day);
+	_times.push_back(obs.time);
+	_presence.push_back(obs.presence());
+	for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+		Field field = Field(f);
+		// Absent values are stored as 0 so that the columns have no
+		// uninitialized holes
+		if (PackedObservation::isIntField(field))
+			_ints[f].push_back(obs.isPresent(field) ? obs.getInt(field) : 0);
+		else
+			_floats[f].push_back(obs.isPresent(field) ? obs.getFloat(field) : 0.f);
+	}
+}
+
+PackedObservation ObservationBlock::get(std::size_t i) const
+{
+	PackedObservation obs;
+	obs.station = _stations[i];
+	obs.day = _days[i];
+	obs.time = _times[i];
+	for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+		Field field = Field(f);
+		if (!(_presence[i] & (std::uint64_t{1} << f)))
+			continue;
+		if (PackedObservation::isIntField(field))
+			obs.set(field, _ints[f][i]);
+		else
+			obs.set(field, _floats[f][i]);
+	}
+	return obs;
+}
+
+void ObservationBlock::clear()
+{
+	_stations.clear();
+	_days.clear();
+	_times.clear();
+	_presence.clear();
+	for (auto& column : _floats)
+		column.clear();
+	for (auto& column : _ints)
+		column.clear();
+}
+
+template<typename T>
+void ObservationBlock::filterColumn(Field field, const std::vector<T>& column, float min, float max)
+{
+	const T* values = column.data();
+	std::uint64_t* presence = _presence.data();
+	forEachIndex(column.size(), [&](std::size_t i) {
+		float value = values[i];
+		std::uint64_t invalid = !((value >= min) & (value <= max));
+		presence[i] &= ~(invalid << field);
+	});
+}
+
+void ObservationBlock::filterOutImpossibleValues()
+{
+	const std::size_t n = size();
+	std::uint64_t* presence = _presence.data();
+
+	// The wind gust is checked against the presence of the wind speed
+	// before filtering so it must be done first
+	const float* windgust = _floats[PackedObservation::WINDGUST].data();
+	forEachIndex(n, [&](std::size_t i) {
+		float value = windgust[i];
+		std::uint64_t hasWindspeed = (presence[i] >> PackedObservation::WINDSPEED) & 1;
+		std::uint64_t invalid = !((value >= Filter::MIN_WINDGUST_SPEED) & (value <= Filter::MAX_WINDGUST_SPEED) &
+			(hasWindspeed | (value > 0)));
+		presence[i] &= ~(invalid << PackedObservation::WINDGUST);
+	});
+
+	// special case for humidity, see Observation::filterOutImpossibleValues()
+	int* outsidehum = _ints[PackedObservation::OUTSIDEHUM].data();
+	forEachIndex(n, [&](std::size_t i) {
+		int value = outsidehum[i];
+		outsidehum[i] = (value > Filter::MAX_HUMIDITY) & (value <= Filter::MAX_HUMIDITY * 6 / 5) ? Filter::MAX_HUMIDITY : value;
+	});
+
+	for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+		Field field = Field(f);
+		float min, max;
+		if (field == PackedObservation::WINDGUST || !PackedObservation::bounds(field, min, max))
+			continue;
+
+		if (PackedObservation::isIntField(field))
+			filterColumn(field, _ints[f], min, max);
+		else
+			filterColumn(field, _floats[f], min, max);
+	}
+}
+
+}
@@ -0,0 +1,121 @@
+/**
+ * @file observation_block.h
+ * @brief Definition of the ObservationBlock class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBSERVATION_BLOCK_H
+#define OBSERVATION_BLOCK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "observation.h"
+#include "packed_observation.h"
+
+namespace meteodata {
+
+/**
+ * @brief A batch of observations stored column by column
+ *
+ * Each variable is stored in its own contiguous array and the presence flags
+ * of each observation are packed in a bitmask, like in PackedObservation.
+ * This is the layout of choice to validate large archives: each variable is
+ * checked for the whole block in a single loop with no branch, which the
+ * compiler turns into vectorized comparisons.
+ */
+class ObservationBlock
+{
+public:
+	using Field = PackedObservation::Field;
+
+	/**
+	 * @brief Reserve memory for a number of observations
+	 *
+	 * @param n The expected size of the block
+	 */
+	void reserve(std::size_t n);
+
+	/**
+	 * @brief Append an observation at the end of the block
+	 *
+	 * @param obs The observation
+	 */
+	void push_back(const PackedObservation& obs);
+	/**
+	 * @brief Append an observation at the end of the block
+	 *
+	 * @param obs The observation
+	 */
+	void push_back(const Observation& obs)
+	{
+		push_back(PackedObservation{obs});
+	}
+
+	/**
+	 * @brief Get an observation of the block
+	 *
+	 * @param i The index of the observation, less than size()
+	 *
+	 * @return The i-th observation
+	 */
+	PackedObservation get(std::size_t i) const;
+
+	std::size_t size() const
+	{
+		return _presence.size();
+	}
+
+	void clear();
+
+	/**
+	 * @brief Same as Observation::filterOutImpossibleValues(), for all the
+	 * observations of the block at once
+	 */
+	void filterOutImpossibleValues();
+
+private:
+	std::vector<CassUuid> _stations;
+	std::vector<date::sys_days> _days;
+	std::vector<date::sys_seconds> _times;
+	std::vector<std::uint64_t> _presence;
+	/**
+	 * @brief The columns of the float variables, empty for the int
+	 * variables
+	 */
+	std::array<std::vector<float>, PackedObservation::NB_FIELDS> _floats;
+	/**
+	 * @brief The columns of the int variables, empty for the float
+	 * variables
+	 */
+	std::array<std::vector<int>, PackedObservation::NB_FIELDS> _ints;
+
+	template<typename T>
+	void filterColumn(Field field, const std::vector<T>& column, float min, float max);
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file observation_storage.h
+ * @brief Definition of the ObservationStorage interface
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBSERVATION_STORAGE_H
+#define OBSERVATION_STORAGE_H
+
+#include <ctime>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "observation.h"
+
+namespace meteodata {
+
+/**
+ * @brief The storage of the observations of the stations, as seen by the
+ * programs computing and serving the data
+ *
+ * DbConnectionObservations implements it on top of Cassandra, the
+ * InMemoryObservationStorage implements it without any database, for the
+ * benchmarks and the tests.
+ */
+class ObservationStorage
+{
+public:
+	virtual ~ObservationStorage() = default;
+
+	/**
+	 * @brief Insert a new data point
+	 *
+	 * @param obs The observation to insert
+	 *
+	 * @return True if the data point could be inserted, false otherwise
+	 */
+	virtual bool insertV2DataPoint(const Observation& obs) = 0;
+
+	/**
+	 * @brief Fetch the latest data point of the day of \a boundary, not
+	 * after \a boundary
+	 *
+	 * @param station The station of interest
+	 * @param boundary The timestamp the data to be fetched must be
+	 * immediately anterior to
+	 * @param[out] obs The data point found
+	 *
+	 * @return True if a data point was found, false otherwise
+	 */
+	virtual bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& obs) = 0;
+
+	/**
+	 * @brief Get the total rainfall in the time range (\a begin, \a end]
+	 *
+	 * @param[in] station The station UUID
+	 * @param[in] begin The start of the time range
+	 * @param[in] end The end of the time range
+	 * @param[out] rainfall The rainfall at the station during the time range
+	 *
+	 * @return True if everything went well, false if an error occurred
+	 */
+	virtual bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall) = 0;
+
+	/**
+	 * @brief Remove all data points in the time range (\a start, \a end]
+	 * of a given day
+	 *
+	 * @param[in] station The station identifier
+	 * @param[in] day The day the time range falls into
+	 * @param[in] start The beginning of the time range
+	 * @param[in] end The end of the time range
+	 *
+	 * @return True if everything went well, false otherwise
+	 */
+	virtual bool deleteDataPoints(const CassUuid& station, const date::sys_days& day, const date::sys_seconds& start, const date::sys_seconds& end) = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * @file packed_observation.cpp
+ * @brief Implementation of the PackedObservation class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "packed_observation.h"
+#include "observation.h"
+#include "filter.h"
+
+namespace meteodata {
+
+namespace {
+	constexpr float NO_BOUND = std::numeric_limits<float>::infinity();
+
+	/**
+	 * @brief How to reach a variable in an Observation and the bounds it is
+	 * checked against
+	 */
+	struct FieldDescriptor
+	{
+		std::pair<bool,float>* (*floatField)(Observation&) = nullptr;
+		std::pair<bool,int  >* (*intField)(Observation&) = nullptr;
+		bool filtered = false;
+		float min = 0.f;
+		float max = 0.f;
+
+		constexpr FieldDescriptor(std::pair<bool,float>* (*field)(Observation&)) :
+			floatField{field}
+		{}
+		constexpr FieldDescriptor(std::pair<bool,float>* (*field)(Observation&), float mi, float ma) :
+			floatField{field}, filtered{true}, min{mi}, max{ma}
+		{}
+		constexpr FieldDescriptor(std::pair<bool,int  >* (*field)(Observation&)) :
+			intField{field}
+		{}
+		constexpr FieldDescriptor(std::pair<bool,int  >* (*field)(Observation&), float mi, float ma) :
+			intField{field}, filtered{true}, min{mi}, max{ma}
+		{}
+	};
+
+	/**
+	 * @brief The variables, indexed by PackedObservation::Field
+	 *
+	 * The bounds are exactly those of
+	 * Observation::filterOutImpossibleValues(), both methods must keep
+	 * giving the same results.
+	 */
+	constexpr FieldDescriptor FIELDS[] = {
+		{ [](Observation& o) { return &o.barometer; }, Filter::MIN_BAROMETER, Filter::MAX_BAROMETER },
+		{ [](Observation& o) { return &o.dewpoint; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.extrahum[0]; }, Filter::MIN_HUMIDITY, Filter::MAX_HUMIDITY },
+		{ [](Observation& o) { return &o.extrahum[1]; }, Filter::MIN_HUMIDITY, Filter::MAX_HUMIDITY },
+		{ [](Observation& o) { return &o.extratemp[0]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.extratemp[1]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.extratemp[2]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.heatindex; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.insidehum; } },
+		{ [](Observation& o) { return &o.insidetemp; } },
+		{ [](Observation& o) { return &o.leaftemp[0]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.leaftemp[1]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.leafwetnesses[0]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.leafwetnesses[1]; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.outsidehum; }, Filter::MIN_HUMIDITY, Filter::MAX_HUMIDITY },
+		{ [](Observation& o) { return &o.outsidetemp; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.rainrate; }, Filter::MIN_RAINRATE, Filter::MAX_RAINRATE },
+		{ [](Observation& o) { return &o.rainfall; }, Filter::MIN_RAINFALL, Filter::MAX_RAINFALL },
+		{ [](Observation& o) { return &o.et; }, Filter::MIN_ET, Filter::MAX_ET },
+		{ [](Observation& o) { return &o.soilmoistures[0]; }, Filter::MIN_SOILMOISTURE, Filter::MAX_SOILMOISTURE },
+		{ [](Observation& o) { return &o.soilmoistures[1]; }, Filter::MIN_SOILMOISTURE, Filter::MAX_SOILMOISTURE },
+		{ [](Observation& o) { return &o.soilmoistures[2]; }, Filter::MIN_SOILMOISTURE, Filter::MAX_SOILMOISTURE },
+		{ [](Observation& o) { return &o.soilmoistures[3]; }, Filter::MIN_SOILMOISTURE, Filter::MAX_SOILMOISTURE },
+		{ [](Observation& o) { return &o.soiltemp[0]; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp[1]; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp[2]; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp[3]; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.solarrad; }, Filter::MIN_SOLARRAD, Filter::MAX_SOLARRAD },
+		{ [](Observation& o) { return &o.thswindex; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.uv; }, Filter::MIN_UV, Filter::MAX_UV },
+		{ [](Observation& o) { return &o.windchill; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.winddir; }, Filter::MIN_WINDDIR, Filter::MAX_WINDDIR },
+		{ [](Observation& o) { return &o.windgust; }, Filter::MIN_WINDGUST_SPEED, Filter::MAX_WINDGUST_SPEED },
+		{ [](Observation& o) { return &o.min_windspeed; }, Filter::MIN_WIND_SPEED, Filter::MAX_WIND_SPEED },
+		{ [](Observation& o) { return &o.windspeed; }, Filter::MIN_WIND_SPEED, Filter::MAX_WIND_SPEED },
+		{ [](Observation& o) { return &o.insolation_time; } },
+		{ [](Observation& o) { return &o.min_outside_temperature; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.max_outside_temperature; }, Filter::MIN_AIR_TEMPERATURE, Filter::MAX_AIR_TEMPERATURE },
+		{ [](Observation& o) { return &o.leafwetness_timeratio1; } },
+		{ [](Observation& o) { return &o.soilmoistures10cm; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soilmoistures20cm; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soilmoistures30cm; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soilmoistures40cm; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soilmoistures50cm; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soilmoistures60cm; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soiltemp10cm; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp20cm; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp30cm; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp40cm; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp50cm; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.soiltemp60cm; }, Filter::MIN_SOIL_TEMPERATURE, Filter::MAX_SOIL_TEMPERATURE },
+		{ [](Observation& o) { return &o.leafwetness_percent1; }, Filter::MIN_PERCENTAGE, Filter::MAX_PERCENTAGE },
+		{ [](Observation& o) { return &o.soil_conductivity1; }, Filter::MIN_CONDUCTIVITY, NO_BOUND },
+		// Observation::filterOutImpossibleValues() only keeps the voltages
+		// above MAX_VOLTAGE
+		{ [](Observation& o) { return &o.voltage_battery; }, Filter::MAX_VOLTAGE, NO_BOUND },
+		{ [](Observation& o) { return &o.voltage_solar_panel; }, Filter::MAX_VOLTAGE, NO_BOUND },
+		{ [](Observation& o) { return &o.voltage_backup; }, Filter::MAX_VOLTAGE, NO_BOUND },
+	};
+
+	static_assert(std::size(FIELDS) == PackedObservation::NB_FIELDS, "All the fields must be described");
+}
+
+PackedObservation::PackedObservation(const Observation& obs) :
+	station{obs.station},
+	day{obs.day},
+	time{obs.time}
+{
+	// The accessors are shared with unpack(), the observation is only read
+	// here
+	Observation& source = const_cast<Observation&>(obs);
+	for (std::size_t f = 0 ; f < NB_FIELDS ; f++) {
+		const FieldDescriptor& descriptor = FIELDS[f];
+		if (descriptor.floatField) {
+			const auto* field = descriptor.floatField(source);
+			if (field->first) {
+				_values[f].f = field->second;
+				_present |= bit(Field(f));
+			}
+		} else {
+			const auto* field = descriptor.intField(source);
+			if (field->first) {
+				_values[f].i = field->second;
+				_present |= bit(Field(f));
+			}
+		}
+	}
+}
+
+Observation PackedObservation::unpack() const
+{
+	Observation obs;
+	unpack(obs);
+	return obs;
+}
+
+void PackedObservation::unpack(Observation& obs) const
+{
+	obs.station = station;
+	obs.day = day;
+	obs.time = time;
+	for (std::size_t f = 0 ; f < NB_FIELDS ; f++) {
+		const FieldDescriptor& descriptor = FIELDS[f];
+		bool present = isPresent(Field(f));
+		if (descriptor.floatField)
+			*descriptor.floatField(obs) = { present, present ? _values[f].f : 0.f };
+		else
+			*descriptor.intField(obs) = { present, present ? _values[f].i : 0 };
+	}
+}
+
+bool PackedObservation::isIntField(Field field)
+{
+	return FIELDS[field].intField != nullptr;
+}
+
+bool PackedObservation::bounds(Field field, float& min, float& max)
+{
+	const FieldDescriptor& descriptor = FIELDS[field];
+	if (!descriptor.filtered)
+		return false;
+	min = descriptor.min;
+	max = descriptor.max;
+	return true;
+}
+
+float PackedObservation::getFloat(Field field) const
+{
+	return isIntField(field) ? float(_values[field].i) : _values[field].f;
+}
+
+int PackedObservation::getInt(Field field) const
+{
+	return isIntField(field) ? _values[field].i : int(_values[field].f);
+}
+
+void PackedObservation::set(Field field, float value)
+{
+	if (isIntField(field))
+		_values[field].i = value;
+	else
+		_values[field].f = value;
+	_present |= bit(field);
+}
+
+void PackedObservation::set(Field field, int value)
+{
+	if (isIntField(field))
+		_values[field].i = value;
+	else
+		_values[field].f = value;
+	_present |= bit(field);
+}
+
+void PackedObservation::filterOutImpossibleValues()
+{
+	// The wind gust is checked against the presence of the wind speed
+	// before filtering
+	const bool hasWindspeed = isPresent(WINDSPEED);
+
+	// special case for humidity, see Observation::filterOutImpossibleValues()
+	if (isPresent(OUTSIDEHUM) && _values[OUTSIDEHUM].i > Filter::MAX_HUMIDITY && _values[OUTSIDEHUM].i <= Filter::MAX_HUMIDITY * 1.2)
+		_values[OUTSIDEHUM].i = Filter::MAX_HUMIDITY;
+
+	forEachPresent([&](Field f) {
+		const FieldDescriptor& descriptor = FIELDS[f];
+		if (!descriptor.filtered)
+			return;
+
+		float value = descriptor.intField ? float(_values[f].i) : _values[f].f;
+		bool valid = value >= descriptor.min && value <= descriptor.max;
+		if (f == WINDGUST)
+			valid = valid && (hasWindspeed || value > 0);
+		if (!valid)
+			unset(f);
+	});
+}
+
+}
@@ -0,0 +1,246 @@
+/**
+ * @file packed_observation.h
+ * @brief Definition of the PackedObservation class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKED_OBSERVATION_H
+#define PACKED_OBSERVATION_H
+
+#include <array>
+#include <cstdint>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "observation.h"
+
+namespace meteodata {
+
+/**
+ * @brief A compact representation of an Observation
+ *
+ * The presence flags of all the variables are packed into a single bitmask and
+ * the values are stored in a dense array of 4-byte slots, holding either a
+ * float or an int depending on the variable. This is about half the size of
+ * an Observation, which stores a padded std::pair<bool, T> per variable, and
+ * makes it possible to iterate over the present variables only.
+ */
+class PackedObservation
+{
+public:
+	/**
+	 * @brief The variables of an observation, in the order of the members
+	 * of Observation
+	 */
+	enum Field : std::uint8_t
+	{
+		BAROMETER,
+		DEWPOINT,
+		EXTRAHUM1,
+		EXTRAHUM2,
+		EXTRATEMP1,
+		EXTRATEMP2,
+		EXTRATEMP3,
+		HEATINDEX,
+		INSIDEHUM,
+		INSIDETEMP,
+		LEAFTEMP1,
+		LEAFTEMP2,
+		LEAFWETNESSES1,
+		LEAFWETNESSES2,
+		OUTSIDEHUM,
+		OUTSIDETEMP,
+		RAINRATE,
+		RAINFALL,
+		ET,
+		SOILMOISTURES1,
+		SOILMOISTURES2,
+		SOILMOISTURES3,
+		SOILMOISTURES4,
+		SOILTEMP1,
+		SOILTEMP2,
+		SOILTEMP3,
+		SOILTEMP4,
+		SOLARRAD,
+		THSWINDEX,
+		UV,
+		WINDCHILL,
+		WINDDIR,
+		WINDGUST,
+		MIN_WINDSPEED,
+		WINDSPEED,
+		INSOLATION_TIME,
+		MIN_OUTSIDE_TEMPERATURE,
+		MAX_OUTSIDE_TEMPERATURE,
+		LEAFWETNESS_TIMERATIO1,
+		SOILMOISTURES10CM,
+		SOILMOISTURES20CM,
+		SOILMOISTURES30CM,
+		SOILMOISTURES40CM,
+		SOILMOISTURES50CM,
+		SOILMOISTURES60CM,
+		SOILTEMP10CM,
+		SOILTEMP20CM,
+		SOILTEMP30CM,
+		SOILTEMP40CM,
+		SOILTEMP50CM,
+		SOILTEMP60CM,
+		LEAFWETNESS_PERCENT1,
+		SOIL_CONDUCTIVITY1,
+		VOLTAGE_BATTERY,
+		VOLTAGE_SOLAR_PANEL,
+		VOLTAGE_BACKUP,
+		NB_FIELDS
+	};
+
+	CassUuid station;
+	date::sys_days day;
+	date::sys_seconds time;
+
+	PackedObservation() = default;
+	/**
+	 * @brief Pack an observation
+	 *
+	 * @param obs The observation
+	 */
+	explicit PackedObservation(const Observation& obs);
+
+	/**
+	 * @brief Convert back to an Observation
+	 *
+	 * @return An observation with the same variables as this one
+	 */
+	Observation unpack() const;
+	/**
+	 * @brief Convert back to an Observation, overwriting all its
+	 * variables
+	 *
+	 * @param[out] obs The observation to fill in
+	 */
+	void unpack(Observation& obs) const;
+
+	/**
+	 * @brief Tell whether a variable holds an integer or a float
+	 *
+	 * @param field The variable
+	 *
+	 * @return True if \a field is stored as an int, false if it is stored
+	 * as a float
+	 */
+	static bool isIntField(Field field);
+
+	/**
+	 * @brief Get the bounds a variable is checked against by
+	 * filterOutImpossibleValues()
+	 *
+	 * @param field The variable
+	 * @param[out] min The lowest acceptable value
+	 * @param[out] max The highest acceptable value
+	 *
+	 * @return False if the variable is not filtered at all, in which case
+	 * \a min and \a max are left untouched
+	 */
+	static bool bounds(Field field, float& min, float& max);
+
+	bool isPresent(Field field) const
+	{
+		return _present & bit(field);
+	}
+
+	/**
+	 * @brief Get the presence bitmask, bit i is set if, and only if,
+	 * variable i has a value
+	 */
+	std::uint64_t presence() const
+	{
+		return _present;
+	}
+
+	/**
+	 * @brief Get the value of a variable as a float, converting it if it's
+	 * stored as an int
+	 */
+	float getFloat(Field field) const;
+	/**
+	 * @brief Get the value of a variable as an int, converting it if it's
+	 * stored as a float
+	 */
+	int getInt(Field field) const;
+
+	/**
+	 * @brief Set the value of a variable, converting it to the type of the
+	 * variable if necessary
+	 */
+	void set(Field field, float value);
+	/**
+	 * @brief Set the value of a variable, converting it to the type of the
+	 * variable if necessary
+	 */
+	void set(Field field, int value);
+
+	/**
+	 * @brief Mark a variable as absent
+	 */
+	void unset(Field field)
+	{
+		_present &= ~bit(field);
+	}
+
+	/**
+	 * @brief Call a function on each present variable, in the order of the
+	 * fields, skipping the absent ones without looking at them
+	 *
+	 * @param f A function taking a Field
+	 */
+	template<typename Function>
+	void forEachPresent(Function&& f) const
+	{
+		for (std::uint64_t remaining = _present ; remaining ; remaining &= remaining - 1)
+			f(static_cast<Field>(__builtin_ctzll(remaining)));
+	}
+
+	/**
+	 * @brief Same as Observation::filterOutImpossibleValues(), only
+	 * looking at the present variables
+	 */
+	void filterOutImpossibleValues();
+
+private:
+	union Value
+	{
+		float f;
+		int i;
+	};
+
+	std::uint64_t _present = 0;
+	std::array<Value, NB_FIELDS> _values;
+
+	static constexpr std::uint64_t bit(Field field)
+	{
+		return std::uint64_t{1} << field;
+	}
+
+	static_assert(NB_FIELDS <= 64, "The presence flags must fit in the bitmask");
+};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file pq_connection_pool.cpp
+ * @brief Implementation of the PqConnectionPool class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <pqxx/pqxx>
+
+#include "pq_connection_pool.h"
+#include "statement_metrics.h"
+
+namespace meteodata {
+
+PqConnectionPool::Connection::Connection(PqConnectionPool& pool, pqxx::connection* connection) :
+	_pool{&pool},
+	_connection{connection}
+{}
+
+PqConnectionPool::Connection::Connection(Connection&& other) noexcept :
+	_pool{other._pool},
+	_connection{other._connection}
+{
+	other._connection = nullptr;
+}
+
+PqConnectionPool::Connection::~Connection()
+{
+	if (_connection)
+		_pool->giveBack(_connection);
+}
+
+PqConnectionPool::PqConnectionPool(std::string connectionString, std::size_t maxSize) :
+	_connectionString{std::move(connectionString)},
+	_maxSize{std::max<std::size_t>(maxSize, 1)}
+{
+	// Open the first connection right away so that configuration errors
+	// are reported at construction time
+	_connections.push_back(std::make_unique<pqxx::connection>(_connectionString));
+	_available.push_back(_connections.back().get());
+}
+
+void PqConnectionPool::prepare(const std::string& name, const std::string& definition)
+{
+	std::lock_guard locked{_mutex};
+	_preparedStatements.emplace_back(name, definition);
+	_metrics.emplace(name, &StatementMetrics::series(StatementMetrics::Backend::POSTGRESQL, name));
+	for (const auto& connection : _connections)
+		connection->prepare(name, definition);
+}
+
+StatementMetrics::Series& PqConnectionPool::metrics(std::string_view name) const
+{
+	// The statements are all prepared before the connections are used,
+	// the map does not change anymore
+	auto it = _metrics.find(name);
+	if (it != _metrics.end())
+		return *it->second;
+	return StatementMetrics::series(StatementMetrics::Backend::POSTGRESQL, std::string{name});
+}
+
+PqConnectionPool::Connection PqConnectionPool::checkout()
+{
+	std::unique_lock locked{_mutex};
+	for (;;) {
+		if (!_available.empty()) {
+			pqxx::connection* connection = _available.back();
+			_available.pop_back();
+			return Connection{*this, connection};
+		}
+
+		if (_connections.size() + _opening < _maxSize) {
+			// The connection is opened without holding the lock
+			_opening++;
+			auto statements = _preparedStatements;
+			locked.unlock();
+
+			std::unique_ptr<pqxx::connection> connection;
+			try {
+				connection = std::make_unique<pqxx::connection>(_connectionString);
+				for (const auto& [name, definition] : statements)
+					connection->prepare(name, definition);
+			} catch (...) {
+				locked.lock();
+				_opening--;
+				// Let another thread try again
+				_connectionReturned.notify_one();
+				throw;
+			}
+
+			locked.lock();
+			_opening--;
+			_connections.push_back(std::move(connection));
+			return Connection{*this, _connections.back().get()};
+		}
+
+		_connectionReturned.wait(locked);
+	}
+}
+
+void PqConnectionPool::giveBack(pqxx::connection* connection)
+{
+	{
+		std::lock_guard locked{_mutex};
+		_available.push_back(connection);
+	}
+	_connectionReturned.notify_one();
+}
+
+}
@@ -0,0 +1,144 @@
+/**
+ * @file pq_connection_pool.h
+ * @brief Definition of the PqConnectionPool class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PQ_CONNECTION_POOL_H
+#define PQ_CONNECTION_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <pqxx/pqxx>
+
+#include "statement_metrics.h"
+
+namespace meteodata {
+
+/**
+ * @brief A pool of connections to the PostgreSQL database, all with the same
+ * prepared statements
+ *
+ * Each connection can only be used by one thread at a time. A thread checks a
+ * connection out of the pool, runs its transaction, and the connection goes
+ * back to the pool when the handle is destroyed. Connections are opened
+ * lazily, up to the maximum size of the pool, when all the opened ones are in
+ * use.
+ */
+class PqConnectionPool
+{
+public:
+	/**
+	 * @brief A connection checked out of the pool, returned to the pool
+	 * on destruction
+	 */
+	class Connection
+	{
+	public:
+		Connection(Connection&& other) noexcept;
+		Connection(const Connection&) = delete;
+		Connection& operator=(const Connection&) = delete;
+		Connection& operator=(Connection&&) = delete;
+		~Connection();
+
+		pqxx::connection& operator*() const { return *_connection; }
+		pqxx::connection* operator->() const { return _connection; }
+
+	private:
+		Connection(PqConnectionPool& pool, pqxx::connection* connection);
+
+		PqConnectionPool* _pool;
+		pqxx::connection* _connection;
+
+		friend class PqConnectionPool;
+	};
+
+	/**
+	 * @brief Construct the pool and open its first connection
+	 *
+	 * @param connectionString The libpq connection string
+	 * @param maxSize The maximum number of connections opened at the same
+	 * time, at least one
+	 */
+	explicit PqConnectionPool(std::string connectionString, std::size_t maxSize = 1);
+
+	/**
+	 * @brief Prepare a statement on all the connections of the pool,
+	 * including those not opened yet
+	 *
+	 * This must be called before any connection is checked out.
+	 *
+	 * @param name The name of the prepared statement
+	 * @param definition The SQL query
+	 */
+	void prepare(const std::string& name, const std::string& definition);
+
+	/**
+	 * @brief Get the metrics series of a prepared statement
+	 *
+	 * The series are resolved once, when the statements are prepared, so
+	 * this takes no lock, contrary to StatementMetrics::series().
+	 *
+	 * @param name The name of the prepared statement
+	 *
+	 * @return The series of the statement
+	 */
+	StatementMetrics::Series& metrics(std::string_view name) const;
+
+	/**
+	 * @brief Get a connection from the pool, waiting for one to be
+	 * returned if they are all in use
+	 *
+	 * @return A handle on the connection, the connection is returned to the
+	 * pool when the handle is destroyed
+	 */
+	Connection checkout();
+
+	/**
+	 * @brief Get the maximum number of connections of the pool
+	 */
+	std::size_t maxSize() const { return _maxSize; }
+
+private:
+	std::string _connectionString;
+	std::size_t _maxSize;
+	std::vector<std::unique_ptr<pqxx::connection>> _connections;
+	std::size_t _opening = 0;
+	std::vector<pqxx::connection*> _available;
+	std::vector<std::pair<std::string, std::string>> _preparedStatements;
+	std::map<std::string, StatementMetrics::Series*, std::less<>> _metrics;
+	std::mutex _mutex;
+	std::condition_variable _connectionReturned;
+
+	void giveBack(pqxx::connection* connection);
+};
+
+}
+
+#endif
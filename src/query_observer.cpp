@@ -0,0 +1,72 @@
+/**
+ * @file query_observer.cpp
+ * @brief Implementation of the QueryObserver and QueryTrace classes
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <cassandra.h>
+
+#include "query_observer.h"
+#include "statement_metrics.h"
+
+namespace meteodata {
+
+namespace chrono = std::chrono;
+
+std::atomic<QueryObserver*> QueryObserver::_installed{nullptr};
+
+void QueryObserver::install(QueryObserver* observer)
+{
+	_installed.store(observer, std::memory_order_release);
+}
+
+QueryTrace::QueryTrace(StatementMetrics::Backend backend, const std::string& statement, const CassUuid* station) :
+	QueryTrace{StatementMetrics::series(backend, statement), station}
+{}
+
+QueryTrace::QueryTrace(StatementMetrics::Series& series, const CassUuid* station) :
+	_timer{series},
+	_observer{QueryObserver::installed()},
+	_query{series.backend(), series.name(), {station != nullptr, station ? *station : CassUuid{}}}
+{
+	if (_observer)
+		_observer->onQueryStart(_query);
+}
+
+QueryTrace::~QueryTrace()
+{
+	stop(false);
+}
+
+void QueryTrace::stop(bool success)
+{
+	if (!_timer.series())
+		return;
+
+	chrono::steady_clock::duration duration = _timer.stop(success);
+	if (_observer)
+		_observer->onQueryEnd(_query, {success, _rows, _bytes, duration});
+}
+
+}
@@ -0,0 +1,219 @@
+/**
+ * @file query_observer.h
+ * @brief Definition of the QueryObserver and QueryTrace classes
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERY_OBSERVER_H
+#define QUERY_OBSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <cassandra.h>
+
+#include "statement_metrics.h"
+
+namespace meteodata {
+
+/**
+ * @brief An observer of the database queries, to be implemented by the
+ * applications which want to trace them
+ *
+ * Once installed, the observer is notified at the start and at the end of each
+ * execution of a Cassandra, PostgreSQL or MySQL statement by any connection of
+ * the process. The notifications of the Cassandra statements may come from the
+ * threads of the driver, the observer must be thread-safe and fast. When no
+ * observer is installed, the only cost is an atomic load per execution.
+ */
+class QueryObserver
+{
+public:
+	/**
+	 * @brief The description of a query
+	 *
+	 * The same object is passed to onQueryStart() and onQueryEnd(), its
+	 * address can be used to match them.
+	 */
+	struct Query
+	{
+		StatementMetrics::Backend backend;
+		/**
+		 * @brief The name of the statement, as in the StatementMetrics
+		 */
+		std::string_view statement;
+		/**
+		 * @brief The station concerned by the query, if known (the
+		 * first element is false otherwise)
+		 */
+		std::pair<bool, CassUuid> station;
+	};
+
+	/**
+	 * @brief The outcome of a query
+	 */
+	struct Outcome
+	{
+		bool success;
+		/**
+		 * @brief The number of rows returned, zero for the writes and
+		 * when it is not known
+		 */
+		std::size_t rows;
+		/**
+		 * @brief The size of the values returned, zero for the writes
+		 * and when it is not known
+		 */
+		std::size_t bytes;
+		std::chrono::steady_clock::duration duration;
+	};
+
+	virtual ~QueryObserver() = default;
+
+	/**
+	 * @brief Called just before a query is sent to the database
+	 */
+	virtual void onQueryStart(const Query& query) = 0;
+
+	/**
+	 * @brief Called once the response to a query is received
+	 */
+	virtual void onQueryEnd(const Query& query, const Outcome& outcome) = 0;
+
+	/**
+	 * @brief Install the observer of the queries, replacing the
+	 * previous one
+	 *
+	 * @param observer The observer, or nullptr to remove the current one;
+	 * it must remain valid until all the queries started while it was
+	 * installed are finished
+	 */
+	static void install(QueryObserver* observer);
+
+	/**
+	 * @brief Get the current observer of the queries, nullptr if none is
+	 * installed
+	 */
+	static QueryObserver* installed()
+	{
+		return _installed.load(std::memory_order_acquire);
+	}
+
+private:
+	static std::atomic<QueryObserver*> _installed;
+};
+
+/**
+ * @brief Measure a synchronous execution of a statement, recording it in the
+ * StatementMetrics with a StatementMetrics::Timer and notifying the installed
+ * QueryObserver, if any
+ *
+ * The execution is recorded as failed if the trace is destroyed before stop()
+ * is called, by an exception for instance.
+ */
+class QueryTrace
+{
+public:
+	/**
+	 * @brief Start the trace of an execution
+	 *
+	 * @param backend The database the statement is executed on
+	 * @param statement The name of the statement
+	 * @param station The station concerned by the query, if known
+	 */
+	QueryTrace(StatementMetrics::Backend backend, const std::string& statement, const CassUuid* station = nullptr);
+
+	/**
+	 * @brief Start the trace of an execution of a statement whose series
+	 * has already been resolved
+	 *
+	 * Contrary to the other constructor, this one does not look the
+	 * series up, and takes no lock, it is the one to use for the
+	 * statements executed often.
+	 *
+	 * @param series The series of the statement
+	 * @param station The station concerned by the query, if known
+	 */
+	explicit QueryTrace(StatementMetrics::Series& series, const CassUuid* station = nullptr);
+	~QueryTrace();
+	QueryTrace(const QueryTrace&) = delete;
+	QueryTrace& operator=(const QueryTrace&) = delete;
+
+	/**
+	 * @brief Whether an observer is notified of this execution, the
+	 * rows and bytes need not be counted if not
+	 */
+	bool observed() const { return _observer; }
+
+	void addRows(std::size_t rows) { _rows += rows; }
+	void addBytes(std::size_t bytes) { _bytes += bytes; }
+
+	/**
+	 * @brief Count a row of the result, and the size of its fields,
+	 * if the execution is observed
+	 *
+	 * @tparam Row A range of fields with a size() method, a pqxx::row
+	 * for instance
+	 */
+	template<typename Row>
+	void addRow(const Row& row)
+	{
+		if (!_observer)
+			return;
+		_rows++;
+		for (const auto& field : row)
+			_bytes += field.size();
+	}
+
+	/**
+	 * @brief Count all the rows of a result, and the size of their fields,
+	 * if the execution is observed
+	 */
+	template<typename Result>
+	void addResult(const Result& result)
+	{
+		if (!_observer)
+			return;
+		for (const auto& row : result)
+			addRow(row);
+	}
+
+	/**
+	 * @brief End the trace, only the first call has an effect
+	 *
+	 * @param success Whether the execution succeeded
+	 */
+	void stop(bool success = true);
+
+private:
+	StatementMetrics::Timer _timer;
+	QueryObserver* _observer;
+	QueryObserver::Query _query;
+	std::size_t _rows = 0;
+	std::size_t _bytes = 0;
+};
+
+}
+
+#endif
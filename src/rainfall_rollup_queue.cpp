@@ -0,0 +1,169 @@
+/**
+ * @file rainfall_rollup_queue.cpp
+ * @brief Implementation of the RainfallRollupQueue class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "rainfall_rollup_queue.h"
+
+namespace meteodata {
+
+namespace chrono = std::chrono;
+
+constexpr chrono::milliseconds RainfallRollupQueue::DEFAULT_FLUSH_INTERVAL;
+
+RainfallRollupQueue::RainfallRollupQueue(Updater updater, chrono::milliseconds flushInterval) :
+	_updater{std::move(updater)},
+	_flushInterval{flushInterval}
+{}
+
+RainfallRollupQueue::~RainfallRollupQueue()
+{
+	{
+		std::lock_guard locked{_mutex};
+		_stopping = true;
+	}
+	_wakeUp.notify_all();
+	if (_flusher.joinable())
+		_flusher.join();
+	flush();
+}
+
+RainfallRollupQueue::Key RainfallRollupQueue::keyOf(const CassUuid& station)
+{
+	return { station.time_and_version, station.clock_seq_and_node };
+}
+
+void RainfallRollupQueue::push(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end)
+{
+	if (end <= begin)
+		return;
+
+	std::lock_guard locked{_mutex};
+	auto& hours = _pending[keyOf(station)];
+	_generation++;
+	// The bucket of hour H covers (H, H+1h]
+	for (date::sys_seconds hour = date::floor<chrono::hours>(begin) ; hour < end ; hour += chrono::hours(1))
+		hours[hour] = _generation;
+
+	if (!_flusher.joinable())
+		_flusher = std::thread{&RainfallRollupQueue::run, this};
+}
+
+std::vector<date::sys_seconds> RainfallRollupQueue::pendingHours(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end) const
+{
+	std::vector<date::sys_seconds> result;
+	std::lock_guard locked{_mutex};
+	auto it = _pending.find(keyOf(station));
+	if (it == _pending.end())
+		return result;
+
+	for (auto h = it->second.lower_bound(begin) ; h != it->second.end() && h->first < end ; ++h)
+		result.push_back(h->first);
+	return result;
+}
+
+bool RainfallRollupQueue::flush()
+{
+	std::lock_guard flushing{_flushMutex};
+
+	// The hours are left pending while they are recomputed so that the
+	// readers keep reading their observations
+	std::vector<std::tuple<Key, date::sys_seconds, date::sys_seconds, unsigned long>> runs;
+	{
+		std::lock_guard locked{_mutex};
+		for (const auto& [key, hours] : _pending) {
+			for (auto h = hours.begin() ; h != hours.end() ; ) {
+				date::sys_seconds begin = h->first;
+				date::sys_seconds end = begin;
+				unsigned long generation = 0;
+				for ( ; h != hours.end() && h->first == end ; ++h) {
+					end += chrono::hours(1);
+					generation = std::max(generation, h->second);
+				}
+				runs.emplace_back(key, begin, end, generation);
+			}
+		}
+	}
+
+	bool ret = true;
+	for (const auto& [key, begin, end, generation] : runs) {
+		if (!_updater(CassUuid{key.first, key.second}, begin, end)) {
+			ret = false;
+			continue;
+		}
+
+		// Only forget the hours which have not been modified again
+		// during the recomputation
+		std::lock_guard locked{_mutex};
+		auto it = _pending.find(key);
+		if (it == _pending.end())
+			continue;
+		auto& hours = it->second;
+		for (auto h = hours.lower_bound(begin) ; h != hours.end() && h->first < end ; ) {
+			if (h->second <= generation)
+				h = hours.erase(h);
+			else
+				++h;
+		}
+		if (hours.empty())
+			_pending.erase(it);
+	}
+	return ret;
+}
+
+void RainfallRollupQueue::setFlushInterval(chrono::milliseconds flushInterval)
+{
+	{
+		std::lock_guard locked{_mutex};
+		_flushInterval = flushInterval;
+	}
+	_wakeUp.notify_all();
+}
+
+void RainfallRollupQueue::run()
+{
+	std::unique_lock locked{_mutex};
+	while (!_stopping) {
+		auto deadline = chrono::steady_clock::now() + _flushInterval;
+		// Wait again if woken up by a change of interval
+		while (!_stopping && _wakeUp.wait_until(locked, deadline) == std::cv_status::no_timeout)
+			deadline = std::min(deadline, chrono::steady_clock::now() + _flushInterval);
+		if (_stopping)
+			break;
+
+		locked.unlock();
+		flush();
+		locked.lock();
+	}
+}
+
+}
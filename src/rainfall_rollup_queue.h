@@ -0,0 +1,154 @@
+/**
+ * @file rainfall_rollup_queue.h
+ * @brief Definition of the RainfallRollupQueue class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RAINFALL_ROLLUP_QUEUE_H
+#define RAINFALL_ROLLUP_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+namespace meteodata {
+
+/**
+ * @brief The hourly rainfall buckets waiting to be recomputed after their
+ * observations have changed
+ *
+ * The insertions only mark the hours they modify, a background thread
+ * periodically recomputes the buckets of the marked hours from the
+ * observations, one run of consecutive hours at a time. The recomputation
+ * is idempotent and the runs are never recomputed concurrently, so the last
+ * value written for an hour is always computed after its last
+ * modification.
+ *
+ * An hour stays pending until its bucket has been recomputed after its last
+ * modification, the readers of the buckets must read the observations of
+ * the pending hours instead, see pendingHours().
+ */
+class RainfallRollupQueue
+{
+public:
+	/**
+	 * @brief The function recomputing the buckets of the hours of a
+	 * station in [begin, end), returning true if, and only if, all of
+	 * them have been written
+	 */
+	using Updater = std::function<bool(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end)>;
+
+	/**
+	 * @brief The default interval between two recomputations
+	 */
+	constexpr static std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{5000};
+
+	/**
+	 * @brief Construct an empty queue
+	 *
+	 * @param updater The function used to recompute the buckets
+	 * @param flushInterval The interval between two recomputations
+	 */
+	explicit RainfallRollupQueue(Updater updater, std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL);
+
+	/**
+	 * @brief Recompute the pending buckets and stop the background thread
+	 */
+	~RainfallRollupQueue();
+
+	RainfallRollupQueue(const RainfallRollupQueue&) = delete;
+	RainfallRollupQueue& operator=(const RainfallRollupQueue&) = delete;
+
+	/**
+	 * @brief Mark the hours covering the observations of a station in
+	 * (begin, end] as modified
+	 *
+	 * @param station The station's UUID
+	 * @param begin The start of the period, excluded
+	 * @param end The end of the period, included
+	 */
+	void push(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end);
+
+	/**
+	 * @brief Get the pending hours of a station in [begin, end)
+	 *
+	 * @param station The station's UUID
+	 * @param begin The first hour
+	 * @param end The hour after the last one
+	 *
+	 * @return The pending hours, sorted
+	 */
+	std::vector<date::sys_seconds> pendingHours(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end) const;
+
+	/**
+	 * @brief Recompute all the pending buckets
+	 *
+	 * The buckets that could not be recomputed are kept for the next
+	 * flush.
+	 *
+	 * @return True if, and only if, all the buckets have been recomputed
+	 */
+	bool flush();
+
+	/**
+	 * @brief Change the interval between two recomputations
+	 *
+	 * @param flushInterval The new interval
+	 */
+	void setFlushInterval(std::chrono::milliseconds flushInterval);
+
+private:
+	using Key = std::pair<cass_uint64_t, cass_uint64_t>;
+
+	Updater _updater;
+	std::chrono::milliseconds _flushInterval;
+
+	/**
+	 * @brief The pending hours of each station, with the generation of
+	 * their last modification
+	 */
+	std::map<Key, std::map<date::sys_seconds, unsigned long>> _pending;
+	unsigned long _generation = 0;
+
+	/**
+	 * @brief Serialize the flushes so that two recomputations of the
+	 * same hour cannot be reordered
+	 */
+	std::mutex _flushMutex;
+	mutable std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	bool _stopping = false;
+	std::thread _flusher;
+
+	static Key keyOf(const CassUuid& station);
+	void run();
+};
+
+}
+
+#endif
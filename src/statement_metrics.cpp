@@ -0,0 +1,233 @@
+/**
+ * @file statement_metrics.cpp
+ * @brief Implementation of the StatementMetrics class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "statement_metrics.h"
+
+namespace meteodata {
+
+namespace chrono = std::chrono;
+
+constexpr unsigned int StatementMetrics::SUB_BUCKET_BITS;
+constexpr std::size_t StatementMetrics::NB_BUCKETS;
+
+namespace {
+	constexpr std::uint64_t SUB_BUCKETS = 1 << StatementMetrics::SUB_BUCKET_BITS;
+
+	const char* backendName(StatementMetrics::Backend backend)
+	{
+		switch (backend) {
+			case StatementMetrics::Backend::CASSANDRA:
+				return "cassandra";
+			case StatementMetrics::Backend::POSTGRESQL:
+				return "postgresql";
+			case StatementMetrics::Backend::MYSQL:
+				return "mysql";
+		}
+		return "unknown";
+	}
+}
+
+std::size_t StatementMetrics::bucketOf(std::uint64_t micros)
+{
+	// The first buckets have a width of one microsecond, then each power
+	// of two is split in SUB_BUCKETS buckets
+	if (micros < SUB_BUCKETS)
+		return micros;
+
+	unsigned int exponent = 0;
+	for (std::uint64_t v = micros ; v > 1 ; v >>= 1)
+		exponent++;
+	unsigned int shift = exponent - SUB_BUCKET_BITS;
+	std::size_t bucket = SUB_BUCKETS + shift * SUB_BUCKETS + ((micros >> shift) - SUB_BUCKETS);
+	return std::min(bucket, NB_BUCKETS - 1);
+}
+
+std::uint64_t StatementMetrics::upperBoundOf(std::size_t bucket)
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	unsigned int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+	std::uint64_t lower = (SUB_BUCKETS + (bucket - SUB_BUCKETS) % SUB_BUCKETS) << shift;
+	return lower + (std::uint64_t{1} << shift) - 1;
+}
+
+chrono::microseconds StatementMetrics::Snapshot::percentile(double quantile) const
+{
+	if (count == 0)
+		return chrono::microseconds{0};
+
+	// The rank of the percentile, between 1 and count
+	std::uint64_t rank = std::max<std::uint64_t>(1, std::ceil(quantile * count));
+	std::uint64_t seen = 0;
+	for (std::size_t i = 0 ; i < NB_BUCKETS ; i++) {
+		seen += buckets[i];
+		if (seen >= rank)
+			return chrono::microseconds{upperBoundOf(i)};
+	}
+	// Only reached if the snapshot is inconsistent, the buckets
+	// being read while executions are recorded
+	return chrono::microseconds{upperBoundOf(NB_BUCKETS - 1)};
+}
+
+StatementMetrics::Series::Series(Backend backend, std::string name) :
+	_backend{backend},
+	_name{std::move(name)}
+{}
+
+void StatementMetrics::Series::record(chrono::steady_clock::duration latency, bool success)
+{
+	std::uint64_t micros = std::max<std::int64_t>(0, chrono::duration_cast<chrono::microseconds>(latency).count());
+	_buckets[bucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(micros, std::memory_order_relaxed);
+	if (!success)
+		_errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+StatementMetrics::Snapshot StatementMetrics::Series::snapshot() const
+{
+	Snapshot snapshot;
+	snapshot.backend = _backend;
+	snapshot.name = _name;
+	snapshot.count = 0;
+	for (std::size_t i = 0 ; i < NB_BUCKETS ; i++) {
+		snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[i];
+	}
+	snapshot.errors = _errors.load(std::memory_order_relaxed);
+	snapshot.sum = _sum.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+void StatementMetrics::Series::reset()
+{
+	for (auto& bucket : _buckets)
+		bucket.store(0, std::memory_order_relaxed);
+	_errors.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+}
+
+StatementMetrics::Timer::Timer(Backend backend, const std::string& name) :
+	Timer{StatementMetrics::series(backend, name)}
+{}
+
+StatementMetrics::Timer::Timer(Series& series) :
+	_series{&series},
+	_start{chrono::steady_clock::now()}
+{}
+
+StatementMetrics::Timer::~Timer()
+{
+	stop(false);
+}
+
+chrono::steady_clock::duration StatementMetrics::Timer::stop(bool success)
+{
+	if (!_series)
+		return chrono::steady_clock::duration::zero();
+
+	chrono::steady_clock::duration duration = chrono::steady_clock::now() - _start;
+	_series->record(duration, success);
+	_series = nullptr;
+	return duration;
+}
+
+StatementMetrics& StatementMetrics::instance()
+{
+	static StatementMetrics metrics;
+	return metrics;
+}
+
+StatementMetrics::Series& StatementMetrics::series(Backend backend, const std::string& name)
+{
+	StatementMetrics& metrics = instance();
+	std::lock_guard locked{metrics._mutex};
+	auto& series = metrics._series[{backend, name}];
+	if (!series)
+		series = std::make_unique<Series>(backend, name);
+	return *series;
+}
+
+std::vector<StatementMetrics::Snapshot> StatementMetrics::snapshot()
+{
+	StatementMetrics& metrics = instance();
+	std::vector<Snapshot> snapshots;
+	std::lock_guard locked{metrics._mutex};
+	snapshots.reserve(metrics._series.size());
+	for (const auto& s : metrics._series)
+		snapshots.push_back(s.second->snapshot());
+	return snapshots;
+}
+
+void StatementMetrics::dump(std::ostream& out)
+{
+	std::vector<Snapshot> snapshots = snapshot();
+
+	auto labels = [&out](const Snapshot& s) -> std::ostream& {
+		return out << "backend=\"" << backendName(s.backend) << "\",statement=\"" << s.name << "\"";
+	};
+
+	out << "# HELP cassobs_statement_latency_seconds The latency of the database statements\n"
+	    << "# TYPE cassobs_statement_latency_seconds summary\n";
+	for (const Snapshot& s : snapshots) {
+		for (double quantile : { 0.5, 0.9, 0.99, 1. }) {
+			out << "cassobs_statement_latency_seconds{";
+			labels(s) << ",quantile=\"" << quantile << "\"} "
+				<< chrono::duration<double>(s.percentile(quantile)).count() << "\n";
+		}
+		out << "cassobs_statement_latency_seconds_sum{";
+		labels(s) << "} " << chrono::duration<double>(chrono::microseconds{s.sum}).count() << "\n";
+		out << "cassobs_statement_latency_seconds_count{";
+		labels(s) << "} " << s.count << "\n";
+	}
+
+	out << "# HELP cassobs_statement_errors_total The number of failed executions of the database statements\n"
+	    << "# TYPE cassobs_statement_errors_total counter\n";
+	for (const Snapshot& s : snapshots) {
+		out << "cassobs_statement_errors_total{";
+		labels(s) << "} " << s.errors << "\n";
+	}
+}
+
+void StatementMetrics::reset()
+{
+	StatementMetrics& metrics = instance();
+	std::lock_guard locked{metrics._mutex};
+	for (auto& s : metrics._series)
+		s.second->reset();
+}
+
+}
@@ -0,0 +1,217 @@
+/**
+ * @file statement_metrics.h
+ * @brief Definition of the StatementMetrics class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATEMENT_METRICS_H
+#define STATEMENT_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace meteodata {
+
+/**
+ * @brief The process-wide latency histograms and error counters of the
+ * database statements
+ *
+ * Each statement, identified by its database and its name, has a series
+ * recording the latency of each execution in a log-linear histogram (each
+ * power of two is split in eight buckets, so a percentile is known within
+ * 12.5%) and counting the failed executions. The series are created on first
+ * use and never destroyed. Looking a series up takes a lock, so the callers
+ * resolve the series of a statement once, when it is prepared, and keep a
+ * reference to it. The recording itself is lock-free.
+ */
+class StatementMetrics
+{
+public:
+	/**
+	 * @brief The databases the statements are executed on
+	 */
+	enum class Backend {
+		CASSANDRA,
+		POSTGRESQL,
+		MYSQL
+	};
+
+	/**
+	 * @brief The number of buckets per power of two, as a power of two
+	 */
+	constexpr static unsigned int SUB_BUCKET_BITS = 3;
+	/**
+	 * @brief The number of buckets of a histogram, enough for latencies
+	 * up to 2^36 microseconds (about nineteen hours)
+	 */
+	constexpr static std::size_t NB_BUCKETS = (36 - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+	/**
+	 * @brief The state of a series at some point in time
+	 */
+	struct Snapshot
+	{
+		Backend backend;
+		std::string name;
+		std::uint64_t count;
+		std::uint64_t errors;
+		/**
+		 * @brief The sum of the latencies, in microseconds
+		 */
+		std::uint64_t sum;
+		/**
+		 * @brief The number of executions per bucket
+		 */
+		std::array<std::uint64_t, NB_BUCKETS> buckets;
+
+		/**
+		 * @brief Estimate a percentile of the latency
+		 *
+		 * @param quantile The quantile, between 0 and 1
+		 *
+		 * @return The upper bound of the bucket containing the
+		 * percentile, zero if there is no execution
+		 */
+		std::chrono::microseconds percentile(double quantile) const;
+	};
+
+	/**
+	 * @brief The latency histogram and the error counter of a statement
+	 */
+	class Series
+	{
+	public:
+		Series(Backend backend, std::string name);
+
+		/**
+		 * @brief Record an execution of the statement
+		 *
+		 * @param latency The time between the execution and the
+		 * response
+		 * @param success Whether the execution succeeded
+		 */
+		void record(std::chrono::steady_clock::duration latency, bool success);
+
+		Backend backend() const { return _backend; }
+		const std::string& name() const { return _name; }
+		Snapshot snapshot() const;
+		void reset();
+
+	private:
+		Backend _backend;
+		std::string _name;
+		std::atomic<std::uint64_t> _errors{0};
+		std::atomic<std::uint64_t> _sum{0};
+		std::array<std::atomic<std::uint64_t>, NB_BUCKETS> _buckets{};
+	};
+
+	/**
+	 * @brief Measure the duration of a synchronous execution
+	 *
+	 * The execution is recorded as successful if stop() is called with
+	 * true, and as failed if stop() is called with false or if the timer is
+	 * destroyed before stop() is called, by an exception for instance.
+	 */
+	class Timer
+	{
+	public:
+		Timer(Backend backend, const std::string& name);
+		explicit Timer(Series& series);
+		~Timer();
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+		/**
+		 * @brief Record the execution, only the first call has an
+		 * effect
+		 *
+		 * @return The duration recorded, zero if the execution had
+		 * already been recorded
+		 */
+		std::chrono::steady_clock::duration stop(bool success = true);
+
+		/**
+		 * @brief Get the series the execution is recorded in, nullptr
+		 * once it has been recorded
+		 */
+		const Series* series() const { return _series; }
+
+	private:
+		Series* _series;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	/**
+	 * @brief Get the series of a statement, creating it if it does not
+	 * exist
+	 *
+	 * The reference remains valid until the end of the program.
+	 */
+	static Series& series(Backend backend, const std::string& name);
+
+	/**
+	 * @brief Get the current state of all the series, ordered by backend
+	 * and name
+	 */
+	static std::vector<Snapshot> snapshot();
+
+	/**
+	 * @brief Write the current state of all the series in the Prometheus
+	 * text format
+	 *
+	 * @param out The stream to write to
+	 */
+	static void dump(std::ostream& out);
+
+	/**
+	 * @brief Reset all the series to zero
+	 */
+	static void reset();
+
+	/**
+	 * @brief Get the index of the bucket of a latency, in microseconds
+	 */
+	static std::size_t bucketOf(std::uint64_t micros);
+
+	/**
+	 * @brief Get the largest latency of a bucket, in microseconds
+	 */
+	static std::uint64_t upperBoundOf(std::size_t bucket);
+
+private:
+	std::mutex _mutex;
+	std::map<std::pair<Backend, std::string>, std::unique_ptr<Series>> _series;
+
+	static StatementMetrics& instance();
+};
+
+}
+
+#endif
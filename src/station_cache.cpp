@@ -0,0 +1,171 @@
+/**
+ * @file station_cache.cpp
+ * @brief Implementation of the StationCache class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <cassandra.h>
+
+#include "station_cache.h"
+
+namespace meteodata {
+
+constexpr std::chrono::seconds StationCache::DEFAULT_TTL;
+
+StationCache::StationCache(std::chrono::seconds ttl) :
+	_ttl{ttl}
+{}
+
+StationCache::StationKey StationCache::keyOf(const CassUuid& station)
+{
+	return { station.time_and_version, station.clock_seq_and_node };
+}
+
+template<typename T>
+bool StationCache::lookup(const std::optional<Cached<T>>& cached, T& value)
+{
+	if (!cached || cached->expiry <= Clock::now()) {
+		_misses++;
+		return false;
+	}
+
+	value = cached->value;
+	_hits++;
+	return true;
+}
+
+template<typename T>
+bool StationCache::lookup(std::optional<Cached<T>> Entry::* field, const CassUuid& station, T& value)
+{
+	std::lock_guard locked{_mutex};
+	auto it = _stations.find(keyOf(station));
+	if (it == _stations.end()) {
+		_misses++;
+		return false;
+	}
+	return lookup(it->second.*field, value);
+}
+
+template<typename T>
+void StationCache::store(std::optional<Cached<T>> Entry::* field, const CassUuid& station, T&& value)
+{
+	std::lock_guard locked{_mutex};
+	if (_ttl <= std::chrono::seconds::zero())
+		return;
+	_stations[keyOf(station)].*field = Cached<T>{std::move(value), Clock::now() + _ttl};
+}
+
+bool StationCache::getDetails(const CassUuid& station, Details& details)
+{
+	return lookup(&Entry::details, station, details);
+}
+
+void StationCache::putDetails(const CassUuid& station, Details details)
+{
+	store(&Entry::details, station, std::move(details));
+}
+
+bool StationCache::getLocation(const CassUuid& station, Location& location)
+{
+	return lookup(&Entry::location, station, location);
+}
+
+void StationCache::putLocation(const CassUuid& station, const Location& location)
+{
+	store(&Entry::location, station, Location{location});
+}
+
+bool StationCache::getCoordinates(const CassUuid& station, Coordinates& coordinates)
+{
+	return lookup(&Entry::coordinates, station, coordinates);
+}
+
+void StationCache::putCoordinates(const CassUuid& station, Coordinates coordinates)
+{
+	store(&Entry::coordinates, station, std::move(coordinates));
+}
+
+bool StationCache::getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station)
+{
+	std::lock_guard locked{_mutex};
+	auto it = _stationsByCoords.find({elevation, latitude, longitude});
+	if (it == _stationsByCoords.end() || it->second.expiry <= Clock::now()) {
+		_misses++;
+		return false;
+	}
+
+	station = it->second.value;
+	_hits++;
+	return true;
+}
+
+void StationCache::putStationByCoords(int elevation, int latitude, int longitude, const CassUuid& station)
+{
+	std::lock_guard locked{_mutex};
+	if (_ttl <= std::chrono::seconds::zero())
+		return;
+	_stationsByCoords[{elevation, latitude, longitude}] = Cached<CassUuid>{station, Clock::now() + _ttl};
+}
+
+void StationCache::updateLastArchiveDownloadTime(const CassUuid& station, time_t time)
+{
+	std::lock_guard locked{_mutex};
+	auto it = _stations.find(keyOf(station));
+	if (it != _stations.end() && it->second.details)
+		it->second.details->value.lastArchiveDownloadTime = time;
+}
+
+void StationCache::invalidate(const CassUuid& station)
+{
+	std::lock_guard locked{_mutex};
+	StationKey key = keyOf(station);
+	_stations.erase(key);
+	for (auto it = _stationsByCoords.begin() ; it != _stationsByCoords.end() ;) {
+		if (keyOf(it->second.value) == key)
+			it = _stationsByCoords.erase(it);
+		else
+			++it;
+	}
+}
+
+void StationCache::clear()
+{
+	std::lock_guard locked{_mutex};
+	_stations.clear();
+	_stationsByCoords.clear();
+}
+
+void StationCache::setTtl(std::chrono::seconds ttl)
+{
+	std::lock_guard locked{_mutex};
+	_ttl = ttl;
+}
+
+StationCache::Statistics StationCache::statistics() const
+{
+	return { _hits.load(), _misses.load() };
+}
+
+}
@@ -0,0 +1,247 @@
+/**
+ * @file station_cache.h
+ * @brief Definition of the StationCache class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATION_CACHE_H
+#define STATION_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <cassandra.h>
+
+namespace meteodata {
+
+/**
+ * @brief An in-process cache of the stations metadata, shared by all the
+ * threads using a database connection
+ *
+ * The metadata of the stations rarely change but they are read by the
+ * connectors on each download cycle. Each entry is kept for a configurable
+ * amount of time, after which it is read again from the database, so that
+ * changes made by other processes are eventually seen. Changes made through
+ * the database connection owning the cache must invalidate or update the
+ * corresponding entries.
+ */
+class StationCache
+{
+public:
+	/**
+	 * @brief The details of a station, as returned by
+	 * DbConnectionCommon::getStationDetails()
+	 */
+	struct Details
+	{
+		std::string name;
+		int pollPeriod;
+		time_t lastArchiveDownloadTime;
+		bool storeInsideMeasurements;
+	};
+
+	/**
+	 * @brief The location of a station, as returned by
+	 * DbConnectionCommon::getStationLocation()
+	 */
+	struct Location
+	{
+		float latitude;
+		float longitude;
+		int elevation;
+	};
+
+	/**
+	 * @brief The coordinates of a station, as returned by
+	 * DbConnectionObservations::getStationCoordinates()
+	 */
+	struct Coordinates
+	{
+		float latitude;
+		float longitude;
+		int elevation;
+		std::pair<bool, std::string> name;
+		int pollPeriod;
+	};
+
+	/**
+	 * @brief The number of lookups answered from the cache and the
+	 * number of lookups which had to go to the database
+	 */
+	struct Statistics
+	{
+		std::uint64_t hits;
+		std::uint64_t misses;
+	};
+
+	/**
+	 * @brief The default time to live of the entries
+	 */
+	constexpr static std::chrono::seconds DEFAULT_TTL{300};
+
+	/**
+	 * @brief Construct an empty cache
+	 *
+	 * @param ttl The time to live of the entries, nothing is cached if
+	 * it's not positive
+	 */
+	explicit StationCache(std::chrono::seconds ttl = DEFAULT_TTL);
+
+	/**
+	 * @brief Look up the details of a station
+	 *
+	 * @param station The station's UUID
+	 * @param[out] details The cached details, if found
+	 *
+	 * @return True if, and only if, the details were in the cache and
+	 * have not expired
+	 */
+	bool getDetails(const CassUuid& station, Details& details);
+	void putDetails(const CassUuid& station, Details details);
+
+	/**
+	 * @brief Look up the location of a station
+	 *
+	 * @param station The station's UUID
+	 * @param[out] location The cached location, if found
+	 *
+	 * @return True if, and only if, the location was in the cache and has
+	 * not expired
+	 */
+	bool getLocation(const CassUuid& station, Location& location);
+	void putLocation(const CassUuid& station, const Location& location);
+
+	/**
+	 * @brief Look up the coordinates of a station
+	 *
+	 * @param station The station's UUID
+	 * @param[out] coordinates The cached coordinates, if found
+	 *
+	 * @return True if, and only if, the coordinates were in the cache and
+	 * have not expired
+	 */
+	bool getCoordinates(const CassUuid& station, Coordinates& coordinates);
+	void putCoordinates(const CassUuid& station, Coordinates coordinates);
+
+	/**
+	 * @brief Look up the station registered at some coordinates
+	 *
+	 * The coordinates are those given to
+	 * DbConnectionObservations::getStationByCoords(), they are only used
+	 * as a key.
+	 *
+	 * @param[out] station The station's UUID, if found
+	 *
+	 * @return True if, and only if, the station was in the cache and has
+	 * not expired
+	 */
+	bool getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station);
+	void putStationByCoords(int elevation, int latitude, int longitude, const CassUuid& station);
+
+	/**
+	 * @brief Update the timestamp of the last archive entry downloaded
+	 * from a station, if its details are in the cache
+	 *
+	 * The expiry of the entry is left untouched.
+	 *
+	 * @param station The station's UUID
+	 * @param time The new timestamp
+	 */
+	void updateLastArchiveDownloadTime(const CassUuid& station, time_t time);
+
+	/**
+	 * @brief Forget about everything known about a station, including
+	 * its coordinates
+	 *
+	 * @param station The station's UUID
+	 */
+	void invalidate(const CassUuid& station);
+
+	/**
+	 * @brief Forget about all stations
+	 */
+	void clear();
+
+	/**
+	 * @brief Set the time to live of the entries put in the cache from
+	 * now on
+	 *
+	 * @param ttl The time to live of the entries, nothing is cached if
+	 * it's not positive
+	 */
+	void setTtl(std::chrono::seconds ttl);
+
+	/**
+	 * @brief Get the number of hits and misses since the creation of the
+	 * cache
+	 */
+	Statistics statistics() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+	using StationKey = std::pair<cass_uint64_t, cass_uint64_t>;
+	using CoordinatesKey = std::tuple<int, int, int>;
+
+	template<typename T>
+	struct Cached
+	{
+		T value;
+		Clock::time_point expiry;
+	};
+
+	struct Entry
+	{
+		std::optional<Cached<Details>> details;
+		std::optional<Cached<Location>> location;
+		std::optional<Cached<Coordinates>> coordinates;
+	};
+
+	std::map<StationKey, Entry> _stations;
+	std::map<CoordinatesKey, Cached<CassUuid>> _stationsByCoords;
+	std::chrono::seconds _ttl;
+
+	std::atomic<std::uint64_t> _hits{0};
+	std::atomic<std::uint64_t> _misses{0};
+
+	mutable std::mutex _mutex;
+
+	static StationKey keyOf(const CassUuid& station);
+
+	template<typename T>
+	bool lookup(const std::optional<Cached<T>>& cached, T& value);
+
+	template<typename T>
+	bool lookup(std::optional<Cached<T>> Entry::* field, const CassUuid& station, T& value);
+
+	template<typename T>
+	void store(std::optional<Cached<T>> Entry::* field, const CassUuid& station, T&& value);
+};
+
+}
+
+#endif
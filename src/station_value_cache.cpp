@@ -0,0 +1,199 @@
+/**
+ * @file station_value_cache.cpp
+ * @brief Implementation of the StationValueCache class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+
+#include "station_value_cache.h"
+
+namespace meteodata {
+
+constexpr std::chrono::milliseconds StationValueCache::DEFAULT_FLUSH_INTERVAL;
+
+StationValueCache::StationValueCache(Writer writer, Mode mode, std::chrono::milliseconds flushInterval) :
+	_writer{std::move(writer)},
+	_mode{mode},
+	_flushInterval{flushInterval}
+{}
+
+StationValueCache::~StationValueCache()
+{
+	{
+		std::lock_guard locked{_mutex};
+		_stopping = true;
+	}
+	_wakeUp.notify_all();
+	if (_flusher.joinable())
+		_flusher.join();
+	flush();
+}
+
+StationValueCache::Key StationValueCache::keyOf(const CassUuid& station, const std::string& key)
+{
+	return { station.time_and_version, station.clock_seq_and_node, key };
+}
+
+bool StationValueCache::lookup(const CassUuid& station, const std::string& key, std::optional<Value>& value)
+{
+	std::lock_guard locked{_mutex};
+	auto it = _entries.find(keyOf(station, key));
+	if (it == _entries.end())
+		return false;
+
+	value = it->second.value;
+	return true;
+}
+
+void StationValueCache::load(const CassUuid& station, const std::string& key, const std::optional<Value>& value)
+{
+	std::lock_guard locked{_mutex};
+	_entries.try_emplace(keyOf(station, key), Entry{value});
+}
+
+bool StationValueCache::update(const Write& write)
+{
+	std::unique_lock locked{_mutex};
+	Entry& entry = _entries[keyOf(write.station, write.key)];
+
+	if (entry.value && entry.value->time > write.value.time &&
+	    ((write.value.intValue.first && entry.value->intValue.first) ||
+	     (write.value.floatValue.first && entry.value->floatValue.first))) {
+		// there's already a value and it's more recent, don't
+		// replace it
+		return false;
+	}
+
+	if (!entry.value)
+		entry.value = Value{write.value.time};
+	entry.value->time = write.value.time;
+	if (write.value.intValue.first) {
+		entry.value->intValue = write.value.intValue;
+		entry.intDirty = true;
+	}
+	if (write.value.floatValue.first) {
+		entry.value->floatValue = write.value.floatValue;
+		entry.floatDirty = true;
+	}
+
+	if (_mode == Mode::WRITE_THROUGH) {
+		locked.unlock();
+		return flush();
+	}
+
+	if (!_flusher.joinable())
+		_flusher = std::thread{&StationValueCache::run, this};
+	return true;
+}
+
+bool StationValueCache::flush()
+{
+	std::lock_guard flushing{_flushMutex};
+
+	std::vector<Write> writes;
+	{
+		std::lock_guard locked{_mutex};
+		for (auto& [key, entry] : _entries) {
+			if (!entry.intDirty && !entry.floatDirty)
+				continue;
+
+			Write write{
+				CassUuid{std::get<0>(key), std::get<1>(key)},
+				std::get<2>(key),
+				Value{entry.value->time}
+			};
+			if (entry.intDirty)
+				write.value.intValue = entry.value->intValue;
+			if (entry.floatDirty)
+				write.value.floatValue = entry.value->floatValue;
+			writes.push_back(std::move(write));
+			entry.intDirty = entry.floatDirty = false;
+		}
+	}
+
+	if (writes.empty() || _writer(writes))
+		return true;
+
+	// Try again on the next flush, unless the values have been updated in
+	// the meantime
+	std::lock_guard locked{_mutex};
+	for (const Write& write : writes) {
+		auto it = _entries.find(keyOf(write.station, write.key));
+		if (it == _entries.end() || !it->second.value || it->second.value->time != write.value.time)
+			continue;
+		it->second.intDirty = it->second.intDirty || write.value.intValue.first;
+		it->second.floatDirty = it->second.floatDirty || write.value.floatValue.first;
+	}
+	return false;
+}
+
+void StationValueCache::setMode(Mode mode)
+{
+	{
+		std::lock_guard locked{_mutex};
+		_mode = mode;
+	}
+	if (mode == Mode::WRITE_THROUGH)
+		flush();
+}
+
+void StationValueCache::setFlushInterval(std::chrono::milliseconds flushInterval)
+{
+	{
+		std::lock_guard locked{_mutex};
+		_flushInterval = flushInterval;
+	}
+	_wakeUp.notify_all();
+}
+
+void StationValueCache::clear()
+{
+	std::lock_guard locked{_mutex};
+	_entries.clear();
+}
+
+void StationValueCache::run()
+{
+	std::unique_lock locked{_mutex};
+	while (!_stopping) {
+		auto deadline = std::chrono::steady_clock::now() + _flushInterval;
+		// Wait again if woken up by a change of interval
+		while (!_stopping && _wakeUp.wait_until(locked, deadline) == std::cv_status::no_timeout)
+			deadline = std::min(deadline, std::chrono::steady_clock::now() + _flushInterval);
+		if (_stopping)
+			break;
+
+		locked.unlock();
+		flush();
+		locked.lock();
+	}
+}
+
+}
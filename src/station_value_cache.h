@@ -0,0 +1,235 @@
+/**
+ * @file station_value_cache.h
+ * @brief Definition of the StationValueCache class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATION_VALUE_CACHE_H
+#define STATION_VALUE_CACHE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+
+namespace meteodata {
+
+/**
+ * @brief An in-memory layer in front of the per-station key/value cache of
+ * the database (the one of DbConnectionObservations::getCachedInt() and
+ * DbConnectionObservations::cacheInt() and their floating-point
+ * counterparts)
+ *
+ * Each (station, key) pair is read from the database the first time it's
+ * needed, and served from memory afterwards. In write-behind mode, the
+ * updates are only applied in memory and the last update of each pair is
+ * written to the database periodically by a background thread, when
+ * flush() is called, and when the cache is destroyed. In write-through mode,
+ * the updates are written to the database right away, so that nothing is
+ * lost if the process crashes.
+ *
+ * The cache assumes that it's the only writer of the pairs it knows about.
+ */
+class StationValueCache
+{
+public:
+	/**
+	 * @brief A row of the database cache, both columns can be set for
+	 * the same key
+	 */
+	struct Value
+	{
+		time_t time;
+		std::pair<bool, int> intValue = { false, 0 };
+		std::pair<bool, float> floatValue = { false, 0.0f };
+	};
+
+	/**
+	 * @brief An update to write to the database, the values not to be
+	 * written are not set
+	 */
+	struct Write
+	{
+		CassUuid station;
+		std::string key;
+		Value value;
+	};
+
+	/**
+	 * @brief The function writing updates to the database, returning
+	 * true if, and only if, all of them have been written
+	 */
+	using Writer = std::function<bool(const std::vector<Write>&)>;
+
+	/**
+	 * @brief The ways the updates are propagated to the database
+	 */
+	enum class Mode {
+		/**
+		 * @brief The updates are written periodically by a
+		 * background thread
+		 */
+		WRITE_BEHIND,
+		/**
+		 * @brief Each update is written before returning
+		 */
+		WRITE_THROUGH
+	};
+
+	/**
+	 * @brief The default interval between two writes in write-behind
+	 * mode
+	 */
+	constexpr static std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{10000};
+
+	/**
+	 * @brief Construct an empty cache
+	 *
+	 * @param writer The function used to write the updates to the
+	 * database
+	 * @param mode How to propagate the updates to the database
+	 * @param flushInterval The interval between two writes in
+	 * write-behind mode
+	 */
+	explicit StationValueCache(Writer writer, Mode mode = Mode::WRITE_BEHIND,
+		std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL);
+
+	/**
+	 * @brief Write the pending updates and stop the background thread
+	 */
+	~StationValueCache();
+
+	StationValueCache(const StationValueCache&) = delete;
+	StationValueCache& operator=(const StationValueCache&) = delete;
+
+	/**
+	 * @brief Look up a (station, key) pair
+	 *
+	 * @param station The station's UUID
+	 * @param key The key
+	 * @param[out] value The value if the pair is known and has a value in
+	 * the database, empty if the pair is known to be absent from the
+	 * database
+	 *
+	 * @return True if, and only if, the pair is known, false if it has to
+	 * be read from the database and loaded
+	 */
+	bool lookup(const CassUuid& station, const std::string& key, std::optional<Value>& value);
+
+	/**
+	 * @brief Record what has been read from the database for a (station,
+	 * key) pair
+	 *
+	 * Nothing is done if the pair is already known, the value in memory
+	 * being at least as recent as the one in the database.
+	 *
+	 * @param station The station's UUID
+	 * @param key The key
+	 * @param value The value read from the database, empty if there is
+	 * none
+	 */
+	void load(const CassUuid& station, const std::string& key, const std::optional<Value>& value);
+
+	/**
+	 * @brief Update a (station, key) pair, unless the value in memory is
+	 * more recent
+	 *
+	 * The pair must have been loaded before. Only the values set in
+	 * \a write are updated, the others are kept.
+	 *
+	 * @param write The new values and their time
+	 *
+	 * @return True if the pair has been updated in memory and, in
+	 * write-through mode, in the database, false otherwise
+	 */
+	bool update(const Write& write);
+
+	/**
+	 * @brief Write all the pending updates to the database
+	 *
+	 * The updates that could not be written are kept for the next flush.
+	 *
+	 * @return True if, and only if, all the updates have been written
+	 */
+	bool flush();
+
+	/**
+	 * @brief Change how the updates are propagated to the database,
+	 * switching to write-through mode flushes the pending updates
+	 *
+	 * @param mode The new mode
+	 */
+	void setMode(Mode mode);
+
+	/**
+	 * @brief Change the interval between two writes in write-behind
+	 * mode
+	 *
+	 * @param flushInterval The new interval
+	 */
+	void setFlushInterval(std::chrono::milliseconds flushInterval);
+
+	/**
+	 * @brief Forget everything, the pending updates are discarded
+	 */
+	void clear();
+
+private:
+	using Key = std::tuple<cass_uint64_t, cass_uint64_t, std::string>;
+
+	struct Entry
+	{
+		std::optional<Value> value;
+		bool intDirty = false;
+		bool floatDirty = false;
+	};
+
+	Writer _writer;
+	Mode _mode;
+	std::chrono::milliseconds _flushInterval;
+	std::map<Key, Entry> _entries;
+
+	/**
+	 * @brief Serialize the flushes so that two writes of the same pair
+	 * cannot be reordered
+	 */
+	std::mutex _flushMutex;
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	bool _stopping = false;
+	std::thread _flusher;
+
+	static Key keyOf(const CassUuid& station, const std::string& key);
+	void run();
+};
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/observation.h"
+#include "../src/observation_block.h"
+#include "../src/packed_observation.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+/**
+ * @brief The size of the archive to validate
+ */
+constexpr int NB_RECORDS = 100000;
+
+/**
+ * @brief Entry point
+ *
+ * Validate an archive of random observations one observation at a time, with
+ * Observation::filterOutImpossibleValues(), and all at once with
+ * ObservationBlock::filterOutImpossibleValues(), check that the results are
+ * the same and compare the time taken, no database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	std::mt19937 gen{42};
+	std::bernoulli_distribution present{0.7};
+	std::uniform_real_distribution<float> value{-100.f, 1500.f};
+
+	sys_seconds time = sys_days{2024_y/3/15};
+	std::vector<Observation> archive;
+	archive.reserve(NB_RECORDS);
+	for (int i = 0 ; i < NB_RECORDS ; i++) {
+		PackedObservation packed;
+		packed.station = CassUuid{0x1234, 0x5678};
+		packed.time = time + minutes{i};
+		packed.day = date::floor<days>(packed.time);
+		for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+			if (present(gen))
+				packed.set(PackedObservation::Field(f), value(gen));
+		}
+		archive.push_back(packed.unpack());
+	}
+
+	// The scalar path, as done on insertion
+	auto start = steady_clock::now();
+	std::vector<Observation> filtered;
+	filtered.reserve(NB_RECORDS);
+	for (const Observation& obs : archive) {
+		Observation copy{obs};
+		copy.filterOutImpossibleValues();
+		filtered.push_back(copy);
+	}
+	auto scalar = duration_cast<microseconds>(steady_clock::now() - start);
+
+	start = steady_clock::now();
+	ObservationBlock block;
+	block.reserve(NB_RECORDS);
+	for (const Observation& obs : archive)
+		block.push_back(obs);
+	auto conversion = duration_cast<microseconds>(steady_clock::now() - start);
+
+	start = steady_clock::now();
+	block.filterOutImpossibleValues();
+	auto batch = duration_cast<microseconds>(steady_clock::now() - start);
+
+	int failures = 0;
+	for (int i = 0 ; i < NB_RECORDS ; i++) {
+		if (block.get(i).presence() != PackedObservation{filtered[i]}.presence())
+			failures++;
+	}
+
+	std::cout << "Per observation: " << scalar.count() << "us" << std::endl;
+	std::cout << "Block: " << batch.count() << "us (+ " << conversion.count() << "us to build the block)" << std::endl;
+	std::cout << failures << " observations filtered differently" << std::endl;
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/dbconnection_observations.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+/**
+ * @brief The number of observations inserted by each run
+ */
+constexpr int NB_OBSERVATIONS = 50000;
+
+/**
+ * @brief Entry point
+ *
+ * Compare the throughput of the prepared statement and COPY methods of
+ * insertV2DataPointsInTimescaleDB().
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	cass_log_set_level(CASS_LOG_INFO);
+	CassLogCallback logCallback =
+		[](const CassLogMessage *message, void*) -> void {
+			std::string logLevel =
+				message->severity == CASS_LOG_CRITICAL ? "Critical error" :
+				message->severity == CASS_LOG_ERROR    ? "Error" :
+				message->severity == CASS_LOG_WARN     ? "Warning" :
+				message->severity == CASS_LOG_INFO     ? "Notice" :
+									 "Debug";
+
+			std::cerr << "[" << logLevel << "] " << message->message << "(from " << message->function << ", in " << message->file << ", line " << message->line << std::endl;
+		};
+	cass_log_set_callback(logCallback, NULL);
+
+	DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	CassUuid uuid;
+	cass_uuid_from_string("00000000-0000-0000-0000-111111111111", &uuid);
+
+	std::vector<Observation> observations;
+	observations.reserve(NB_OBSERVATIONS);
+	sys_seconds now = date::floor<seconds>(system_clock::now());
+	for (int i = 0 ; i < NB_OBSERVATIONS ; i++) {
+		Observation obs;
+		obs.station = uuid;
+		obs.time = now - minutes{NB_OBSERVATIONS - i};
+		obs.day = date::floor<days>(obs.time);
+		obs.barometer = {true, 1015.3f};
+		obs.outsidetemp = {true, 17.4f};
+		obs.outsidehum = {true, 83};
+		obs.rainfall = {true, 0.2f};
+		observations.push_back(obs);
+	}
+
+	int ret = 0;
+	for (auto method : { DbConnectionObservations::TimescaleDBInsertionMethod::UPSERT, DbConnectionObservations::TimescaleDBInsertionMethod::COPY }) {
+		auto start = steady_clock::now();
+		bool ok = db.insertV2DataPointsInTimescaleDB(observations.begin(), observations.end(), method);
+		auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+
+		std::cout << (method == DbConnectionObservations::TimescaleDBInsertionMethod::COPY ? "COPY: " : "Prepared upserts: ")
+			<< NB_OBSERVATIONS << " observations in " << elapsed.count() << "ms ("
+			<< (elapsed.count() > 0 ? NB_OBSERVATIONS * 1000L / elapsed.count() : 0) << " observations/s)"
+			<< (ok ? "" : ", FAILED") << std::endl;
+		if (!ok)
+			ret = 255;
+	}
+
+	return ret;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <future>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/dbconnection_observations.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+/**
+ * @brief The number of observations inserted by each run
+ */
+constexpr int NB_OBSERVATIONS = 200;
+
+Observation makeObservation(const CassUuid& station, int i)
+{
+	Observation obs;
+	obs.station = station;
+	obs.time = date::floor<seconds>(system_clock::now()) - minutes{NB_OBSERVATIONS - i};
+	obs.day = date::floor<days>(obs.time);
+	obs.barometer = {true, 1015.3f};
+	obs.outsidetemp = {true, 17.4f};
+	obs.outsidehum = {true, 83};
+	obs.rainfall = {true, 0.2f};
+	return obs;
+}
+
+/**
+ * @brief Entry point
+ *
+ * Compare the per-observation latency of the serial and asynchronous
+ * insertion paths, as well as the throughput of the asynchronous path when
+ * all the insertions are in flight at the same time and of the bulk
+ * insertion path.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	cass_log_set_level(CASS_LOG_INFO);
+	CassLogCallback logCallback =
+		[](const CassLogMessage *message, void*) -> void {
+			std::string logLevel =
+				message->severity == CASS_LOG_CRITICAL ? "Critical error" :
+				message->severity == CASS_LOG_ERROR    ? "Error" :
+				message->severity == CASS_LOG_WARN     ? "Warning" :
+				message->severity == CASS_LOG_INFO     ? "Notice" :
+									 "Debug";
+
+			std::cerr << "[" << logLevel << "] " << message->message << "(from " << message->function << ", in " << message->file << ", line " << message->line << std::endl;
+		};
+	cass_log_set_callback(logCallback, NULL);
+
+	DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	CassUuid uuid;
+	cass_uuid_from_string("00000000-0000-0000-0000-111111111111", &uuid);
+
+	int failures = 0;
+
+	auto start = steady_clock::now();
+	for (int i = 0 ; i < NB_OBSERVATIONS ; i++) {
+		if (!db.insertV2DataPoint(makeObservation(uuid, i)))
+			failures++;
+	}
+	auto serial = steady_clock::now() - start;
+
+	start = steady_clock::now();
+	for (int i = 0 ; i < NB_OBSERVATIONS ; i++) {
+		if (!db.insertV2DataPointAsync(makeObservation(uuid, i)).get())
+			failures++;
+	}
+	auto async = steady_clock::now() - start;
+
+	start = steady_clock::now();
+	std::vector<std::future<bool>> inFlight;
+	inFlight.reserve(NB_OBSERVATIONS);
+	for (int i = 0 ; i < NB_OBSERVATIONS ; i++)
+		inFlight.push_back(db.insertV2DataPointAsync(makeObservation(uuid, i)));
+	for (std::future<bool>& f : inFlight) {
+		if (!f.get())
+			failures++;
+	}
+	auto pipelined = steady_clock::now() - start;
+
+	std::vector<Observation> archive;
+	archive.reserve(NB_OBSERVATIONS);
+	for (int i = 0 ; i < NB_OBSERVATIONS ; i++)
+		archive.push_back(makeObservation(uuid, i));
+	start = steady_clock::now();
+	std::vector<std::size_t> bulkFailures;
+	db.insertV2DataPoints(archive.begin(), archive.end(), &bulkFailures);
+	failures += bulkFailures.size();
+	auto bulk = steady_clock::now() - start;
+
+	std::cout << "Serial insertion: "
+		<< duration_cast<microseconds>(serial).count() / NB_OBSERVATIONS << "µs per observation\n"
+		<< "Asynchronous insertion, one at a time: "
+		<< duration_cast<microseconds>(async).count() / NB_OBSERVATIONS << "µs per observation\n"
+		<< "Asynchronous insertion, all in flight: "
+		<< duration_cast<microseconds>(pipelined).count() / NB_OBSERVATIONS << "µs per observation\n"
+		<< "Bulk insertion (raw and filtered tables only): "
+		<< duration_cast<microseconds>(bulk).count() / NB_OBSERVATIONS << "µs per observation\n"
+		<< failures << " failed insertions" << std::endl;
+
+	return failures == 0 ? 0 : 255;
+}
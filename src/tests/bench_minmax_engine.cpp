@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/dbconnection_minmax.h"
+#include "../src/minmax_engine.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+/**
+ * @brief The number of stations computed by each run
+ */
+constexpr std::size_t NB_STATIONS = 32;
+
+/**
+ * @brief The number of days computed for each station
+ */
+constexpr int NB_DAYS = 60;
+
+/**
+ * @brief Entry point
+ *
+ * Recompute the minmax values of the last days of some stations with the
+ * MinmaxEngine and an increasing number of threads, each with its own
+ * PostgreSQL connection.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	cass_log_set_level(CASS_LOG_INFO);
+	CassLogCallback logCallback =
+		[](const CassLogMessage *message, void*) -> void {
+			std::string logLevel =
+				message->severity == CASS_LOG_CRITICAL ? "Critical error" :
+				message->severity == CASS_LOG_ERROR    ? "Error" :
+				message->severity == CASS_LOG_WARN     ? "Warning" :
+				message->severity == CASS_LOG_INFO     ? "Notice" :
+									 "Debug";
+
+			std::cerr << "[" << logLevel << "] " << message->message << "(from " << message->function << ", in " << message->file << ", line " << message->line << std::endl;
+		};
+	cass_log_set_callback(logCallback, NULL);
+
+	sys_days last = date::floor<days>(system_clock::now()) - days{1};
+	sys_days first = last - days{NB_DAYS - 1};
+
+	std::size_t failures = 0;
+	for (std::size_t nbThreads : { 1, 2, 4, 8, 16 }) {
+		ConnectionOptions options;
+		options.pgPoolSize = nbThreads;
+		DbConnectionMinmax db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword, options);
+
+		std::vector<CassUuid> stations;
+		if (!db.getAllStations(stations)) {
+			std::cerr << "Couldn't get the list of stations" << std::endl;
+			return 1;
+		}
+		if (stations.size() > NB_STATIONS)
+			stations.resize(NB_STATIONS);
+
+		MinmaxEngine engine{db, nbThreads};
+		std::vector<CassUuid> failed;
+		auto start = steady_clock::now();
+		std::size_t stationDays = engine.run(stations, first, last, &failed);
+		auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+
+		std::cout << nbThreads << " threads: " << stationDays << " station-days in "
+			<< elapsed.count() << "ms ("
+			<< (elapsed.count() > 0 ? stationDays * 1000 / elapsed.count() : 0)
+			<< " station-days/s)" << std::endl;
+		failures += failed.size();
+	}
+
+	std::cout << failures << " failed stations" << std::endl;
+	return failures == 0 ? 0 : 255;
+}
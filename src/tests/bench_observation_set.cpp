@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/observation.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+/**
+ * @brief The number of records filled by each method
+ */
+constexpr int NB_RECORDS = 100000;
+
+namespace {
+	/**
+	 * @brief The 60 columns of a record, as named by a typical connector
+	 */
+	const std::vector<std::string> COLUMNS = {
+		"pressure", "dew_point", "extra_temperature1", "extra_temperature2", "extra_temperature3",
+		"heatindex", "inside_temperature", "leaf_temperature1", "leaf_temperature2", "outside_temperature",
+		"rain_rate", "rainfall", "evapotranspiration", "soil_temperature1", "soil_temperature2",
+		"soil_temperature3", "soil_temperature4", "thsw_index", "windchill", "windgust_speed",
+		"min_wind_speed", "wind_speed", "min_outside_temperature", "max_outside_temperature", "soil_moisture_10cm",
+		"soil_moisture_20cm", "soil_moisture_30cm", "soil_moisture_40cm", "soil_moisture_50cm", "soil_moisture_60cm",
+		"soil_temperature_10cm", "soil_temperature_20cm", "soil_temperature_30cm", "soil_temperature_40cm", "soil_temperature_50cm",
+		"soil_temperature_60cm", "leaf_wetness_percent1", "soil_conductivity1", "voltage_battery", "voltage_solar_panel",
+		"voltage_backup", "extra_humidity1", "extra_humidity2", "inside_humidity", "leaf_wetness1",
+		"leaf_wetness2", "soil_moisture1", "soil_moisture2", "soil_moisture3", "soil_moisture4",
+		"outside_humidity", "uv_index", "wind_direction", "solar_radiation", "insolation_time",
+		"leafwetness_timeratio1", "barometer", "outsidetemp", "outsidehum", "windspeed"
+	};
+}
+
+/**
+ * @brief Entry point
+ *
+ * Fill records of 60 variables by name and by resolved handle and compare the
+ * throughput of Observation::set(), no database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	std::vector<bool> isInt;
+	for (const std::string& column : COLUMNS)
+		isInt.push_back(Observation::isValidIntVariable(column));
+
+	// Keep the observations alive so that the stores are not optimized out
+	double checksum = 0;
+
+	auto start = steady_clock::now();
+	for (int i = 0 ; i < NB_RECORDS ; i++) {
+		Observation obs;
+		for (std::size_t c = 0 ; c < COLUMNS.size() ; c++) {
+			if (isInt[c])
+				obs.set(COLUMNS[c], i);
+			else
+				obs.set(COLUMNS[c], float(i));
+		}
+		checksum += obs.outsidetemp.second;
+	}
+	auto byName = duration_cast<microseconds>(steady_clock::now() - start);
+
+	start = steady_clock::now();
+	std::vector<Observation::VariableHandle> handles;
+	for (const std::string& column : COLUMNS)
+		handles.push_back(Observation::resolve(column));
+	for (int i = 0 ; i < NB_RECORDS ; i++) {
+		Observation obs;
+		for (std::size_t c = 0 ; c < handles.size() ; c++) {
+			if (isInt[c])
+				obs.set(handles[c], i);
+			else
+				obs.set(handles[c], float(i));
+		}
+		checksum -= obs.outsidetemp.second;
+	}
+	auto byHandle = duration_cast<microseconds>(steady_clock::now() - start);
+
+	std::size_t nbSets = NB_RECORDS * COLUMNS.size();
+	std::cout << "By name: " << byName.count() << "us ("
+		<< (byName.count() > 0 ? nbSets * 1000000 / byName.count() : 0) << " sets/s)" << std::endl;
+	std::cout << "By handle: " << byHandle.count() << "us ("
+		<< (byHandle.count() > 0 ? nbSets * 1000000 / byHandle.count() : 0) << " sets/s)" << std::endl;
+
+	return checksum == 0 ? 0 : 255;
+}
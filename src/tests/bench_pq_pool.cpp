@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include <date/date.h>
+#include "../src/dbconnection_observations.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+/**
+ * @brief The number of operations run by each thread
+ */
+constexpr int NB_OPERATIONS = 200;
+
+/**
+ * @brief Entry point
+ *
+ * Run selectDownloadsByStation() and insertV2DataPointInTimescaleDB() from
+ * several threads at once, with a single PostgreSQL connection and with a pool
+ * of as many connections as threads.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	cass_log_set_level(CASS_LOG_INFO);
+	CassLogCallback logCallback =
+		[](const CassLogMessage *message, void*) -> void {
+			std::string logLevel =
+				message->severity == CASS_LOG_CRITICAL ? "Critical error" :
+				message->severity == CASS_LOG_ERROR    ? "Error" :
+				message->severity == CASS_LOG_WARN     ? "Warning" :
+				message->severity == CASS_LOG_INFO     ? "Notice" :
+									 "Debug";
+
+			std::cerr << "[" << logLevel << "] " << message->message << "(from " << message->function << ", in " << message->file << ", line " << message->line << std::endl;
+		};
+	cass_log_set_callback(logCallback, NULL);
+
+	CassUuid uuid;
+	cass_uuid_from_string("00000000-0000-0000-0000-111111111111", &uuid);
+
+	std::atomic<int> failures{0};
+	for (std::size_t nbThreads : { 1, 2, 4, 8, 16 }) {
+		for (std::size_t poolSize : { std::size_t{1}, nbThreads }) {
+			ConnectionOptions options;
+			options.pgPoolSize = poolSize;
+			DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword, options);
+
+			auto start = steady_clock::now();
+			std::vector<std::thread> threads;
+			for (std::size_t t = 0 ; t < nbThreads ; t++) {
+				threads.emplace_back([&db, &uuid, &failures, t]() {
+					sys_seconds now = date::floor<seconds>(system_clock::now());
+					for (int i = 0 ; i < NB_OPERATIONS ; i++) {
+						std::vector<Download> downloads;
+						if (!db.selectDownloadsByStation(uuid, "bench", downloads))
+							failures++;
+
+						Observation obs;
+						obs.station = uuid;
+						obs.time = now - minutes{int(t) * NB_OPERATIONS + i};
+						obs.outsidetemp = {true, 17.4f};
+						if (!db.insertV2DataPointInTimescaleDB(obs))
+							failures++;
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+			auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+
+			std::cout << nbThreads << " threads, " << poolSize << " connection(s): "
+				<< elapsed.count() << "ms ("
+				<< (elapsed.count() > 0 ? 2L * NB_OPERATIONS * nbThreads * 1000 / elapsed.count() : 0)
+				<< " operations/s)" << std::endl;
+
+			if (poolSize == nbThreads)
+				break;
+		}
+	}
+
+	std::cout << failures << " failed operations" << std::endl;
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "../src/dbconnection_common.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+/**
+ * @brief The number of times each query is run
+ */
+constexpr int NB_ITERATIONS = 200;
+
+namespace {
+	/**
+	 * @brief A connection preparing the station-list queries and running
+	 * them through both the std::function-based performSelect() and the
+	 * typed performTypedSelect()
+	 */
+	class SelectBench : public DbConnectionCommon
+	{
+	public:
+		SelectBench(const std::string& address, const std::string& user, const std::string& password) :
+			DbConnectionCommon(address, user, password)
+		{
+			prepareOneStatement(_selectCimel, "select_cimel", "SELECT station, active, cimelid, tz FROM meteodata.cimel");
+			prepareOneStatement(_selectLiveobjects, "select_liveobjects", "SELECT station, active, stream_id, topic_prefix FROM meteodata.liveobjects");
+			waitForPreparedStatements();
+		}
+
+		bool cimelWithFunction(std::vector<std::tuple<CassUuid, std::string, int>>& stations)
+		{
+			return performSelect(_selectCimel,
+				[&stations](const CassRow* row) {
+					const CassValue* v = cass_row_get_column(row, 0);
+					if (cass_value_is_null(v))
+						return;
+					CassUuid station;
+					cass_value_get_uuid(v, &station);
+
+					v = cass_row_get_column(row, 1);
+					if (cass_value_is_null(v))
+						return;
+					cass_bool_t active;
+					cass_value_get_bool(v, &active);
+
+					v = cass_row_get_column(row, 2);
+					if (cass_value_is_null(v))
+						return;
+					const char *cimelId;
+					size_t sizeCimelId;
+					cass_value_get_string(v, &cimelId, &sizeCimelId);
+
+					int timezone = 0;
+					v = cass_row_get_column(row, 3);
+					if (!cass_value_is_null(v))
+						cass_value_get_int32(v, &timezone);
+
+					if (active == cass_true)
+						stations.emplace_back(station, std::string{cimelId, sizeCimelId}, timezone);
+				}
+			);
+		}
+
+		bool cimelTyped(std::vector<std::tuple<CassUuid, std::string, int>>& stations)
+		{
+			return performTypedSelect<CassUuid, bool, std::string_view, int>(_selectCimel,
+				[&stations](const std::pair<bool, CassUuid>& station, const std::pair<bool, bool>& active,
+				            const std::pair<bool, std::string_view>& cimelId, const std::pair<bool, int>& timezone) {
+					if (station.first && active.first && cimelId.first && active.second)
+						stations.emplace_back(station.second, std::string{cimelId.second}, timezone.first ? timezone.second : 0);
+				}
+			);
+		}
+
+		bool liveobjectsWithFunction(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations)
+		{
+			return performSelect(_selectLiveobjects,
+				[&stations](const CassRow* row) {
+					const CassValue* v = cass_row_get_column(row, 0);
+					if (cass_value_is_null(v))
+						return;
+					CassUuid station;
+					cass_value_get_uuid(v, &station);
+
+					v = cass_row_get_column(row, 1);
+					if (cass_value_is_null(v))
+						return;
+					cass_bool_t active;
+					cass_value_get_bool(v, &active);
+
+					v = cass_row_get_column(row, 2);
+					if (cass_value_is_null(v))
+						return;
+					const char *streamId;
+					size_t sizeStreamId;
+					cass_value_get_string(v, &streamId, &sizeStreamId);
+
+					v = cass_row_get_column(row, 3);
+					if (cass_value_is_null(v))
+						return;
+					const char *topicId;
+					size_t sizeTopicId;
+					cass_value_get_string(v, &topicId, &sizeTopicId);
+
+					if (active == cass_true)
+						stations.emplace_back(station, std::string{streamId, sizeStreamId}, std::string{topicId, sizeTopicId});
+				}
+			);
+		}
+
+		bool liveobjectsTyped(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations)
+		{
+			return performTypedSelect<CassUuid, bool, std::string_view, std::string_view>(_selectLiveobjects,
+				[&stations](const std::pair<bool, CassUuid>& station, const std::pair<bool, bool>& active,
+				            const std::pair<bool, std::string_view>& streamId, const std::pair<bool, std::string_view>& topicId) {
+					if (station.first && active.first && streamId.first && topicId.first && active.second)
+						stations.emplace_back(station.second, std::string{streamId.second}, std::string{topicId.second});
+				}
+			);
+		}
+
+	private:
+		CassandraStmtPtr _selectCimel;
+		CassandraStmtPtr _selectLiveobjects;
+	};
+
+	template<typename Result, typename Query>
+	bool bench(const char* name, Query&& query)
+	{
+		bool ret = true;
+		std::size_t rows = 0;
+		auto start = steady_clock::now();
+		for (int i = 0 ; i < NB_ITERATIONS ; i++) {
+			Result stations;
+			ret = query(stations) && ret;
+			rows += stations.size();
+		}
+		auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+		std::cout << name << ": " << rows << " rows in " << elapsed.count() << "us ("
+			<< elapsed.count() / NB_ITERATIONS << "us per query)" << std::endl;
+		return ret;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Run the station-list queries with performSelect() and performTypedSelect()
+ * and compare the time taken, then run getAllStations() with various page
+ * sizes.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+
+	cass_log_set_level(CASS_LOG_INFO);
+	CassLogCallback logCallback =
+		[](const CassLogMessage *message, void*) -> void {
+			std::string logLevel =
+				message->severity == CASS_LOG_CRITICAL ? "Critical error" :
+				message->severity == CASS_LOG_ERROR    ? "Error" :
+				message->severity == CASS_LOG_WARN     ? "Warning" :
+				message->severity == CASS_LOG_INFO     ? "Notice" :
+									 "Debug";
+
+			std::cerr << "[" << logLevel << "] " << message->message << "(from " << message->function << ", in " << message->file << ", line " << message->line << std::endl;
+		};
+	cass_log_set_callback(logCallback, NULL);
+
+	SelectBench db(dataAddress, dataUser, dataPassword);
+
+	using CimelStations = std::vector<std::tuple<CassUuid, std::string, int>>;
+	using LiveobjectsStations = std::vector<std::tuple<CassUuid, std::string, std::string>>;
+	using AllStations = std::vector<CassUuid>;
+
+	bool ret = true;
+	// Warm up the connections
+	ret = bench<AllStations>("getAllStations", [&](AllStations& s) { return db.getAllStations(s); }) && ret;
+	ret = bench<CimelStations>("cimel, performSelect", [&](CimelStations& s) { return db.cimelWithFunction(s); }) && ret;
+	ret = bench<CimelStations>("cimel, performTypedSelect", [&](CimelStations& s) { return db.cimelTyped(s); }) && ret;
+	ret = bench<LiveobjectsStations>("liveobjects, performSelect", [&](LiveobjectsStations& s) { return db.liveobjectsWithFunction(s); }) && ret;
+	ret = bench<LiveobjectsStations>("liveobjects, performTypedSelect", [&](LiveobjectsStations& s) { return db.liveobjectsTyped(s); }) && ret;
+
+	// Small pages make the queries span several pages and exercise the
+	// prefetching of the next page
+	for (int pageSize : { 10, 100, 1000, 5000 }) {
+		db.setSelectPageSize(pageSize);
+		std::string name = "getAllStations, pages of " + std::to_string(pageSize) + " rows";
+		ret = bench<AllStations>(name.c_str(), [&](AllStations& s) { return db.getAllStations(s); }) && ret;
+	}
+
+	return ret ? 0 : 255;
+}
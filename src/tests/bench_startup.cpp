@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <array>
+#include <vector>
+
+#include "../src/dbconnection_common.h"
+#include "../src/dbconnection_observations.h"
+#include "../src/dbconnection_minmax.h"
+#include "../src/dbconnection_month_minmax.h"
+#include "../src/dbconnection_records.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+/**
+ * @brief The number of connections constructed for each class
+ */
+constexpr int NB_CONNECTIONS = 5;
+
+/**
+ * @brief The number of statements prepared by the PreparationBench
+ */
+constexpr std::size_t NB_STATEMENTS = 40;
+
+namespace {
+	/**
+	 * @brief A connection preparing the same number of statements as
+	 * DbConnectionObservations, either one after the other or all at once
+	 */
+	class PreparationBench : public DbConnectionCommon
+	{
+	public:
+		PreparationBench(const std::string& address, const std::string& user, const std::string& password, bool serial) :
+			DbConnectionCommon(address, user, password)
+		{
+			for (CassandraStmtPtr& stmt : _statements) {
+				prepareOneStatement(stmt, "select_station_name", "SELECT name FROM meteodata.stations WHERE id = ?");
+				if (serial)
+					waitForPreparedStatements();
+			}
+			waitForPreparedStatements();
+		}
+
+	private:
+		std::array<CassandraStmtPtr, NB_STATEMENTS> _statements;
+	};
+
+	template<typename Factory>
+	void measure(const char* what, Factory&& factory)
+	{
+		auto start = steady_clock::now();
+		for (int i = 0 ; i < NB_CONNECTIONS ; i++)
+			factory();
+		auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+		std::cout << what << ": " << elapsed.count() / NB_CONNECTIONS << "ms per connection" << std::endl;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Measure how long it takes to construct each kind of database connection,
+ * most of it being the preparation of the statements, and what's left with
+ * lazy preparation for a program running a single query.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	cass_log_set_level(CASS_LOG_INFO);
+	CassLogCallback logCallback =
+		[](const CassLogMessage *message, void*) -> void {
+			std::string logLevel =
+				message->severity == CASS_LOG_CRITICAL ? "Critical error" :
+				message->severity == CASS_LOG_ERROR    ? "Error" :
+				message->severity == CASS_LOG_WARN     ? "Warning" :
+				message->severity == CASS_LOG_INFO     ? "Notice" :
+									 "Debug";
+
+			std::cerr << "[" << logLevel << "] " << message->message << "(from " << message->function << ", in " << message->file << ", line " << message->line << std::endl;
+		};
+	cass_log_set_callback(logCallback, NULL);
+
+	measure("40 statements, one after the other", [&]() {
+		PreparationBench db(dataAddress, dataUser, dataPassword, true);
+	});
+	measure("40 statements, all at once", [&]() {
+		PreparationBench db(dataAddress, dataUser, dataPassword, false);
+	});
+
+	measure("DbConnectionObservations", [&]() {
+		DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	});
+	measure("DbConnectionObservations, lazy preparation", [&]() {
+		ConnectionOptions options;
+		options.preparation = StatementPreparation::LAZY;
+		DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword, options);
+		std::vector<CassUuid> stations;
+		db.getAllStations(stations);
+	});
+	measure("DbConnectionMinmax", [&]() {
+		DbConnectionMinmax db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	});
+	measure("DbConnectionMonthMinmax", [&]() {
+		DbConnectionMonthMinmax db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	});
+	measure("DbConnectionRecords", [&]() {
+		DbConnectionRecords db(dataAddress, dataUser, dataPassword);
+	});
+
+	// All the connections of a worker share the same Cassandra session
+	measure("The four classes together", [&]() {
+		DbConnectionObservations observations(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+		DbConnectionMinmax minmax(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+		DbConnectionMonthMinmax monthMinmax(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+		DbConnectionRecords records(dataAddress, dataUser, dataPassword);
+	});
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file check.h
+ * @brief Definition of the check() helper shared by the tests
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <iostream>
+
+namespace {
+	/**
+	 * @brief The number of failed checks, the tests return 255 if it is
+	 * not 0
+	 */
+	int failures = 0;
+
+	/**
+	 * @brief Count a failure and report it if \a ok is false
+	 *
+	 * @param what The name of the check
+	 * @param ok The result of the check
+	 */
+	inline void check(const char* what, bool ok)
+	{
+		if (!ok) {
+			std::cerr << what << ": failed" << std::endl;
+			failures++;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/daily_aggregator.h"
+#include "../src/in_memory_storage.h"
+#include "../src/observation.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	template<typename T>
+	void check(const char* what, const std::pair<bool, T>& value, const std::pair<bool, T>& expected)
+	{
+		check(what, value.first == expected.first && (!value.first || std::abs(value.second - expected.second) < 0.001));
+	}
+
+	/**
+	 * @brief Build an observation at \a time with values varying along
+	 * the day
+	 */
+	Observation makeObservation(const CassUuid& station, sys_seconds time)
+	{
+		Observation obs;
+		obs.setStation(station);
+		obs.setTimestamp(time);
+		auto minutes = floor<std::chrono::minutes>(time - floor<days>(time)).count();
+		obs.outsidetemp = { true, float(minutes % 1000) / 50.f - 5.f };
+		obs.outsidehum = { true, 40 + int(minutes % 53) };
+		obs.barometer = { true, 1000.f + float(minutes % 31) };
+		obs.windspeed = { true, float(minutes % 17) };
+		obs.rainfall = { true, minutes % 70 == 0 ? 0.4f : 0.f };
+		obs.et = { true, 0.01f };
+		return obs;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check that the daily aggregator computes the same values as the in-memory
+ * minmax storage from the same observations, in order or not, no database is
+ * required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	CassUuid station{0x1234, 0x5678};
+	sys_days day = 2024_y/3/1;
+
+	InMemoryObservationStorage observations;
+	InMemoryMinmaxStorage minmax{observations};
+	DailyAggregator aggregator;
+
+	for (sys_seconds t = day - 6h ; t < day + days{2} ; t += 10min) {
+		Observation obs = makeObservation(station, t);
+		observations.insertV2DataPoint(obs);
+		check("accumulate", aggregator.accumulate(obs));
+	}
+
+	for (sys_days d : { day, day + days{1} }) {
+		MinmaxStorage::Values expected, values;
+		minmax.getValues6hTo6h(station, d, expected);
+		minmax.getValues18hTo18h(station, d, expected);
+		minmax.getValues0hTo0h(station, d, expected);
+		check("getValues", aggregator.getValues(station, d, values));
+		check("outsideTemp_max", values.outsideTemp_max, expected.outsideTemp_max);
+		check("outsideTemp_min", values.outsideTemp_min, expected.outsideTemp_min);
+		check("rainfall", values.rainfall, expected.rainfall);
+		check("outsideHum_min", values.outsideHum_min, expected.outsideHum_min);
+		check("outsideHum_max", values.outsideHum_max, expected.outsideHum_max);
+		check("outsideHum_avg", values.outsideHum_avg, expected.outsideHum_avg);
+		check("barometer_avg", values.barometer_avg, expected.barometer_avg);
+		check("windspeed_max", values.windspeed_max, expected.windspeed_max);
+		check("et", values.et, expected.et);
+		check("insideTemp_max", values.insideTemp_max, expected.insideTemp_max);
+	}
+
+	MinmaxStorage::Values values;
+	check("getValues (not followed)", !aggregator.getValues(station, day - days{1}, values));
+	check("getValues (unknown station)", !aggregator.getValues(CassUuid{1, 2}, day, values));
+
+	// The monthly and yearly sums are chained from the day before
+	MinmaxStorage::Values dayBefore;
+	dayBefore.monthRain = { true, 10.f };
+	dayBefore.yearRain = { true, 100.f };
+	minmax.insertDataPoint(station, day, dayBefore);
+	check("flush", aggregator.flush(station, day + days{1}, minmax));
+	MinmaxStorage::Values expected;
+	minmax.getValues6hTo6h(station, day + days{1}, expected);
+	check("getStoredValues", minmax.getStoredValues(station, day + days{1}, values));
+	check("dayRain (flushed)", values.dayRain, expected.rainfall);
+	check("monthRain (flushed)", values.monthRain, std::make_pair(true, 10.f + expected.rainfall.second));
+	check("yearRain (flushed)", values.yearRain, std::make_pair(true, 100.f + expected.rainfall.second));
+
+	// The old days are dropped
+	aggregator.accumulate(makeObservation(station, day + days{10}));
+	check("getValues (dropped)", !aggregator.getValues(station, day, values));
+	check("getValues (no observation yet)", aggregator.getValues(station, day + days{11}, values) && !values.outsideTemp_max.first);
+
+	// Late observations are accumulated if their windows are kept
+	check("accumulate (late)", aggregator.accumulate(makeObservation(station, day + days{9})));
+	check("getValues (late)", aggregator.getValues(station, day + days{9}, values) && values.outsideTemp_max.first);
+	check("accumulate (too old)", !aggregator.accumulate(makeObservation(station, day + days{7})));
+	check("getValues (too old)", aggregator.getValues(station, day + days{9}, values));
+
+	// Observations accumulated twice make the aggregator forget the
+	// station
+	check("accumulate (twice)", !aggregator.accumulate(makeObservation(station, day + days{9})));
+	check("getValues (forgotten)", !aggregator.getValues(station, day + days{10}, values));
+
+	// The order of the observations does not matter once the station is
+	// followed
+	CassUuid shuffledStation{0x1234, 0x9abc};
+	std::vector<Observation> shuffled;
+	for (sys_seconds t = day - 6h + 10min ; t < day + days{2} ; t += 10min)
+		shuffled.push_back(makeObservation(shuffledStation, t));
+	std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{42});
+	DailyAggregator outOfOrder;
+	check("accumulate (first)", outOfOrder.accumulate(makeObservation(shuffledStation, day - 6h)));
+	for (const Observation& obs : shuffled)
+		check("accumulate (shuffled)", outOfOrder.accumulate(obs));
+	check("accumulate (before the follow-up)", !outOfOrder.accumulate(makeObservation(shuffledStation, day - 7h)));
+
+	for (sys_days d : { day, day + days{1} }) {
+		MinmaxStorage::Values expected;
+		minmax.getValues6hTo6h(station, d, expected);
+		minmax.getValues18hTo18h(station, d, expected);
+		minmax.getValues0hTo0h(station, d, expected);
+		check("getValues (shuffled)", outOfOrder.getValues(shuffledStation, d, values));
+		check("outsideTemp_max (shuffled)", values.outsideTemp_max, expected.outsideTemp_max);
+		check("outsideTemp_min (shuffled)", values.outsideTemp_min, expected.outsideTemp_min);
+		check("rainfall (shuffled)", values.rainfall, expected.rainfall);
+		check("outsideHum_avg (shuffled)", values.outsideHum_avg, expected.outsideHum_avg);
+		check("barometer_avg (shuffled)", values.barometer_avg, expected.barometer_avg);
+	}
+
+	return failures == 0 ? 0 : 255;
+}
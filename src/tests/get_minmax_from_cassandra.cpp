@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#include <date/date.h>
+#include "../src/dbconnection_minmax.h"
+#include "../src/dbconnection_observations.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	/**
+	 * @brief Build an observation whose temperature and gust are the
+	 * number of hours elapsed since \a start, so that the extrema of a
+	 * window give away its boundaries
+	 */
+	Observation makeObservation(const CassUuid& station, sys_seconds start, sys_seconds time)
+	{
+		float elapsed = float(duration_cast<minutes>(time - start).count()) / 60.f;
+		Observation obs;
+		obs.station = station;
+		obs.time = time;
+		obs.day = date::floor<days>(time);
+		obs.outsidetemp = {true, elapsed};
+		obs.windgust = {true, elapsed};
+		obs.rainfall = {true, 0.2f};
+		return obs;
+	}
+
+	void check(const char* what, const std::pair<bool, float>& value, float expected)
+	{
+		check(what, value.first && std::abs(value.second - expected) < 0.001f);
+	}
+
+	void check(const char* what, const std::pair<bool, float>& value, const std::pair<bool, float>& expected)
+	{
+		check(what, value.first == expected.first && (!value.first || std::abs(value.second - expected.second) < 0.001f));
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check that the windows aggregated client-side from a single scan of the
+ * Cassandra partitions have the same boundaries and the same values as the
+ * aggregation queries.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST") ?: "127.0.0.1"};
+	std::string dataUser{std::getenv("CASSANDRA_USER") ?: ""};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD") ?: ""};
+	std::string pqAddress{std::getenv("POSTGRES_HOST") ?: "127.0.0.1"};
+	std::string pqUser{std::getenv("POSTGRES_USER") ?: ""};
+	std::string pqPassword{std::getenv("POSTGRES_PASSWORD") ?: ""};
+
+	DbConnectionObservations observations(dataAddress, dataUser, dataPassword, pqAddress, pqUser, pqPassword);
+	DbConnectionMinmax db(dataAddress, dataUser, dataPassword, pqAddress, pqUser, pqPassword);
+	CassUuid uuid;
+	cass_uuid_from_string("00000000-0000-0000-0000-222222222222", &uuid);
+
+	// One observation every 30 minutes from 17h the day before to 7h the
+	// day after, on both sides of every window boundary
+	sys_days target = 2020_y/1/2;
+	sys_seconds start = target - 7h;
+	for (sys_seconds t = start ; t <= target + 31h ; t += 30min) {
+		if (!observations.insertV2DataPoint(makeObservation(uuid, start, t))) {
+			std::cerr << "Inserting the observations failed" << std::endl;
+			return 1;
+		}
+	}
+
+	DbConnectionMinmax::Values expected;
+	check("getValues6hTo6h", db.getValues6hTo6h(uuid, target, expected));
+	check("getValues18hTo18h", db.getValues18hTo18h(uuid, target, expected));
+	check("getValues0hTo0h", db.getValues0hTo0h(uuid, target, expected));
+
+	DbConnectionMinmax::Values values;
+	if (!db.getValuesFromCassandra(uuid, target, values)) {
+		std::cerr << "Getting the values from Cassandra failed" << std::endl;
+		return 1;
+	}
+
+	// (6h, 6h the day after]: 48 observations, the last one at 6h
+	check("Tx", values.outsideTemp_max, 37.f);
+	check("rainfall", values.rainfall, 48 * 0.2f);
+	// [18h the day before, 18h): the first observation at 18h
+	check("Tn", values.outsideTemp_min, 1.f);
+	// [0h, 0h the day after): the last observation at 23h30
+	check("gust", values.windgust_max, 30.5f);
+
+	check("Tx (same as the query)", values.outsideTemp_max, expected.outsideTemp_max);
+	check("Tn (same as the query)", values.outsideTemp_min, expected.outsideTemp_min);
+	check("rainfall (same as the query)", values.rainfall, expected.rainfall);
+	check("gust (same as the query)", values.windgust_max, expected.windgust_max);
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <date/date.h>
+#include "../src/dbconnection_observations.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	Observation makeObservation(const CassUuid& station, sys_seconds time, float rainfall)
+	{
+		Observation obs;
+		obs.station = station;
+		obs.time = time;
+		obs.day = date::floor<days>(time);
+		obs.rainfall = {true, rainfall};
+		return obs;
+	}
+
+	void checkRainfall(DbConnectionObservations& db, const char* what, const CassUuid& station, sys_seconds begin, sys_seconds end, float expected)
+	{
+		float rainfall;
+		check(what, db.getRainfall(station, system_clock::to_time_t(begin), system_clock::to_time_t(end), rainfall) &&
+			std::abs(rainfall - expected) < 0.001f);
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check that the rainfall of the observations on a day boundary is counted
+ * exactly once, both before and after the rollups are recomputed.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	CassUuid uuid;
+	cass_uuid_from_string("00000000-0000-0000-0000-111111111111", &uuid);
+
+	sys_days midnight = 2020_y/1/2;
+	check("insertion (before midnight)", db.insertV2DataPoint(makeObservation(uuid, midnight - 1h, 0.2f)));
+	check("insertion (at midnight)", db.insertV2DataPoint(makeObservation(uuid, midnight, 0.4f)));
+	check("insertion (after midnight)", db.insertV2DataPoint(makeObservation(uuid, midnight + 1h, 0.8f)));
+
+	for (const char* when : { "pending rollups", "rebuilt rollups" }) {
+		std::cout << "With " << when << std::endl;
+		checkRainfall(db, "up to midnight", uuid, midnight - 30min, midnight, 0.4f);
+		checkRainfall(db, "from midnight", uuid, midnight, midnight + 2h, 0.8f);
+		checkRainfall(db, "last hour of the day", uuid, midnight - 1h, midnight, 0.4f);
+		checkRainfall(db, "across midnight", uuid, midnight - 2h, midnight + 2h, 1.4f);
+		checkRainfall(db, "whole day before", uuid, midnight - days{1}, midnight, 0.6f);
+		checkRainfall(db, "two whole days", uuid, midnight - days{1}, midnight + days{1}, 1.4f);
+		check("rebuild", db.rebuildRainfallRollup(uuid,
+			system_clock::to_time_t(midnight - days{1}), system_clock::to_time_t(midnight + days{1})));
+	}
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/in_memory_storage.h"
+#include "../src/minmax_engine.h"
+#include "../src/observation.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	void check(const char* what, const std::pair<bool, float>& value, float expected)
+	{
+		check(what, value.first && std::abs(value.second - expected) < 0.001f);
+	}
+
+	void check(const char* what, const std::pair<bool, int>& value, int expected)
+	{
+		check(what, value.first && value.second == expected);
+	}
+
+	/**
+	 * @brief Build an observation at \a time, the outside temperature is
+	 * the hour of the day and there is 0.2mm of rain every time
+	 */
+	Observation makeObservation(const CassUuid& station, sys_seconds time)
+	{
+		Observation obs;
+		obs.setStation(station);
+		obs.setTimestamp(time);
+		auto hour = floor<hours>(time - floor<days>(time)).count();
+		obs.outsidetemp = { true, float(hour) };
+		obs.outsidehum = { true, 50 + int((time.time_since_epoch() / 10min) % 2) };
+		obs.rainfall = { true, 0.2f };
+		return obs;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Exercise the in-memory storage backends and measure how long it takes to
+ * store a year of observations of one station and compute its daily
+ * values, no database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	CassUuid station{0x1234, 0x5678};
+	sys_days day = 2024_y/3/15;
+
+	InMemoryObservationStorage observations;
+	for (sys_seconds t = day ; t < day + days{2} ; t += 10min)
+		observations.insertV2DataPoint(makeObservation(station, t));
+	Observation warmest = makeObservation(station, day + 14h + 5min);
+	warmest.max_outside_temperature = { true, 30.f };
+	observations.insertV2DataPoint(warmest);
+	check("size", observations.size() == 2 * 144 + 1);
+
+	Observation obs;
+	check("getLastDataBefore", observations.getLastDataBefore(station, system_clock::to_time_t(day + 12h + 5min), obs) && obs.time == day + 12h);
+	check("getLastDataBefore (other day)", !observations.getLastDataBefore(station, system_clock::to_time_t(day - 1s), obs));
+
+	float rainfall;
+	time_t from = system_clock::to_time_t(day + 1h);
+	time_t to = system_clock::to_time_t(day + 2h);
+	check("getRainfall", observations.getRainfall(station, from, to, rainfall) && std::abs(rainfall - 1.2f) < 0.001f);
+	check("getRainfall (two days)", observations.getRainfall(station, system_clock::to_time_t(day + 23h), system_clock::to_time_t(day + 25h), rainfall) && std::abs(rainfall - 2.4f) < 0.001f);
+
+	InMemoryMinmaxStorage minmax{observations};
+	MinmaxStorage::Values values;
+	check("getValues6hTo6h", minmax.getValues6hTo6h(station, day, values));
+	check("rainfall", values.rainfall, 144 * 0.2f + 0.2f);
+	check("outsideTemp_max", values.outsideTemp_max, 30.f);
+	check("getValues18hTo18h", minmax.getValues18hTo18h(station, day + days{1}, values));
+	check("outsideTemp_min", values.outsideTemp_min, 0.f);
+	check("getValues0hTo0h", minmax.getValues0hTo0h(station, day, values));
+	check("outsideHum_min", values.outsideHum_min, 50);
+	check("outsideHum_max", values.outsideHum_max, 51);
+	check("outsideHum_avg", values.outsideHum_avg, 50);
+
+	values.yearRain = { true, 123.f };
+	check("insertDataPoint", minmax.insertDataPoint(station, day, values));
+	std::pair<bool, float> yearRain, yearEt;
+	check("getYearlyValues", minmax.getYearlyValues(station, day, yearRain, yearEt));
+	check("yearRain", yearRain, 123.f);
+	check("yearEt", !yearEt.first);
+	check("getYearlyValues (missing day)", !minmax.getYearlyValues(station, day + days{1}, yearRain, yearEt));
+
+	MinmaxStorage::Values dayBefore;
+	dayBefore.monthRain = { true, 10.f };
+	dayBefore.yearRain = { true, 100.f };
+	minmax.insertDataPoint(station, day - days{1}, dayBefore);
+	std::vector<MinmaxStorage::Values> range;
+	check("getValuesForRange", minmax.getValuesForRange(station, day, day + days{1}, range) && range.size() == 2);
+	if (range.size() == 2) {
+		check("outsideTemp_max (range)", range[0].outsideTemp_max, 30.f);
+		check("dayRain (range)", range[0].dayRain, 145 * 0.2f);
+		check("monthRain (range)", range[0].monthRain, 10.f + 145 * 0.2f);
+		check("yearRain (range)", range[0].yearRain, 100.f + 145 * 0.2f);
+		check("dayRain (range, second day)", range[1].dayRain, 108 * 0.2f);
+		check("yearRain (range, second day)", range[1].yearRain, 100.f + 253 * 0.2f);
+		check("yearEt (range)", !range[1].yearEt.first);
+	}
+
+	check("deleteDataPoints", observations.deleteDataPoints(station, day, day + 1h, day + 2h));
+	check("getRainfall (deleted)", observations.getRainfall(station, from, to, rainfall) && rainfall == 0.f);
+
+	InMemoryJobStorage jobs;
+	jobs.publishMinmax(station, from, to);
+	jobs.publishMonthMinmax(station, from, to);
+	jobs.publishMinmax(station, from, to);
+	auto job = jobs.retrieveMinmax();
+	check("retrieveMinmax", job && job->id == 1 && job->job == JobStorage::JobType::MINMAX);
+	job = jobs.retrieveMinmax();
+	check("retrieveMinmax (second)", job && job->id == 3);
+	check("retrieveMinmax (empty)", !jobs.retrieveMinmax());
+	job = jobs.retrieveMonthMinmax();
+	check("retrieveMonthMinmax", job && job->id == 2 && job->begin == sys_seconds{seconds{from}});
+	check("markJobAsFinished", jobs.markJobAsFinished(2, to, 1));
+	check("getStatusCode", jobs.getStatusCode(2) == 1);
+	check("getStatusCode (unfinished)", !jobs.getStatusCode(1));
+
+	// A year of observations, every 10 minutes
+	observations.clear();
+	sys_days yearStart = 2023_y/1/1;
+	sys_days yearEnd = 2024_y/1/1;
+	auto start = steady_clock::now();
+	for (sys_seconds t = yearStart ; t < yearEnd ; t += 10min)
+		observations.insertV2DataPoint(makeObservation(station, t));
+	auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+	std::cout << observations.size() << " observations inserted in " << elapsed.count() << "ms" << std::endl;
+
+	start = steady_clock::now();
+	for (sys_days d = yearStart ; d < yearEnd ; d += days{1}) {
+		minmax.getValues6hTo6h(station, d, values);
+		minmax.getValues18hTo18h(station, d, values);
+		minmax.getValues0hTo0h(station, d, values);
+		minmax.insertDataPoint(station, d, values);
+	}
+	elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+	std::cout << "Daily values computed in " << elapsed.count() << "ms" << std::endl;
+
+	start = steady_clock::now();
+	minmax.getValuesForRange(station, yearStart, yearEnd - days{1}, range);
+	elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+	std::cout << "Daily values computed for the whole year in " << elapsed.count() << "ms" << std::endl;
+	check("getValuesForRange (year)", range.size() == 365);
+
+	// The same year for several stations, computed in parallel by batches
+	// of a month
+	std::vector<CassUuid> stations{ station };
+	for (cass_uint64_t i = 1 ; i < 8 ; i++) {
+		CassUuid other{0x1234 + i, 0x5678};
+		for (sys_seconds t = yearStart ; t < yearEnd ; t += 1h)
+			observations.insertV2DataPoint(makeObservation(other, t));
+		stations.push_back(other);
+	}
+	MinmaxEngine engine{minmax, 4, 31};
+	std::vector<CassUuid> failed;
+	start = steady_clock::now();
+	std::size_t stationDays = engine.run(stations, yearStart, yearEnd - days{1}, &failed);
+	elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+	std::cout << stationDays << " station-days computed by the engine in " << elapsed.count() << "ms" << std::endl;
+	check("run", stationDays == 8 * 365 && failed.empty());
+	// The observations before 6h on the first of January count for the
+	// previous year
+	check("yearRain (engine)", minmax.getStoredValues(stations[1], yearEnd - days{1}, values) && values.yearRain.first && std::abs(values.yearRain.second - (365 * 24 - 6) * 0.2f) < 0.1f);
+
+	return failures == 0 ? 0 : 255;
+}
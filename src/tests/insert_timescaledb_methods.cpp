@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <date/date.h>
+#include <pqxx/pqxx>
+#include "../src/dbconnection_observations.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	/**
+	 * @brief Build the observations inserted for a station: a complete
+	 * one, and a partial one at the same time, to be merged with it
+	 */
+	std::vector<Observation> makeObservations(const CassUuid& station, sys_seconds time)
+	{
+		std::vector<Observation> observations(2);
+		for (Observation& obs : observations) {
+			obs.station = station;
+			obs.time = time;
+			obs.day = date::floor<days>(time);
+		}
+
+		observations[0].barometer = {true, 1015.3f};
+		observations[0].outsidetemp = {true, 17.4f};
+		observations[0].outsidehum = {true, 83};
+		observations[0].rainfall = {true, 0.2f};
+		observations[0].voltage_battery = {true, 3.1f};
+		observations[0].voltage_solar_panel = {true, 5.2f};
+		observations[0].voltage_backup = {true, 1.3f};
+
+		observations[1].outsidetemp = {true, 17.6f};
+		observations[1].windspeed = {true, 12.f};
+		return observations;
+	}
+
+	/**
+	 * @brief Read the stored row of a station, as text, without the
+	 * station column
+	 */
+	std::vector<std::pair<bool, std::string>> readRow(pqxx::connection& connection, const CassUuid& station, sys_seconds time)
+	{
+		char uuid[CASS_UUID_STRING_LENGTH];
+		cass_uuid_string(station, uuid);
+
+		pqxx::work tx{connection};
+		pqxx::result result = tx.exec(
+			"SELECT * FROM meteodata.observations WHERE station = " + tx.quote(std::string{uuid}) +
+			" AND datetime = " + tx.quote(date::format("%F %T%z", time))
+		);
+
+		std::vector<std::pair<bool, std::string>> row;
+		if (result.size() != 1)
+			return row;
+		for (const auto& field : result[0]) {
+			if (std::string{field.name()} == "station")
+				continue;
+			row.emplace_back(!field.is_null(), field.is_null() ? "" : field.c_str());
+		}
+		return row;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check that the UPSERT and the COPY methods of
+ * insertV2DataPointsInTimescaleDB() store the same rows.
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main()
+{
+	std::string dataAddress{std::getenv("CASSANDRA_HOST")};
+	std::string dataUser{std::getenv("CASSANDRA_USER")};
+	std::string dataPassword{std::getenv("CASSANDRA_PASSWORD")};
+	std::string pgAddress{std::getenv("POSTGRES_HOST")};
+	std::string pgUser{std::getenv("POSTGRES_USER")};
+	std::string pgPassword{std::getenv("POSTGRES_PASSWORD")};
+
+	DbConnectionObservations db(dataAddress, dataUser, dataPassword, pgAddress, pgUser, pgPassword);
+	CassUuid upserted;
+	cass_uuid_from_string("00000000-0000-0000-0000-333333333333", &upserted);
+	CassUuid copied;
+	cass_uuid_from_string("00000000-0000-0000-0000-444444444444", &copied);
+
+	sys_seconds time = date::floor<seconds>(system_clock::now());
+	auto upsertedObservations = makeObservations(upserted, time);
+	auto copiedObservations = makeObservations(copied, time);
+	check("UPSERT", db.insertV2DataPointsInTimescaleDB(upsertedObservations.begin(), upsertedObservations.end(),
+		DbConnectionObservations::TimescaleDBInsertionMethod::UPSERT));
+	check("COPY", db.insertV2DataPointsInTimescaleDB(copiedObservations.begin(), copiedObservations.end(),
+		DbConnectionObservations::TimescaleDBInsertionMethod::COPY));
+
+	pqxx::connection connection{"host=" + pgAddress + " user=" + pgUser + " password=" + pgPassword + " dbname=meteodata"};
+	auto upsertedRow = readRow(connection, upserted, time);
+	auto copiedRow = readRow(connection, copied, time);
+	check("rows found", !upsertedRow.empty() && !copiedRow.empty());
+	check("same rows", upsertedRow == copiedRow);
+
+	return failures == 0 ? 0 : 255;
+}
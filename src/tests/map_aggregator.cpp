@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/map_aggregator.h"
+#include "../src/map_observation.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	void check(const char* what, const std::pair<bool, float>& value, float expected)
+	{
+		if (!value.first || std::abs(value.second - expected) > 0.001f) {
+			std::cerr << what << ": expected " << expected << ", got "
+				<< (value.first ? std::to_string(value.second) : "nothing") << std::endl;
+			failures++;
+		}
+	}
+
+	MapAggregator::Sample makeSample(sys_seconds time, float temperature, float rainfall, float windgust)
+	{
+		MapAggregator::Sample sample;
+		sample.time = time;
+		sample.outsideTemperature = { true, temperature };
+		sample.rainfall = { true, rainfall };
+		sample.windgust = { true, windgust };
+		return sample;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check the windows computed by the MapAggregator, no database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	MapAggregator aggregator;
+	CassUuid station{0x1234, 0x5678};
+	MapObservation map;
+
+	sys_seconds now = sys_days{2024_y/3/15} + 12h;
+
+	if (aggregator.accumulate(station, makeSample(now, 10.f, 1.f, 5.f), map)) {
+		std::cerr << "Accumulating without history should fail" << std::endl;
+		failures++;
+	}
+
+	// One observation every 10 minutes over the last two days, with
+	// 0.1mm of rain each time
+	std::vector<MapAggregator::Sample> history;
+	for (minutes m{10} ; m < 48h ; m += 10min)
+		history.push_back(makeSample(now - m, m < 2h ? 20.f : 15.f, 0.1f, m < 30min ? 12.f : 3.f));
+	aggregator.reset(station, history);
+
+	if (!aggregator.accumulate(station, makeSample(now, 10.f, 1.f, 5.f), map)) {
+		std::cerr << "Accumulating after a reset should succeed" << std::endl;
+		failures++;
+	}
+
+	// The 1h window spans the twelve 5-minute buckets up to 12h00: the
+	// observations at 11h10, 11h20, ..., 11h50 and the new one
+	check("rainfall1h", map.rainfall1h, 5 * 0.1f + 1.f);
+	check("rainfall3h", map.rainfall3h, 17 * 0.1f + 1.f);
+	check("rainfall48h", map.rainfall48h, 287 * 0.1f + 1.f);
+	check("max_outside_temperature1h", map.max_outside_temperature1h, 20.f);
+	check("min_outside_temperature1h", map.min_outside_temperature1h, 10.f);
+	check("min_outside_temperature6h", map.min_outside_temperature6h, 10.f);
+	check("max_outside_temperature24h", map.max_outside_temperature24h, 20.f);
+	check("windgust1h", map.windgust1h, 12.f);
+	check("windgust24h", map.windgust24h, 12.f);
+
+	// Two hours later, the first observations fall out of the 1h window
+	sys_seconds later = now + 2h;
+	if (!aggregator.accumulate(station, makeSample(later, 11.f, 0.f, 4.f), map)) {
+		std::cerr << "Accumulating a new observation should succeed" << std::endl;
+		failures++;
+	}
+	check("rainfall1h (2h later)", map.rainfall1h, 0.f);
+	check("rainfall3h (2h later)", map.rainfall3h, 5 * 0.1f + 1.f);
+	check("max_outside_temperature1h (2h later)", map.max_outside_temperature1h, 11.f);
+	check("windgust1h (2h later)", map.windgust1h, 4.f);
+
+	// Out-of-order observations make the aggregator forget the station
+	if (aggregator.accumulate(station, makeSample(now + 1h, 11.f, 0.f, 4.f), map)) {
+		std::cerr << "Accumulating an old observation should fail" << std::endl;
+		failures++;
+	}
+	if (aggregator.accumulate(station, makeSample(later + 5min, 11.f, 0.f, 4.f), map)) {
+		std::cerr << "The station should have been forgotten" << std::endl;
+		failures++;
+	}
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <date/date.h>
+#include "../src/observation.h"
+#include "../src/packed_observation.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	/**
+	 * @brief Compare two packed observations variable by variable
+	 */
+	bool same(const PackedObservation& a, const PackedObservation& b)
+	{
+		if (a.presence() != b.presence() || a.time != b.time || a.day != b.day)
+			return false;
+		for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+			auto field = PackedObservation::Field(f);
+			if (a.isPresent(field) && a.getFloat(field) != b.getFloat(field))
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Build an observation with random variables, some of them out
+	 * of the Filter bounds
+	 */
+	Observation randomObservation(std::mt19937& gen, sys_seconds time)
+	{
+		std::bernoulli_distribution present{0.7};
+		std::uniform_real_distribution<float> value{-100.f, 1500.f};
+
+		PackedObservation packed;
+		packed.station = CassUuid{0x1234, 0x5678};
+		packed.time = time;
+		packed.day = date::floor<days>(time);
+		for (int f = 0 ; f < PackedObservation::NB_FIELDS ; f++) {
+			auto field = PackedObservation::Field(f);
+			if (present(gen))
+				packed.set(field, value(gen));
+		}
+		return packed.unpack();
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check the conversions between Observation and PackedObservation and that
+ * both filter the same values, no database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	std::cout << "sizeof(Observation): " << sizeof(Observation)
+		<< ", sizeof(PackedObservation): " << sizeof(PackedObservation) << std::endl;
+
+	std::mt19937 gen{42};
+	sys_seconds time = sys_days{2024_y/3/15} + 12h;
+	for (int i = 0 ; i < 10000 ; i++) {
+		Observation obs = randomObservation(gen, time + minutes{i});
+		PackedObservation packed{obs};
+
+		if (!same(packed, PackedObservation{packed.unpack()})) {
+			std::cerr << "Observation " << i << " does not survive a round trip" << std::endl;
+			failures++;
+		}
+
+		obs.filterOutImpossibleValues();
+		packed.filterOutImpossibleValues();
+		if (!same(packed, PackedObservation{obs})) {
+			std::cerr << "Observation " << i << " is not filtered the same way" << std::endl;
+			failures++;
+		}
+	}
+
+	return failures == 0 ? 0 : 255;
+}
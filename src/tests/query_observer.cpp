@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/query_observer.h"
+#include "../src/statement_metrics.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+namespace {
+	/**
+	 * @brief An observer remembering all the notifications
+	 */
+	class RecordingObserver : public QueryObserver
+	{
+	public:
+		struct Event
+		{
+			const Query* query;
+			std::string statement;
+			bool hasStation;
+			bool end;
+			Outcome outcome;
+		};
+		std::vector<Event> events;
+
+		void onQueryStart(const Query& query) override
+		{
+			events.push_back({&query, std::string{query.statement}, query.station.first, false, {}});
+		}
+
+		void onQueryEnd(const Query& query, const Outcome& outcome) override
+		{
+			events.push_back({&query, std::string{query.statement}, query.station.first, true, outcome});
+		}
+	};
+
+	/**
+	 * @brief A stand-in for a row of a PostgreSQL result
+	 */
+	struct Field
+	{
+		std::size_t length;
+		std::size_t size() const { return length; }
+	};
+	using Row = std::vector<Field>;
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check the notifications of the QueryObserver by the QueryTrace, no database
+ * is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	CassUuid station{0x1234, 0x5678};
+
+	// Without observer, the executions are only recorded in the metrics
+	{
+		QueryTrace trace{StatementMetrics::Backend::POSTGRESQL, "select_values"};
+		check("A trace should not be observed without observer", !trace.observed());
+		trace.stop();
+	}
+
+	RecordingObserver observer;
+	QueryObserver::install(&observer);
+	check("The observer should be installed", QueryObserver::installed() == &observer);
+
+	{
+		QueryTrace trace{StatementMetrics::Backend::POSTGRESQL, "select_values", &station};
+		check("A trace should be observed with an observer", trace.observed());
+		trace.addResult(std::vector<Row>{ {{4}, {8}}, {{2}, {0}} });
+		trace.stop();
+		trace.stop();
+	}
+	check("The start and the end should be notified once", observer.events.size() == 2);
+	if (observer.events.size() == 2) {
+		const auto& start = observer.events[0];
+		const auto& end = observer.events[1];
+		check("The start should come first", !start.end && end.end);
+		check("The start and the end should share the query", start.query == end.query);
+		check("The statement should be named", end.statement == "select_values");
+		check("The station should be known", end.hasStation);
+		check("The execution should have succeeded", end.outcome.success);
+		check("The rows should be counted", end.outcome.rows == 2);
+		check("The bytes should be counted", end.outcome.bytes == 14);
+	}
+
+	// A trace destroyed without being stopped records an error
+	observer.events.clear();
+	try {
+		QueryTrace trace{StatementMetrics::Backend::MYSQL, "getNormals"};
+		throw std::runtime_error{"failure"};
+	} catch (const std::runtime_error&) {
+	}
+	check("The interrupted execution should be notified", observer.events.size() == 2 && !observer.events[1].outcome.success);
+	check("The station should be unknown", observer.events.size() == 2 && !observer.events[1].hasStation);
+
+	auto snapshots = StatementMetrics::snapshot();
+	for (const auto& s : snapshots) {
+		if (s.backend == StatementMetrics::Backend::POSTGRESQL && s.name == "select_values")
+			check("The executions should be recorded in the metrics", s.count == 2 && s.errors == 0);
+		if (s.backend == StatementMetrics::Backend::MYSQL && s.name == "getNormals")
+			check("The failure should be recorded in the metrics", s.count == 1 && s.errors == 1);
+	}
+
+	QueryObserver::install(nullptr);
+	observer.events.clear();
+	{
+		QueryTrace trace{StatementMetrics::Backend::CASSANDRA, "select_all_stations"};
+		trace.stop();
+	}
+	check("A removed observer should not be notified", observer.events.empty());
+
+	return failures == 0 ? 0 : 255;
+}
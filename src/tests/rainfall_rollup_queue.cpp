@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <date/date.h>
+#include "../src/rainfall_rollup_queue.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+using namespace date;
+
+namespace {
+	/**
+	 * @brief A fake database recording the recomputed runs of hours
+	 */
+	struct Database
+	{
+		std::mutex mutex;
+		std::vector<std::pair<sys_seconds, sys_seconds>> runs;
+		bool failing = false;
+
+		bool update(const CassUuid& station, const sys_seconds& begin, const sys_seconds& end)
+		{
+			std::lock_guard locked{mutex};
+			if (failing || station.clock_seq_and_node != 0x5678)
+				return false;
+			runs.emplace_back(begin, end);
+			return true;
+		}
+
+		std::size_t size()
+		{
+			std::lock_guard locked{mutex};
+			return runs.size();
+		}
+	};
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check the coalescing and the recomputation of the pending rainfall buckets,
+ * no database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	CassUuid station{0x1234, 0x5678};
+	sys_days day = 2024_y/3/1;
+	Database db;
+
+	{
+		RainfallRollupQueue queue{[&db](const auto& station, const auto& begin, const auto& end) {
+			return db.update(station, begin, end);
+		}, hours{1}};
+
+		// An observation at midnight is in the last bucket of the day
+		// before
+		queue.push(station, day - 1s, day);
+		queue.push(station, day + 10h + 4min, day + 10h + 5min);
+		queue.push(station, day + 11h, day + 11h + 30min);
+		auto pending = queue.pendingHours(station, day - days{1}, day + days{1});
+		check("pendingHours", pending == std::vector<sys_seconds>{ day - 1h, day + 10h, day + 11h });
+		check("pendingHours (other station)", queue.pendingHours(CassUuid{1, 2}, day, day + days{1}).empty());
+		check("pendingHours (other period)", queue.pendingHours(station, day + 12h, day + days{1}).empty());
+		check("nothing recomputed before the flush", db.size() == 0);
+
+		db.failing = true;
+		check("failed flush", !queue.flush());
+		check("pending after a failure", queue.pendingHours(station, day - days{1}, day + days{1}).size() == 3);
+
+		db.failing = false;
+		check("flush", queue.flush());
+		check("runs coalesced", db.size() == 2);
+		check("first run", db.runs[0] == std::make_pair(sys_seconds{day - 1h}, sys_seconds{day}));
+		check("second run", db.runs[1] == std::make_pair(sys_seconds{day + 10h}, sys_seconds{day + 12h}));
+		check("nothing pending", queue.pendingHours(station, day - days{1}, day + days{1}).empty());
+		check("flushing again", queue.flush() && db.size() == 2);
+
+		queue.setFlushInterval(milliseconds{50});
+		queue.push(station, day + 13h, day + 13h + 10min);
+		std::this_thread::sleep_for(milliseconds{300});
+		check("background flush", db.size() == 3);
+
+		queue.setFlushInterval(hours{1});
+		queue.push(station, day + 14h, day + 14h + 10min);
+		check("pending", db.size() == 3);
+	}
+	check("flushed on destruction", db.size() == 4 && db.runs.back().first == day + 14h);
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/statement_metrics.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+namespace {
+	const StatementMetrics::Snapshot* find(const std::vector<StatementMetrics::Snapshot>& snapshots, StatementMetrics::Backend backend, const std::string& name)
+	{
+		for (const auto& s : snapshots) {
+			if (s.backend == backend && s.name == name)
+				return &s;
+		}
+		return nullptr;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check the buckets, percentiles and exposition of the StatementMetrics, no
+ * database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	// Every latency must fall in a bucket whose upper bound is at most
+	// 12.5% above it
+	bool bucketsOk = true;
+	std::size_t previous = 0;
+	for (std::uint64_t micros = 0 ; micros < (std::uint64_t{1} << 30) ; micros = micros < 1000 ? micros + 1 : micros + micros / 7) {
+		std::size_t bucket = StatementMetrics::bucketOf(micros);
+		std::uint64_t upper = StatementMetrics::upperBoundOf(bucket);
+		if (bucket < previous || upper < micros || upper > micros + micros / 8 ||
+		    (bucket > 0 && StatementMetrics::upperBoundOf(bucket - 1) >= micros))
+			bucketsOk = false;
+		previous = bucket;
+	}
+	check("The buckets should be ordered and precise to 12.5%", bucketsOk);
+	check("Huge latencies should go in the last bucket",
+		StatementMetrics::bucketOf(~std::uint64_t{0}) == StatementMetrics::NB_BUCKETS - 1);
+
+	StatementMetrics::Series& series = StatementMetrics::series(StatementMetrics::Backend::CASSANDRA, "select_test");
+	check("The series should be unique per statement",
+		&series == &StatementMetrics::series(StatementMetrics::Backend::CASSANDRA, "select_test"));
+	check("The series should be distinct per backend",
+		&series != &StatementMetrics::series(StatementMetrics::Backend::POSTGRESQL, "select_test"));
+
+	// 1ms to 100ms, with one error in ten
+	for (int i = 1 ; i <= 100 ; i++)
+		series.record(milliseconds{i}, i % 10 != 0);
+
+	auto snapshots = StatementMetrics::snapshot();
+	const StatementMetrics::Snapshot* s = find(snapshots, StatementMetrics::Backend::CASSANDRA, "select_test");
+	check("The series should be in the snapshot", s != nullptr);
+	if (s) {
+		check("The executions should be counted", s->count == 100);
+		check("The errors should be counted", s->errors == 10);
+		check("The latencies should be summed", s->sum == 5050000);
+		auto p50 = s->percentile(0.5);
+		auto p99 = s->percentile(0.99);
+		check("The median should be about 50ms", p50 >= milliseconds{50} && p50 <= milliseconds{57});
+		check("The 99th percentile should be about 99ms", p99 >= milliseconds{99} && p99 <= milliseconds{112});
+		check("The maximum should be about 100ms", s->percentile(1.) >= milliseconds{100});
+	}
+
+	// A timer destroyed without being stopped records an error
+	try {
+		StatementMetrics::Timer timer{StatementMetrics::Backend::MYSQL, "getNormals"};
+		throw std::runtime_error{"failure"};
+	} catch (const std::runtime_error&) {
+	}
+	{
+		StatementMetrics::Timer timer{StatementMetrics::Backend::MYSQL, "getNormals"};
+		timer.stop();
+		timer.stop();
+	}
+	snapshots = StatementMetrics::snapshot();
+	s = find(snapshots, StatementMetrics::Backend::MYSQL, "getNormals");
+	check("The timers should record one execution each", s && s->count == 2);
+	check("The interrupted timer should record an error", s && s->errors == 1);
+
+	// Concurrent recordings are not lost
+	StatementMetrics::Series& concurrent = StatementMetrics::series(StatementMetrics::Backend::POSTGRESQL, "upsert_test");
+	std::vector<std::thread> threads;
+	for (int t = 0 ; t < 4 ; t++) {
+		threads.emplace_back([&concurrent]() {
+			for (int i = 0 ; i < 10000 ; i++)
+				concurrent.record(microseconds{i}, true);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	check("The concurrent executions should all be counted", concurrent.snapshot().count == 40000);
+
+	std::ostringstream os;
+	StatementMetrics::dump(os);
+	std::string text = os.str();
+	check("The dump should contain the quantiles",
+		text.find("cassobs_statement_latency_seconds{backend=\"cassandra\",statement=\"select_test\",quantile=\"0.5\"}") != std::string::npos);
+	check("The dump should contain the counts",
+		text.find("cassobs_statement_latency_seconds_count{backend=\"cassandra\",statement=\"select_test\"} 100\n") != std::string::npos);
+	check("The dump should contain the errors",
+		text.find("cassobs_statement_errors_total{backend=\"mysql\",statement=\"getNormals\"} 1\n") != std::string::npos);
+
+	StatementMetrics::reset();
+	check("The reset should clear the series", series.snapshot().count == 0 && series.snapshot().errors == 0);
+
+	return failures == 0 ? 0 : 255;
+}
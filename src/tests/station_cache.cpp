@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "../src/station_cache.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+/**
+ * @brief Entry point
+ *
+ * Check the lookups, expiry and invalidation of the StationCache, no
+ * database is required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	StationCache cache;
+	CassUuid station{0x1234, 0x5678};
+	CassUuid other{0x1234, 0x9abc};
+
+	StationCache::Details details;
+	check("An empty cache should miss", !cache.getDetails(station, details));
+
+	cache.putDetails(station, {"Rennes", 300, 1000, true});
+	cache.putLocation(station, {48.1f, -1.7f, 30});
+	cache.putStationByCoords(30, 4810, -170, station);
+	cache.putDetails(other, {"Brest", 600, 2000, false});
+
+	check("The details should be found", cache.getDetails(station, details));
+	check("The details should be those stored", details.name == "Rennes" && details.pollPeriod == 300 &&
+		details.lastArchiveDownloadTime == 1000 && details.storeInsideMeasurements);
+
+	StationCache::Location location;
+	check("The location should be found", cache.getLocation(station, location) && location.elevation == 30);
+	StationCache::Coordinates coordinates;
+	check("The coordinates have never been stored", !cache.getCoordinates(station, coordinates));
+
+	CassUuid found;
+	check("The station should be found by its coordinates", cache.getStationByCoords(30, 4810, -170, found) &&
+		found.clock_seq_and_node == station.clock_seq_and_node);
+	check("Other coordinates should miss", !cache.getStationByCoords(30, 4810, -171, found));
+
+	cache.updateLastArchiveDownloadTime(station, 1500);
+	check("The last archive download time should be updated",
+		cache.getDetails(station, details) && details.lastArchiveDownloadTime == 1500);
+
+	cache.invalidate(station);
+	check("The details should be invalidated", !cache.getDetails(station, details));
+	check("The location should be invalidated", !cache.getLocation(station, location));
+	check("The coordinates index should be invalidated", !cache.getStationByCoords(30, 4810, -170, found));
+	check("The other stations should be kept", cache.getDetails(other, details) && details.name == "Brest");
+
+	StationCache::Statistics statistics = cache.statistics();
+	check("Hits should be counted", statistics.hits == 5);
+	check("Misses should be counted", statistics.misses == 6);
+
+	cache.setTtl(seconds::zero());
+	cache.putDetails(station, {"Rennes", 300, 1000, true});
+	check("Nothing should be cached without a time to live", !cache.getDetails(station, details));
+
+	cache.setTtl(seconds{1});
+	cache.putDetails(station, {"Rennes", 300, 1000, true});
+	check("The details should be found before they expire", cache.getDetails(station, details));
+	std::this_thread::sleep_for(milliseconds{1100});
+	check("The details should expire", !cache.getDetails(station, details));
+
+	cache.clear();
+	check("The cache should be cleared", !cache.getDetails(other, details));
+
+	return failures == 0 ? 0 : 255;
+}
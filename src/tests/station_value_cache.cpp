@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../src/station_value_cache.h"
+#include "check.h"
+
+using namespace std::chrono;
+using namespace meteodata;
+
+namespace {
+	/**
+	 * @brief A fake database recording the writes
+	 */
+	struct Database
+	{
+		std::mutex mutex;
+		std::vector<StationValueCache::Write> writes;
+		bool failing = false;
+
+		bool write(const std::vector<StationValueCache::Write>& w)
+		{
+			std::lock_guard locked{mutex};
+			if (failing)
+				return false;
+			writes.insert(writes.end(), w.begin(), w.end());
+			return true;
+		}
+
+		std::size_t size()
+		{
+			std::lock_guard locked{mutex};
+			return writes.size();
+		}
+	};
+
+	StationValueCache::Write makeIntWrite(const CassUuid& station, const std::string& key, time_t time, int value)
+	{
+		StationValueCache::Write write{station, key, {time}};
+		write.value.intValue = { true, value };
+		return write;
+	}
+}
+
+/**
+ * @brief Entry point
+ *
+ * Check the coalescing and flushing of the StationValueCache, no database is
+ * required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	CassUuid station{0x1234, 0x5678};
+	Database db;
+
+	{
+		StationValueCache cache{[&db](const auto& writes) { return db.write(writes); },
+			StationValueCache::Mode::WRITE_BEHIND, hours{1}};
+
+		std::optional<StationValueCache::Value> value;
+		check("An unknown pair should not be found", !cache.lookup(station, "a", value));
+
+		StationValueCache::Value stored{1000};
+		stored.floatValue = { true, 2.5f };
+		cache.load(station, "a", stored);
+		cache.load(station, "b", std::nullopt);
+		check("A loaded pair should be found", cache.lookup(station, "a", value) && value && value->floatValue.second == 2.5f);
+		check("A pair loaded as absent should be known", cache.lookup(station, "b", value) && !value);
+
+		check("An update should succeed", cache.update(makeIntWrite(station, "a", 1100, 1)));
+		check("A newer update should succeed", cache.update(makeIntWrite(station, "a", 1200, 2)));
+		check("An older update should be rejected", !cache.update(makeIntWrite(station, "a", 1150, 3)));
+		check("An update of an absent pair should succeed", cache.update(makeIntWrite(station, "b", 1000, 4)));
+		check("Nothing should be written before the flush", db.size() == 0);
+
+		check("The updates should be read back", cache.lookup(station, "a", value) && value &&
+			value->time == 1200 && value->intValue.second == 2 && value->floatValue.first);
+
+		db.failing = true;
+		check("A failed flush should be reported", !cache.flush());
+		db.failing = false;
+		check("The flush should succeed", cache.flush());
+		check("The updates should be coalesced", db.size() == 2);
+		for (const auto& write : db.writes) {
+			if (write.key == "a")
+				check("Only the updated values should be written", write.value.intValue.second == 2 && !write.value.floatValue.first);
+		}
+		check("Flushing again should write nothing", cache.flush() && db.size() == 2);
+
+		cache.setFlushInterval(milliseconds{50});
+		cache.update(makeIntWrite(station, "a", 1300, 5));
+		std::this_thread::sleep_for(milliseconds{300});
+		check("The updates should be flushed in the background", db.size() == 3);
+
+		cache.setMode(StationValueCache::Mode::WRITE_THROUGH);
+		cache.setFlushInterval(hours{1});
+		cache.update(makeIntWrite(station, "a", 1400, 6));
+		check("The update should be written through", db.size() == 4);
+
+		cache.setMode(StationValueCache::Mode::WRITE_BEHIND);
+		cache.update(makeIntWrite(station, "a", 1500, 7));
+		check("The update should be pending", db.size() == 4);
+	}
+	check("The pending updates should be written on destruction", db.size() == 5 && db.writes.back().value.intValue.second == 7);
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "../src/wind_histogram.h"
+#include "check.h"
+
+using namespace meteodata;
+
+/**
+ * @brief Entry point
+ *
+ * Check the binning and the merging of wind histograms, no database is
+ * required.
+ *
+ * @return 0 if everything went well, 255 otherwise
+ */
+int main()
+{
+	check("sectorOf (North)", WindHistogram::sectorOf(0) == 0);
+	check("sectorOf (North, west side)", WindHistogram::sectorOf(349) == 0);
+	check("sectorOf (North, 360)", WindHistogram::sectorOf(360) == 0);
+	check("sectorOf (NNE)", WindHistogram::sectorOf(12) == 1);
+	check("sectorOf (East)", WindHistogram::sectorOf(90) == 4);
+	check("sectorOf (NNW)", WindHistogram::sectorOf(348) == 15);
+	check("sectorOf (negative)", WindHistogram::sectorOf(-20) == 15);
+	check("sectorOf (negative, North)", WindHistogram::sectorOf(-360) == 0);
+	check("sectorOf (over 360)", WindHistogram::sectorOf(450) == 4);
+	check("speedClassOf (light)", WindHistogram::speedClassOf(3.f) == 0);
+	check("speedClassOf (bound)", WindHistogram::speedClassOf(10.f) == 1);
+	check("speedClassOf (storm)", WindHistogram::speedClassOf(120.f) == WindHistogram::SPEED_CLASSES - 1);
+
+	WindHistogram day1;
+	check("empty", day1.empty());
+	std::vector<std::pair<int, float>> samples{
+		{ 0, 5.f }, { 90, 25.f }, { 92, 25.f }, { 180, 0.f }, { 270, 60.f }
+	};
+	day1.accumulate(samples.begin(), samples.end());
+	check("total", day1.total() == 5);
+	check("calm", day1.calm() == 1);
+	check("count", day1.count(4, 2) == 2);
+	check("sectorCount", day1.sectorCount(12) == 1);
+	check("toString", day1.toString() == "{1,0,0,0,2,0,0,0,0,0,0,0,1,0,0,0}");
+
+	WindHistogram day2;
+	day2.add(90, 12.f);
+	day2.add(0, 0.f);
+	WindHistogram month;
+	month += day1;
+	month += day2;
+	check("total (merged)", month.total() == 7);
+	check("calm (merged)", month.calm() == 2);
+	check("sectorCount (merged)", month.sectorCount(4) == 3);
+	auto sectors = month.sectors();
+	check("sectors", sectors[0] == 1 && sectors[4] == 3 && sectors[12] == 1);
+
+	return failures == 0 ? 0 : 255;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file wind_histogram.cpp
+ * @brief Implementation of the WindHistogram class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <string>
+
+#include "wind_histogram.h"
+
+namespace meteodata {
+
+constexpr int WindHistogram::SECTORS;
+constexpr int WindHistogram::SPEED_CLASSES;
+constexpr std::array<float, WindHistogram::SPEED_CLASSES - 1> WindHistogram::SPEED_CLASS_BOUNDS;
+
+WindHistogram& WindHistogram::operator+=(const WindHistogram& other)
+{
+	for (int s = 0 ; s < SECTORS ; s++)
+		for (int c = 0 ; c < SPEED_CLASSES ; c++)
+			_counts[s][c] += other._counts[s][c];
+	_calm += other._calm;
+	return *this;
+}
+
+int WindHistogram::sectorCount(int sector) const
+{
+	int n = 0;
+	for (int c : _counts[sector])
+		n += c;
+	return n;
+}
+
+int WindHistogram::total() const
+{
+	int n = _calm;
+	for (int s = 0 ; s < SECTORS ; s++)
+		n += sectorCount(s);
+	return n;
+}
+
+std::array<int, WindHistogram::SECTORS> WindHistogram::sectors() const
+{
+	std::array<int, SECTORS> result;
+	for (int s = 0 ; s < SECTORS ; s++)
+		result[s] = sectorCount(s);
+	return result;
+}
+
+std::string WindHistogram::toString() const
+{
+	std::string result = "{";
+	for (int s = 0 ; s < SECTORS ; s++) {
+		if (s > 0)
+			result += ",";
+		result += std::to_string(sectorCount(s));
+	}
+	result += "}";
+	return result;
+}
+
+}
@@ -0,0 +1,185 @@
+/**
+ * @file wind_histogram.h
+ * @brief Definition of the WindHistogram class
+ * @author Laurent Georget
+ * @date 2026-10-16
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WIND_HISTOGRAM_H
+#define WIND_HISTOGRAM_H
+
+#include <array>
+#include <string>
+
+namespace meteodata {
+
+/**
+ * @brief The distribution of the wind observations of a period by direction
+ * and speed, the data behind a wind rose
+ *
+ * The histogram has a fixed size and needs no allocation, it can be merged
+ * with another one in constant time, for instance to build the histogram of
+ * a month from the ones of its days.
+ *
+ * The directions are split into 16 sectors of 22.5°, clockwise from the
+ * North, the first sector being centered on the North. The observations
+ * without wind are counted apart since they have no direction.
+ *
+ * The winddir column of the minmax tables only stores the number of
+ * observations in each sector, see sectors(), the histogram itself is not
+ * stored.
+ */
+class WindHistogram
+{
+public:
+	/**
+	 * @brief The number of direction sectors
+	 */
+	constexpr static int SECTORS = 16;
+
+	/**
+	 * @brief The number of speed classes
+	 */
+	constexpr static int SPEED_CLASSES = 5;
+
+	/**
+	 * @brief The lower bounds of all the speed classes but the first,
+	 * in km/h
+	 */
+	constexpr static std::array<float, SPEED_CLASSES - 1> SPEED_CLASS_BOUNDS = { 10.f, 20.f, 30.f, 50.f };
+
+	/**
+	 * @brief Get the sector of a direction
+	 *
+	 * @param direction A direction in degrees, taken modulo 360
+	 *
+	 * @return The sector, between 0 and SECTORS - 1
+	 */
+	static int sectorOf(int direction)
+	{
+		direction %= 360;
+		if (direction < 0)
+			direction += 360;
+		return ((direction * 2 * SECTORS + 360) / 720) % SECTORS;
+	}
+
+	/**
+	 * @brief Get the speed class of a positive speed
+	 *
+	 * @param speed A speed in km/h
+	 *
+	 * @return The speed class, between 0 and SPEED_CLASSES - 1
+	 */
+	static int speedClassOf(float speed)
+	{
+		int c = 0;
+		for (float bound : SPEED_CLASS_BOUNDS)
+			c += speed >= bound;
+		return c;
+	}
+
+	/**
+	 * @brief Count one wind observation
+	 *
+	 * @param direction The direction in degrees, taken modulo 360
+	 * @param speed The speed in km/h, the observation is calm if it is
+	 * not positive
+	 */
+	void add(int direction, float speed)
+	{
+		if (speed > 0)
+			_counts[sectorOf(direction)][speedClassOf(speed)]++;
+		else
+			_calm++;
+	}
+
+	/**
+	 * @brief Count a range of wind observations
+	 *
+	 * @param begin An iterator to the first observation, a pair
+	 * (direction, speed)
+	 * @param end An iterator past the last observation
+	 */
+	template<typename I>
+	void accumulate(I begin, I end)
+	{
+		for (I it = begin ; it != end ; ++it)
+			add(it->first, it->second);
+	}
+
+	/**
+	 * @brief Add the counts of another histogram to this one
+	 */
+	WindHistogram& operator+=(const WindHistogram& other);
+
+	/**
+	 * @brief Get the number of observations in a sector and a speed class
+	 */
+	int count(int sector, int speedClass) const
+	{
+		return _counts[sector][speedClass];
+	}
+
+	/**
+	 * @brief Get the number of observations in a sector, all speed
+	 * classes included
+	 */
+	int sectorCount(int sector) const;
+
+	/**
+	 * @brief Get the number of observations without wind
+	 */
+	int calm() const
+	{
+		return _calm;
+	}
+
+	/**
+	 * @brief Get the number of observations, calm ones included
+	 */
+	int total() const;
+
+	/**
+	 * @brief Tell whether no observation has been counted
+	 */
+	bool empty() const
+	{
+		return total() == 0;
+	}
+
+	/**
+	 * @brief Get the number of observations in each sector, in the format
+	 * of the winddir column of the minmax tables
+	 */
+	std::array<int, SECTORS> sectors() const;
+
+	/**
+	 * @brief Get the number of observations in each sector as a
+	 * PostgreSQL array literal
+	 */
+	std::string toString() const;
+
+private:
+	std::array<std::array<int, SPEED_CLASSES>, SECTORS> _counts{};
+	int _calm = 0;
+};
+
+}
+
+#endif